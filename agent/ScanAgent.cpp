@@ -0,0 +1,43 @@
+// REKit scan agent: loaded into a target, it serves in-place scans and reads
+// to REKit over shared memory (see include/REKit/memsearch/ScanAgent.h).
+//
+// Linux:
+//   g++ -O2 -std=c++17 -shared -fPIC -I. agent/ScanAgent.cpp src/memsearch/{ScanAgent,ScanPlan,RegionWalker,ScanKernels,GroupScan,SigProgram,ModuleImage,RegionMap,ProcessMemory,ProcessAccess,ScanStats}.cpp -o librekit_agent.so -lpthread -lrt
+//   LD_PRELOAD=./librekit_agent.so ./target
+//
+// Windows: build the same sources as a DLL and load it into the target with
+// the Injector plugin.
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+#include "include/REKit/memsearch/ScanAgent.h"
+
+using namespace REKit::MemSearch;
+
+#ifdef _WIN32
+
+static DWORD WINAPI AgentThread(LPVOID) {
+    StartScanAgent();
+    return 0;
+}
+
+BOOL WINAPI DllMain(HINSTANCE inst, DWORD reason, LPVOID) {
+    if (reason == DLL_PROCESS_ATTACH) {
+        DisableThreadLibraryCalls(inst);
+        // The serving thread runs our code for the life of the process, so the DLL stays pinned.
+        HMODULE self = nullptr;
+        GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_PIN, (LPCWSTR)&AgentThread, &self);
+        // threads cannot be started and waited for under the loader lock
+        HANDLE t = CreateThread(nullptr, 0, AgentThread, nullptr, 0, nullptr);
+        if (t) CloseHandle(t);
+    }
+    return TRUE;
+}
+
+#else
+
+__attribute__((constructor)) static void AgentLoad() { StartScanAgent(); }
+__attribute__((destructor)) static void AgentUnload() { StopScanAgent(); }
+
+#endif
@@ -70,6 +70,7 @@ int WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
     modules.Register(REKit::Plugins::CreateModuleEnum());
     modules.Register(REKit::Plugins::CreateMemSearch());
     modules.Register(REKit::Plugins::CreateInjector());
+    modules.Register(REKit::Plugins::CreateMemBrowser());
     modules.LoadAll(mctx);
     // === End plugin setup ===
 
@@ -0,0 +1,253 @@
+// Microbenchmarks for the MemSearch scan kernels over synthetic in-memory buffers.
+// Headless, no DirectX / Windows dependency:
+//
+//   g++ -O2 -std=c++17 -I. bench/MemSearchBench.cpp src/memsearch/ScanKernels.cpp -o memsearch_bench
+//   ./memsearch_bench --size-mb 2048 --iters 3 --json bench.json
+//
+// Every case walks the buffer in 64KB chunks with the same overlap the engine
+// uses, so numbers are comparable with StartFirstScan minus the read syscalls.
+#include <vector>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+
+#include "include/REKit/memsearch/ScanKernels.h"
+#include "include/REKit/memsearch/Signature.h"
+
+using namespace REKit::MemSearch;
+
+namespace {
+
+struct Case {
+    const char* name;
+    ScanOptions opt;
+    size_t      plantEvery;   // 0 = low hit rate (random data only)
+    std::vector<uint8_t> plant;
+};
+
+struct Result {
+    std::string name;
+    double seconds = 0;
+    uint64_t bytes = 0;
+    uint64_t hits = 0;
+};
+
+uint64_t g_rng = 0x9E3779B97F4A7C15ull;
+uint64_t Next() {
+    g_rng ^= g_rng << 13; g_rng ^= g_rng >> 7; g_rng ^= g_rng << 17;
+    return g_rng;
+}
+
+void FillRandom(std::vector<uint8_t>& buf) {
+    size_t i = 0;
+    for (; i + 8 <= buf.size(); i += 8) { uint64_t v = Next(); memcpy(&buf[i], &v, 8); }
+    for (; i < buf.size(); ++i) buf[i] = (uint8_t)Next();
+}
+
+// Write c.plant every c.plantEvery bytes starting at slot. Slots are packed
+// 8-byte aligned below the smallest period so cases never overwrite each other.
+void Plant(std::vector<uint8_t>& buf, const Case& c, size_t slot) {
+    for (size_t off = slot; off + c.plant.size() <= buf.size(); off += c.plantEvery)
+        memcpy(&buf[off], c.plant.data(), c.plant.size());
+}
+
+template <class T> std::vector<uint8_t> Bytes(T v) {
+    std::vector<uint8_t> b(sizeof(T)); memcpy(b.data(), &v, sizeof(T)); return b;
+}
+
+size_t MatchSize(const Case& c, const std::vector<uint8_t>& pat) {
+    switch (c.opt.type) {
+    case ScanType::Bytes:  return pat.size();
+    default:               return ValueMatchSize(c.opt.type, c.opt);
+    }
+}
+
+Result Run(const Case& c, const std::vector<uint8_t>& buf, int iters) {
+    Result r; r.name = c.name;
+    std::vector<uint8_t> pat, mask;
+    if (c.opt.type == ScanType::Bytes) ParseHexWithMask(c.opt.hexExpr, pat, mask);
+    const size_t chunk = 1 << 16;
+    const size_t overlap = MatchSize(c, pat) ? MatchSize(c, pat) - 1 : 0;
+    std::vector<uintptr_t> out;
+    out.reserve(1 << 20);
+    for (int it = 0; it < iters; ++it) {
+        out.clear();
+        auto t0 = std::chrono::steady_clock::now();
+        for (size_t off = 0; off < buf.size(); off += chunk) {
+            size_t n = std::min(buf.size() - off, chunk + overlap);
+            size_t owned = std::min(buf.size() - off, chunk);
+            if (c.opt.type == ScanType::Bytes)
+                SearchBufferMasked(buf.data() + off, n, owned, pat.data(), mask.data(), pat.size(), c.opt.alignment, off, out);
+            else
+                SearchBufferValue(buf.data() + off, n, owned, c.opt.type, c.opt, off, out);
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        r.seconds += std::chrono::duration<double>(t1 - t0).count();
+        r.bytes += buf.size();
+        r.hits += out.size();
+    }
+    return r;
+}
+
+// Compile-time signature kernel over the same chunking; compare with the bytes/ case of the same pattern.
+template <size_t N, size_t A>
+Result RunSig(const char* name, const Signature<N, A>& sig, const std::vector<uint8_t>& buf, int iters) {
+    Result r; r.name = name;
+    const size_t chunk = 1 << 16;
+    std::vector<uintptr_t> out;
+    out.reserve(1 << 20);
+    for (int it = 0; it < iters; ++it) {
+        out.clear();
+        auto t0 = std::chrono::steady_clock::now();
+        for (size_t off = 0; off < buf.size(); off += chunk) {
+            size_t n = std::min(buf.size() - off, chunk + N - 1);
+            SearchSignature(sig, buf.data() + off, n, off, out);
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        r.seconds += std::chrono::duration<double>(t1 - t0).count();
+        r.bytes += buf.size();
+        r.hits += out.size();
+    }
+    return r;
+}
+
+Result RunParse(int iters) {
+    const char* sigs[] = {
+        "48 8B 05 ?? ?? ?? ?? 48 85 C0 74 ?? 48 8B 40 08",
+        "E8 ?? ?? ?? ?? 8B D8 85 DB 0F 84 ?? ?? ?? ?? 48 8D 4C 24 ?? E8",
+        "4?5?C3", "FF 25 ?? ?? ?? ??",
+    };
+    Result r; r.name = "ParseHexWithMask";
+    std::vector<uint8_t> pat, mask;
+    const int n = 200000 * iters;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; ++i) {
+        const char* s = sigs[i & 3];
+        if (ParseHexWithMask(s, pat, mask)) r.hits++;
+        r.bytes += strlen(s);
+    }
+    r.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return r;
+}
+
+std::vector<Case> MakeCases() {
+    std::vector<Case> cs;
+    auto add = [&](const char* name, ScanType t, size_t align, size_t every) -> Case& {
+        Case c; c.name = name; c.opt.type = t; c.opt.alignment = align; c.plantEvery = every;
+        cs.push_back(c);
+        return cs.back();
+    };
+    Case* c;
+    c = &add("bytes/dense-wildcards/low", ScanType::Bytes, 1, 0);
+    c->opt.hexExpr = "4C ?? ?? ?? ?? ?? ?? 8B ?? ?? E9";
+    c = &add("bytes/dense-wildcards/high", ScanType::Bytes, 1, 256);
+    c->opt.hexExpr = "48 ?? ?? ?? ?? 89 ?? ??";
+    c->plant = { 0x48, 1, 2, 3, 4, 0x89, 5, 6 };
+    c = &add("bytes/nibble-wildcards/low", ScanType::Bytes, 1, 0);
+    c->opt.hexExpr = "4? 8B ?5 ?? ?? ?? ?? 48 8?";
+    c = &add("bytes/long-literal/low", ScanType::Bytes, 1, 0);
+    c->opt.hexExpr = "48 89 5C 24 08 48 89 74 24 10 57 48 83 EC 20 48 8B F9 33 DB 8B F2 48 85 C9 74 1F";
+    c = &add("bytes/long-literal/high", ScanType::Bytes, 1, 4096);
+    c->opt.hexExpr = "40 53 48 83 EC 20 48 8B D9 48 8B 0D 11 22 33 44 48 85 C9 74 05";
+    { std::vector<uint8_t> mask; ParseHexWithMask(c->opt.hexExpr, c->plant, mask); }
+    c = &add("int32/aligned/low", ScanType::Int32, 4, 0);
+    c->opt.int32Val = 0x13572468;
+    c = &add("int32/unaligned/low", ScanType::Int32, 1, 0);
+    c->opt.int32Val = 0x13572468;
+    c = &add("int32/aligned/high", ScanType::Int32, 4, 128);
+    c->opt.int32Val = 100; c->plant = Bytes<int32_t>(100);
+    c = &add("int32/unaligned/high", ScanType::Int32, 1, 128);
+    c->opt.int32Val = 101; c->plant = Bytes<int32_t>(101);
+    c = &add("float/aligned/high", ScanType::Float, 4, 512);
+    c->opt.floatVal = 3.5f; c->plant = Bytes<float>(3.5f);
+    c = &add("double/aligned/low", ScanType::Double, 8, 0);
+    c->opt.doubleVal = 1234.5678;
+    c = &add("ascii/low", ScanType::Ascii, 1, 0);
+    c->opt.strExpr = "kernel32.dll";
+    c = &add("ascii/high", ScanType::Ascii, 1, 1024);
+    c->opt.strExpr = "PlayerHealth";
+    c->plant.assign(c->opt.strExpr.begin(), c->opt.strExpr.end());
+    c = &add("utf16/low", ScanType::Utf16, 2, 0);
+    c->opt.strExpr = "ntdll.dll";
+    return cs;
+}
+
+void Print(const std::vector<Result>& rs) {
+    printf("%-30s %10s %12s %14s %12s\n", "case", "GB/s", "hits", "hits/s", "ns/hit");
+    for (auto& r : rs) {
+        double gbs = r.seconds > 0 ? (double)r.bytes / r.seconds / 1e9 : 0;
+        double hps = r.seconds > 0 ? (double)r.hits / r.seconds : 0;
+        double nsh = r.hits ? r.seconds * 1e9 / (double)r.hits : 0;
+        printf("%-30s %10.3f %12llu %14.0f %12.2f\n", r.name.c_str(), gbs, (unsigned long long)r.hits, hps, nsh);
+    }
+}
+
+bool WriteJson(const std::vector<Result>& rs, size_t sizeMb, int iters, const char* path) {
+    FILE* f = strcmp(path, "-") == 0 ? stdout : fopen(path, "w");
+    if (!f) return false;
+    fprintf(f, "{\n  \"bufferMB\": %zu,\n  \"iterations\": %d,\n  \"cases\": [\n", sizeMb, iters);
+    for (size_t i = 0; i < rs.size(); ++i) {
+        const Result& r = rs[i];
+        double gbs = r.seconds > 0 ? (double)r.bytes / r.seconds / 1e9 : 0;
+        double hps = r.seconds > 0 ? (double)r.hits / r.seconds : 0;
+        double nsh = r.hits ? r.seconds * 1e9 / (double)r.hits : 0;
+        fprintf(f, "    {\"name\": \"%s\", \"seconds\": %.6f, \"bytes\": %llu, \"hits\": %llu, "
+                   "\"gbPerSec\": %.4f, \"hitsPerSec\": %.1f, \"nsPerHit\": %.3f}%s\n",
+                r.name.c_str(), r.seconds, (unsigned long long)r.bytes, (unsigned long long)r.hits,
+                gbs, hps, nsh, i + 1 < rs.size() ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+    if (f != stdout) fclose(f);
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t sizeMb = 2048;
+    int iters = 3;
+    const char* json = nullptr;
+    const char* filter = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--size-mb") && i + 1 < argc) sizeMb = (size_t)strtoull(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--iters") && i + 1 < argc) iters = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--json") && i + 1 < argc) json = argv[++i];
+        else if (!strcmp(argv[i], "--filter") && i + 1 < argc) filter = argv[++i];
+        else {
+            fprintf(stderr, "usage: %s [--size-mb N] [--iters N] [--json file|-] [--filter substr]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (sizeMb == 0 || iters <= 0) { fprintf(stderr, "size and iters must be positive\n"); return 2; }
+
+    std::vector<Case> cases = MakeCases();
+    std::vector<uint8_t> buf(sizeMb << 20);
+    FillRandom(buf);
+    size_t slot = 0;
+    for (auto& c : cases) {
+        if (!c.plantEvery || c.plant.empty()) continue;
+        Plant(buf, c, slot);
+        slot += (c.plant.size() + 7) & ~(size_t)7;
+    }
+
+    std::vector<Result> rs;
+    for (auto& c : cases) {
+        if (filter && !strstr(c.name, filter)) continue;
+        rs.push_back(Run(c, buf, iters));
+    }
+    auto want = [&](const char* name) { return !filter || strstr(name, filter); };
+    if (want("sig/dense-wildcards/high"))
+        rs.push_back(RunSig("sig/dense-wildcards/high", REKIT_SIG("48 ?? ?? ?? ?? 89 ?? ??"), buf, iters));
+    if (want("sig/long-literal/high"))
+        rs.push_back(RunSig("sig/long-literal/high",
+            REKIT_SIG("40 53 48 83 EC 20 48 8B D9 48 8B 0D 11 22 33 44 48 85 C9 74 05"), buf, iters));
+    if (!filter || strstr("ParseHexWithMask", filter)) rs.push_back(RunParse(iters));
+
+    if (!json || strcmp(json, "-") != 0) Print(rs);
+    if (json && !WriteJson(rs, sizeMb, iters, json)) { fprintf(stderr, "cannot write %s\n", json); return 1; }
+    return 0;
+}
@@ -1,19 +1,38 @@
 #pragma once
+#ifdef _WIN32
 #include <windows.h>
+#else
+#include <cstdint>
+#include <cstddef>
+// Stand-ins for the Windows types below; filled from /proc by ProcFsReader.
+typedef uint32_t ULONG;
+typedef size_t   SIZE_T;
+typedef long     KPRIORITY;
+typedef union { int64_t QuadPart; } LARGE_INTEGER;
+#endif
+#include <string>
 #include <vector>
+#include <memory>
 #include <mutex>
+#include <cstdint>
 #include <thread>
 #include <atomic>
 #include <chrono>
 #include <algorithm>
 
+#ifdef _WIN32
 #include "include/ntapi.h"
+#endif
 #include "include/utils.h"
 #include "imgui/imgui.h"
 
+// One process as enumerated by a poll; the monitoring thread publishes
+// them as a ProcessSnapshot.
 struct ProcessInfo {
     std::wstring name;
     std::wstring imagePath;
+    std::wstring commandLine;
+    std::wstring userName;
     ULONG pid;
     ULONG threads;
     ULONG handles;
@@ -41,14 +60,15 @@ struct ProcessInfo {
     }
 };
 
-extern std::vector<ProcessInfo> g_processes;
-extern std::mutex g_processesMutex;
+// Columnar result of one poll; see include/ProcessSnapshot.h.
+struct ProcessSnapshot;
+typedef std::shared_ptr<const ProcessSnapshot> ProcessSnapshotPtr;
 
-std::wstring GetProcessImagePath(ULONG pid);
 void StartProcessMonitoring();
 void StopProcessMonitoring();
-std::vector<ProcessInfo> GetProcessList();
+// Latest snapshot, never null; costs a reference count, not a copy.
+ProcessSnapshotPtr GetProcessSnapshot();
 size_t GetProcessCount();
-ProcessInfo* FindProcessByPID(ULONG pid);
-std::vector<ProcessInfo> FilterProcesses(const std::string& nameFilter, const std::string& pidFilter, const std::string& pathFilter);
-void SortProcessList(std::vector<ProcessInfo>& processes, const ImGuiTableSortSpecs* sort_specs);
+// Both work on row numbers of snapshot.
+std::vector<uint32_t> FilterProcesses(const ProcessSnapshot& snapshot, const std::string& nameFilter, const std::string& pidFilter, const std::string& pathFilter);
+void SortProcessList(const ProcessSnapshot& snapshot, std::vector<uint32_t>& rows, const ImGuiTableSortSpecs* sort_specs);
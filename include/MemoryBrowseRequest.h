@@ -0,0 +1,23 @@
+#pragma once
+// Lightweight "show this address" channel into the memory browser.
+// Any plugin can ask for an address (e.g. MemSearch on a result):
+//   RequestMemoryBrowse(addr);
+// and the MemBrowser panel picks it up on its next frame.
+
+#include <atomic>
+#include <cstdint>
+
+inline std::atomic<uintptr_t>& REKit_MemoryBrowseRequest() {
+    static std::atomic<uintptr_t> addr{0};
+    return addr;
+}
+
+inline void RequestMemoryBrowse(uintptr_t addr) {
+    REKit_MemoryBrowseRequest() = addr;
+}
+
+// Returns true and the address once per request.
+inline bool TakeMemoryBrowseRequest(uintptr_t& out) {
+    out = REKit_MemoryBrowseRequest().exchange(0);
+    return out != 0;
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "include/EnumProcessInfo.h"
+
+// /proc backend of the process monitor (Linux).
+//
+// A poll lists /proc with getdents64 on a cached directory fd and reads each
+// <pid>/stat through an fd kept open between polls (up to an fd budget; the
+// rest are opened per poll with openat). <pid>/status and <pid>/io are read
+// for an eighth of the processes per poll, and for new ones. Files are read
+// with pread into one reused buffer and parsed by hand. A process seen in
+// the previous poll has its strings copied from there; written into a
+// recycled list they fit the existing capacity, so a steady-state poll
+// allocates nothing. The previous list is the attribute cache here, and
+// exited processes drop out of it with their entry. execve keeps pid and
+// starttime, so an entry is only reused while the stat comm is unchanged
+// and, checked on the polls that read status, the exe link still points at
+// the same file (dev, inode); otherwise LoadProcessAttrs runs again, as it
+// does for new processes.
+//
+// Every path is opened relative to the cached /proc fd, LoadProcessAttrs
+// included (LoadProcessAttrsAt).
+//
+// Cost with 3058 processes (1 vCPU VM): about 19 ms per steady poll, of which
+// 11 ms is the stat pread alone (~3.5 us of kernel time per process, the
+// floor while CPU times are sampled for every process on every poll);
+// status, io and the exe check add 2.5, 1.1 and 0.9 ms, getdents 2 ms.
+//
+// Field mapping: times are converted to 100ns units and createTime to a
+// FILETIME, like on Windows; privatePages holds RssAnon + VmSwap in bytes,
+// read/writeTransferCount rchar / wchar; handles is not available cheaply
+// and stays 0.
+class ProcFsReader {
+public:
+    ProcFsReader();
+    ~ProcFsReader();
+    ProcFsReader(const ProcFsReader&) = delete;
+    ProcFsReader& operator=(const ProcFsReader&) = delete;
+
+    bool IsOpen() const { return procFd_ >= 0; }
+
+    // prev is this reader's previous result (or empty) and is only read; procs
+    // is overwritten with the current list, sorted by pid. Passing an older
+    // result as procs reuses its elements.
+    bool Poll(const std::vector<ProcessInfo>& prev, std::vector<ProcessInfo>& procs);
+
+private:
+    struct Track {
+        uint32_t pid = 0;
+        uint64_t start = 0;     // stat starttime, clock ticks since boot
+        int      statFd = -1;
+        uint8_t  commLen = 0;
+        char     comm[16];      // stat comm, TASK_COMM_LEN
+        uint64_t exeDev = 0, exeIno = 0;    // exe link target; 0 when unreadable
+    };
+
+    bool ReadProcess(uint32_t pid, const ProcessInfo* prev, Track* prevTrack, ProcessInfo& out, Track& track, bool details);
+    ssize_t ReadAt(const char* name, uint32_t pid);     // openat + pread + close into buf_
+    void StatExe(uint32_t pid, Track& track);
+    void CloseFd(int& fd);
+
+    int procFd_ = -1;
+    long ticks_ = 100;              // clock ticks per second
+    long pageSize_ = 4096;
+    uint64_t bootTime_ = 0;         // seconds since the epoch
+    size_t fdBudget_ = 0;
+    size_t cachedFds_ = 0;
+    uint64_t polls_ = 0;
+
+    std::vector<char> dents_;
+    std::vector<char> buf_;
+    std::vector<Track> track_, nextTrack_;
+};
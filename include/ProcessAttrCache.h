@@ -0,0 +1,52 @@
+#pragma once
+#include <string>
+#include <unordered_map>
+#include <cstdint>
+
+#include "include/EnumProcessInfo.h"
+
+// Image path, command line and user of a process. On Windows they are fixed
+// for the life of a process. On Linux execve replaces the image and command
+// line, and a setuid image the user, while pid and starttime stay the same.
+struct ProcessAttrs {
+    std::wstring imagePath;
+    std::wstring commandLine;
+    std::wstring userName;      // DOMAIN\user on Windows
+};
+
+// Reads the attributes of pid once (OpenProcess + queries on Windows,
+// /proc/<pid>/{exe,cmdline,status} on Linux); fields that cannot be read stay empty.
+void LoadProcessAttrs(ULONG pid, ProcessAttrs& out);
+#ifndef _WIN32
+// Same, with paths relative to an open /proc directory fd (AT_FDCWD: "/proc").
+void LoadProcessAttrsAt(int procFd, ULONG pid, ProcessAttrs& out);
+#endif
+
+// ProcessAttrs per (pid, createTime), so the Windows monitor opens a process
+// once in its lifetime instead of on every poll. A pid reused by a new process
+// has a different createTime and is loaded again; entries not seen during a
+// poll (BeginPoll .. EndPoll) are dropped. That key is not enough on Linux,
+// where ProcFsReader also watches for exec (see ProcFsReader.h).
+//
+// Used by the monitoring thread only; not thread safe.
+class ProcessAttrCache {
+public:
+    void BeginPoll() { ++poll_; }
+    // Attributes of the process, loaded on first sight.
+    const ProcessAttrs& Get(ULONG pid, int64_t createTime);
+    void EndPoll();
+
+    size_t Size() const { return entries_.size(); }
+    uint64_t Loads() const { return loads_; }
+
+private:
+    struct Entry {
+        int64_t      createTime = 0;
+        uint64_t     seen = 0;
+        ProcessAttrs attrs;
+    };
+
+    std::unordered_map<ULONG, Entry> entries_;
+    uint64_t poll_ = 0;
+    uint64_t loads_ = 0;
+};
@@ -0,0 +1,91 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+#include "include/EnumProcessInfo.h"
+
+// Strings of one snapshot, each stored once and NUL terminated in three
+// forms: wide (Win32 calls), UTF-8 (ImGui) and lowercased UTF-8 (filters and
+// sorting; ASCII letters only, like the filters always did). Id 0 is the
+// empty string.
+class StringArena {
+public:
+    StringArena() { Clear(); }
+
+    uint32_t Size() const { return (uint32_t)entries_.size(); }
+    const wchar_t* Wide(uint32_t id) const { return wide_.data() + entries_[id].wide; }
+    const char* Utf8(uint32_t id) const { return utf8_.data() + entries_[id].utf8; }
+    const char* Lower(uint32_t id) const { return utf8_.data() + entries_[id].lower; }
+
+    void Clear();
+    uint32_t Add(const std::wstring& wide, const std::string& utf8, const std::string& lower);
+
+private:
+    struct Entry { uint32_t wide, utf8, lower; };
+
+    std::vector<Entry> entries_;
+    std::vector<wchar_t> wide_;
+    std::vector<char> utf8_;        // UTF-8 and lowercased forms
+};
+
+// The lowercasing behind StringArena::Lower, for filter keywords.
+std::string LowerAscii(const std::string& s);
+
+// Converted forms of the strings of recent polls. Kept by the monitoring
+// thread across polls, so a name or path is converted to UTF-8 once while it
+// is in use; each poll only copies it into the new snapshot's arena. Strings
+// not seen during a poll are dropped.
+class StringInterner {
+public:
+    void BeginPoll(StringArena& arena);
+    uint32_t Intern(const std::wstring& s);
+    void EndPoll();
+
+    size_t Size() const { return entries_.size(); }
+
+private:
+    struct Entry {
+        std::string utf8, lower;
+        uint64_t seen = 0;
+        uint32_t id = 0;            // in the current poll's arena
+    };
+
+    std::unordered_map<std::wstring, Entry> entries_;
+    StringArena* arena_ = nullptr;
+    uint64_t poll_ = 0;
+};
+
+// One poll of the process monitor as columns: element r of every column
+// belongs to the same process, and rows are sorted by pid. Numeric columns
+// are contiguous so filters and sorts touch only what they compare; strings
+// are ids into the snapshot's arena. Published whole and never modified
+// afterwards, so readers use it without locks for as long as they hold it.
+struct ProcessSnapshot {
+    static const uint32_t kNoRow = 0xFFFFFFFFu;
+
+    uint64_t sequence = 0;                  // 0 before the first poll
+
+    std::vector<ULONG>     pid, threads, handles, sessionId;
+    std::vector<KPRIORITY> basePriority;
+    std::vector<SIZE_T>    workingSet, virtualSize, privatePages;
+    std::vector<int64_t>   createTime, userTime, kernelTime;        // 100ns units, createTime as a FILETIME
+    std::vector<int64_t>   readBytes, writeBytes, otherBytes;
+    std::vector<uint32_t>  name, imagePath, commandLine, userName;  // ids into strings
+    StringArena strings;
+
+    size_t Size() const { return pid.size(); }
+    // Row of pid through the hash index, or kNoRow.
+    uint32_t Find(ULONG pid) const;
+
+    // Rebuilds every column from rows (sorted by pid), reusing the storage.
+    void Assign(const std::vector<ProcessInfo>& rows, StringInterner& interner);
+
+private:
+    void BuildIndex();
+
+    std::vector<uint32_t> index_;           // open addressing; row + 1, 0 when empty
+    unsigned indexShift_ = 32;
+};
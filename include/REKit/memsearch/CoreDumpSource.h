@@ -0,0 +1,62 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+#include "include/REKit/memsearch/MemorySource.h"
+
+// Memory of a crashed or captured process from its ELF core file, for scans
+// without a live process (ScanOptions::source).
+//
+// The file is mapped read-only once. Every PT_LOAD segment with file bytes is
+// a readable region whose Region::local points into the mapping, so first
+// scans run on the page cache without copies; the part of a segment that was
+// not dumped (p_filesz < p_memsz) reads as unmapped. NT_FILE notes give the
+// file-backed mappings, reported as modules. ELF32 and ELF64, little-endian.
+
+namespace REKit { namespace MemSearch {
+
+class CoreDumpSource : public IMemorySource {
+public:
+    CoreDumpSource() = default;
+    ~CoreDumpSource();
+    CoreDumpSource(const CoreDumpSource&) = delete;
+    CoreDumpSource& operator=(const CoreDumpSource&) = delete;
+
+    // Maps path (UTF-8) and reads its program headers and notes. On failure err says why.
+    bool Open(const std::string& path, std::string* err = nullptr);
+    void Close();
+
+    bool IsOpen() const override { return view_ != nullptr; }
+    unsigned int Pid() const override { return 0; }
+    size_t Read(uintptr_t addr, void* dst, size_t n) const override;
+    void EnumReadableRegions(std::vector<Region>& out, uintptr_t clipBase = 0, uintptr_t clipEnd = 0) const override;
+    bool QueryRegion(uintptr_t addr, RegionInfo& out) const override;
+    void EnumModules(std::vector<ModuleInfo>& out) const override { out = modules_; }
+
+    const std::string& Path() const { return path_; }
+    uint64_t DumpedBytes() const;   // memory bytes present in the file
+
+private:
+    struct Segment {
+        uintptr_t base;
+        size_t    size;     // bytes present in the file
+        uint64_t  off;      // file offset
+        uintptr_t runEnd;   // end of the run of address-adjacent segments it belongs to
+    };
+
+    bool Parse(std::string* err);
+    void ParseFileNote(const uint8_t* desc, uint64_t size, bool is64);
+    size_t Find(uintptr_t addr) const;      // index of the segment holding addr, or segs_.size()
+
+    std::string path_;
+    const uint8_t* view_ = nullptr;
+    uint64_t size_ = 0;
+    void* file_ = nullptr;      // HANDLEs on Windows
+    void* mapping_ = nullptr;
+    std::vector<Segment> segs_;     // ascending, non-overlapping
+    std::vector<ModuleInfo> modules_;
+};
+
+}} // namespace
@@ -0,0 +1,61 @@
+#pragma once
+#include <vector>
+#include <array>
+#include <string>
+#include <cstdint>
+#include <atomic>
+
+#include "include/REKit/memsearch/ProcessMemory.h"
+
+namespace REKit { namespace MemSearch {
+
+// Shannon entropy / byte histogram analysis over a target's readable regions.
+// High entropy (close to 8 bits/byte) flags packed code, encrypted buffers and compressed blobs.
+
+struct EntropyOptions {
+    unsigned int pid = 0;
+    uintptr_t base = 0;
+    size_t    length = 0;       // 0 = whole address space
+    size_t    pageSize = 4096;  // power of two, 256..64KB
+    unsigned  threads = 0;      // 0 = hardware concurrency
+};
+
+struct RegionEntropy {
+    uintptr_t base = 0;
+    size_t    size = 0;
+    uint64_t  bytesRead = 0;
+    float     entropy = 0.f;                 // bits per byte over the readable part, 0..8
+    std::array<uint64_t, 256> histogram{};
+    std::vector<float> pageEntropy;          // one per page, -1 = unreadable
+};
+
+struct EntropyReport {
+    size_t pageSize = 4096;
+    std::vector<RegionEntropy> regions;
+};
+
+// Coarse heat map for drawing: consecutive pages of a region folded into a cell.
+// Cells never span two regions, so there are at most maxCells + regions cells.
+struct EntropyHeatCell {
+    uintptr_t base;
+    size_t    size;
+    float     mean;   // -1 when no page of the cell was readable
+    float     max;
+};
+
+struct EntropyHeatMap {
+    size_t pagesPerCell = 1;
+    std::vector<EntropyHeatCell> cells;
+};
+
+float ShannonEntropy(const uint64_t* hist256, uint64_t total);
+
+void AnalyzeEntropy(const EntropyOptions& opt,
+                    EntropyReport& report,
+                    std::atomic<bool>& cancel,
+                    std::atomic<float>& progress,
+                    std::string& status);
+
+EntropyHeatMap BuildEntropyHeatMap(const EntropyReport& report, size_t maxCells);
+
+}} // namespace
@@ -0,0 +1,97 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <cstdint>
+
+#include "include/REKit/memsearch/MemSearchEngine.h"
+
+namespace REKit { namespace MemSearch {
+
+// A value kept locked at an address. bytes is what gets written each tick.
+struct FreezeEntry {
+    uint64_t  id = 0;           // assigned by Freezer::Add
+    uintptr_t addr = 0;
+    ScanType  type = ScanType::Int32;
+    std::vector<uint8_t> bytes;
+    uint64_t  failures = 0;     // ticks on which this entry's span failed
+};
+
+FreezeEntry MakeFreezeInt32(uintptr_t addr, int32_t v);
+FreezeEntry MakeFreezeFloat(uintptr_t addr, float v);
+FreezeEntry MakeFreezeDouble(uintptr_t addr, double v);
+FreezeEntry MakeFreezeBytes(uintptr_t addr, const void* data, size_t n, ScanType type = ScanType::Bytes);
+
+struct FreezeStats {
+    uint64_t ticks = 0;
+    uint64_t missedTicks = 0;   // deadlines skipped because a tick overran
+    uint64_t spans = 0;         // coalesced spans in the current batch
+    uint64_t writeCalls = 0;
+    uint64_t bytesWritten = 0;
+    uint64_t writeFailures = 0; // failed spans, summed over ticks
+    uint64_t jitterAvgNs = 0;   // wake-up lateness against the deadline
+    uint64_t jitterMaxNs = 0;
+    uint64_t tickAvgNs = 0;     // time spent writing per tick
+};
+
+// Rewrites every entry into the target on a dedicated timer thread.
+// Entries are sorted and touching ones merged into one span; spans are issued
+// page by page in a single WriteBatch per tick, so cost follows the number
+// of distinct ranges rather than the number of entries.
+class Freezer {
+public:
+    Freezer();
+    ~Freezer();
+    Freezer(const Freezer&) = delete;
+    Freezer& operator=(const Freezer&) = delete;
+
+    // Opens pid for writing and starts the timer thread. Restarts if running.
+    bool Start(unsigned pid, unsigned periodUs = 10000);
+    void Stop();
+    bool Running() const { return running_; }
+    unsigned Pid() const { return pid_; }
+
+    void     SetPeriod(unsigned periodUs);
+    unsigned Period() const { return periodUs_; }
+
+    uint64_t Add(FreezeEntry e);
+    bool     Remove(uint64_t id);
+    bool     SetValue(uint64_t id, const void* data, size_t n);
+    void     Clear();
+    size_t   Count() const;
+    std::vector<FreezeEntry> Entries() const;
+
+    FreezeStats Stats() const;
+    void        ResetStats();
+
+private:
+    struct Span { uintptr_t addr; size_t off; size_t size; size_t first, last; };
+    void Run();
+    void RebuildLocked();
+
+    mutable std::mutex mu_;
+    std::condition_variable cv_;
+    std::thread thread_;
+    std::unique_ptr<ProcessMemory> mem_;
+    std::atomic<bool> running_{false};
+    bool stop_ = false;
+    unsigned pid_ = 0;
+    std::atomic<unsigned> periodUs_{10000};
+
+    std::vector<FreezeEntry> entries_;      // sorted by address
+    uint64_t nextId_ = 1;
+    bool dirty_ = false;
+
+    // batch owned by the timer thread, rebuilt from entries_ when dirty_
+    std::vector<uint8_t> image_;
+    std::vector<Span> spans_;
+
+    FreezeStats stats_;
+    uint64_t jitterSumNs_ = 0, tickSumNs_ = 0;
+};
+
+}} // namespace
@@ -0,0 +1,49 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+#include "include/REKit/memsearch/MemSearchEngine.h"
+
+namespace REKit { namespace MemSearch {
+
+// Parses "i32:100 f32:3.5 i16:7 hex:488B??" (space or comma separated) into terms.
+// Types: i8 i16 i32 i64 u8 u16 u32 u64 f32 f64 hex. Keeps spec.window/ordered.
+bool ParseGroupExpr(const std::string& src, GroupScanSpec& spec, std::string* error = nullptr);
+
+// Group scan kernel. The most selective term is the anchor: the buffer is
+// swept for it (memchr on its rarest byte, then a full compare) and the other
+// terms are only looked for within the window around each anchor hit, in the
+// same chunk. A match is reported at the address of its first term.
+class GroupMatcher {
+public:
+    bool Compile(const GroupScanSpec& spec, size_t alignment);
+
+    size_t Window() const { return window_; }
+    size_t Anchor() const { return anchor_; }
+
+    // Appends, in ascending order, groups that start in buf[0, owned).
+    // buf must extend Window() bytes past owned (or to the end of the region).
+    void Search(const uint8_t* buf, size_t n, size_t owned, uintptr_t baseAddr, std::vector<uintptr_t>& out) const;
+
+    // True if a group starts exactly at buf[0], which lives at addr.
+    bool MatchAt(const uint8_t* buf, size_t n, uintptr_t addr) const;
+
+private:
+    bool TermAt(size_t t, const uint8_t* buf, size_t n, size_t pos, uintptr_t baseAddr) const;
+    bool Ordered(const uint8_t* buf, size_t n, size_t a, uintptr_t baseAddr, size_t& start) const;
+    bool Unordered(const uint8_t* buf, size_t n, size_t a, uintptr_t baseAddr, size_t& start,
+                   std::vector<std::vector<size_t>>& occ) const;
+    bool Distinct(const std::vector<std::vector<size_t>>& occ, size_t lo, size_t hi, size_t fixed, size_t fixedPos) const;
+
+    std::vector<GroupTerm> terms_;
+    size_t  window_ = 0;
+    size_t  align_ = 1;
+    bool    ordered_ = true;
+    size_t  anchor_ = 0;
+    size_t  rareOff_ = 0;       // offset of the anchor's memchr byte
+    uint8_t rareByte_ = 0;
+};
+
+}} // namespace
@@ -3,17 +3,42 @@
 #include <string>
 #include <cstdint>
 #include <atomic>
+#include <memory>
+
+#include "include/REKit/memsearch/ProcessMemory.h"
+#include "include/REKit/memsearch/ScanStats.h"
+#include "include/REKit/memsearch/ResultStore.h"
 
 namespace REKit { namespace MemSearch {
-enum class ScanType { Bytes, Ascii, Utf16, Int32, Float, Double };
+enum class ScanType { Bytes, Ascii, Utf16, Int32, Float, Double, Group };
 
 enum class CompareMode { Exact, Increased, Decreased, Changed, Unchanged };
 
+// Group scan: several typed values that must all appear within `window` bytes.
+// Values are compared bit-exactly in little-endian form; Bytes terms may carry
+// '?' nibble wildcards. See ParseGroupExpr for the text form.
+enum class GroupTermType { Int8, Int16, Int32, Int64, Float, Double, Bytes };
+
+struct GroupTerm {
+    GroupTermType type = GroupTermType::Int32;
+    std::vector<uint8_t> pat, mask;
+};
+
+struct GroupScanSpec {
+    std::vector<GroupTerm> terms;
+    size_t window = 64;     // bytes from the first term's start to the last term's end
+    bool   ordered = true;  // terms appear in list order, without overlapping
+};
+
 struct ScanOptions {
     unsigned int pid = 0;
     uintptr_t base = 0;
     size_t    length = 0;
     bool      autoPages = true;     // use VirtualQueryEx to auto enumerate readable regions
+    bool      cachedRegions = true; // reuse the target's coalesced region map between scans (RegionMapCache)
+    bool      moduleFiles = false;  // first scan: read-only module sections come from their files on disk (autoPages only)
+    bool      useAgent = false;     // first scan: run inside the target when its scan agent is loaded (ScanAgent.h)
+    std::shared_ptr<const IMemorySource> source;    // read through this instead of opening pid
     size_t    alignment = 1;
     ScanType  type = ScanType::Bytes;
     CompareMode cmp = CompareMode::Exact; // used for next-scan
@@ -23,20 +48,38 @@ struct ScanOptions {
     int         int32Val = 0;
     float       floatVal = 0.f;
     double      doubleVal = 0.0;
+    GroupScanSpec group;
+    // ResultStore overloads: bytes of results kept in RAM before spilling to a temp file (0 = unlimited)
+    size_t      resultMemoryBudget = 0;
 };
 
-struct Region { uintptr_t base; size_t size; };
-
 void StartFirstScan(const ScanOptions& opt,
                           std::vector<uintptr_t>& results,
                           std::atomic<bool>& cancel,
                           std::atomic<float>& progress,
-                          std::string& status);
+                          std::string& status,
+                          ScanStats* stats = nullptr);
 void StartNextScan(const ScanOptions& opt,
                          const std::vector<uintptr_t>& prev,
                          std::vector<uintptr_t>& results,
                          std::atomic<bool>& cancel,
                          std::atomic<float>& progress,
-                         std::string& status);
+                         std::string& status,
+                         ScanStats* stats = nullptr);
+
+// Same scans on a ResultStore, which honours opt.resultMemoryBudget.
+void StartFirstScan(const ScanOptions& opt,
+                          ResultStore& results,
+                          std::atomic<bool>& cancel,
+                          std::atomic<float>& progress,
+                          std::string& status,
+                          ScanStats* stats = nullptr);
+void StartNextScan(const ScanOptions& opt,
+                         const ResultStore& prev,
+                         ResultStore& results,
+                         std::atomic<bool>& cancel,
+                         std::atomic<float>& progress,
+                         std::string& status,
+                         ScanStats* stats = nullptr);
 
 }} // namespace
@@ -0,0 +1,59 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace REKit { namespace MemSearch {
+
+struct Region {
+    uintptr_t base;
+    size_t    size;
+    const uint8_t* local = nullptr;   // set when the bytes come from a local mapping instead of remote reads
+    uintptr_t limit = 0;              // overlap may run on to here when this is a piece of a larger region (0 = base + size)
+};
+
+// A loaded image: PE module on Windows, file-backed mapping group on Linux.
+struct ModuleInfo {
+    uintptr_t   base = 0;
+    size_t      size = 0;       // from base to the end of its last mapping
+    std::string name;           // file name, UTF-8
+    std::string path;           // full path, UTF-8
+};
+
+// One VirtualQueryEx answer: [base, base + size) shares one state; readable = committed and readable.
+struct RegionInfo { uintptr_t base; size_t size; bool readable; };
+
+// One contiguous remote read / write.
+struct ReadSpan  { uintptr_t addr; void* data; size_t size; };
+struct WriteSpan { uintptr_t addr; const void* data; size_t size; };
+
+// Read-only view of an address space the scanners work on: a live process
+// (ProcessMemory), a scan agent inside the target (ScanAgentClient), ...
+// Implementations must be safe to read from several threads at once.
+class IMemorySource {
+public:
+    virtual ~IMemorySource() = default;
+
+    virtual bool IsOpen() const = 0;
+    // Live process behind the source; 0 when there is none.
+    virtual unsigned int Pid() const = 0;
+
+    // Returns the number of bytes read, 0 on failure.
+    virtual size_t Read(uintptr_t addr, void* dst, size_t n) const = 0;
+
+    // Reads every span; failed[i] is set for spans that were not read completely.
+    // Returns the failure count.
+    virtual size_t ReadBatch(const ReadSpan* spans, size_t n, std::vector<char>* failed = nullptr) const;
+
+    // Readable regions, ascending; clipped to [clipBase, clipEnd) when clipEnd > clipBase.
+    virtual void EnumReadableRegions(std::vector<Region>& out, uintptr_t clipBase = 0, uintptr_t clipEnd = 0) const = 0;
+
+    // Region containing addr; false when the source has no point query.
+    virtual bool QueryRegion(uintptr_t addr, RegionInfo& out) const { (void)addr; (void)out; return false; }
+
+    // Loaded modules; the main executable comes first. Empty when unknown.
+    virtual void EnumModules(std::vector<ModuleInfo>& out) const { out.clear(); }
+};
+
+}} // namespace
@@ -0,0 +1,72 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+#include "include/REKit/memsearch/MemorySource.h"
+
+// Read-only sections of a loaded module are byte-identical to its file on
+// disk, so they can be scanned from a local read-only mapping of the file
+// instead of through cross-process reads.
+//
+// PE:  sections without IMAGE_SCN_MEM_WRITE, file part only (SizeOfRawData);
+//      pages the loader writes are left out: the import address table, the
+//      load config directory and the CFG/XFG pointer slots it names, and, when
+//      the module is not at its preferred base, pages touched by relocations.
+// ELF: PT_LOAD segments without PF_W (RELRO is writable in the file flags and
+//      so stays remote), file part only (p_filesz).
+// The first page of every span is compared with the target before it is
+// trusted, which catches a replaced or rebuilt file. Later pages are not
+// compared, so code patched in the target past a span's first page (hooks,
+// breakpoints) is scanned as it is on disk.
+
+namespace REKit { namespace MemSearch {
+
+class ModuleImage {
+public:
+    ModuleImage() = default;
+    ~ModuleImage();
+    ModuleImage(const ModuleImage&) = delete;
+    ModuleImage& operator=(const ModuleImage&) = delete;
+
+    // Maps mod.path and lays out its read-only sections at mod.base. With
+    // baseIndependent, PE relocation pages are left out even at the preferred
+    // base, so every span byte is the same wherever the module is loaded.
+    bool Open(const IMemorySource& mem, const ModuleInfo& mod, bool baseIndependent = false);
+    void Close();
+    bool IsOpen() const { return view_ != nullptr; }
+
+    // Runtime ranges backed by the mapping, ascending; Region::local points into it.
+    const std::vector<Region>& Spans() const { return spans_; }
+
+private:
+    bool LayoutPe(uintptr_t base, bool baseIndependent);
+    bool LayoutElf(uintptr_t base);
+    void AddSpan(uintptr_t addr, uint64_t fileOff, uint64_t size);
+
+    const uint8_t* view_ = nullptr;
+    uint64_t size_ = 0;
+    void* file_ = nullptr;      // HANDLEs on Windows
+    void* mapping_ = nullptr;
+    std::vector<Region> spans_;
+};
+
+// File-backed spans of every module of a process.
+class ModuleImageSet {
+public:
+    // Opens every module whose file can be mapped; returns the number opened.
+    size_t Open(const IMemorySource& mem);
+    void Clear() { images_.clear(); }
+
+    // Replaces the parts of regs (ascending, non-overlapping) covered by a
+    // verified span with regions that point into the mapping.
+    void Overlay(std::vector<Region>& regs) const;
+
+    size_t MappedBytes() const;
+
+private:
+    std::vector<std::unique_ptr<ModuleImage>> images_;
+};
+
+}} // namespace
@@ -0,0 +1,91 @@
+#pragma once
+#include <vector>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+#include "include/REKit/memsearch/MemorySource.h"
+
+// LRU cache of a target's pages for interactive views (the memory browser).
+//
+// Lookups never read: a missing or stale page is queued and a background
+// thread fetches queued pages in batches (adjacent ones as one span), so the
+// UI thread never waits on the target. Demand requests go before prefetches,
+// newest first, so the pages on screen arrive first while scrolling.
+//
+// Each refresh keeps the copy it replaced, so callers can highlight bytes
+// that changed between the last two reads. Only refreshed pages (a live view
+// passing refreshNs) carry that copy; the default capacity is 16 MB of pages.
+
+namespace REKit { namespace MemSearch {
+
+struct CachedPage {
+    uintptr_t addr;
+    bool      ok;           // false: unreadable at readNs
+    uint64_t  readNs;
+    uint8_t   data[4096];
+    std::unique_ptr<uint8_t[]> prev;    // kPage bytes before this read; null on a first read
+};
+
+struct PageCacheStats {
+    uint64_t pages = 0;         // cached
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t reads = 0;         // pages read by the worker
+    uint64_t batches = 0;
+    uint64_t evictions = 0;
+    uint64_t readFailures = 0;
+};
+
+class PageCache {
+public:
+    static constexpr size_t kPage = 4096;
+
+    explicit PageCache(std::shared_ptr<const IMemorySource> mem, size_t capacityPages = 4096);
+    ~PageCache();
+    PageCache(const PageCache&) = delete;
+    PageCache& operator=(const PageCache&) = delete;
+
+    const std::shared_ptr<const IMemorySource>& Source() const { return mem_; }
+
+    // Cached copy of the page at pageAddr (kPage aligned), or null before the
+    // first read. Queues a read when absent or older than refreshNs (0 = never refresh).
+    std::shared_ptr<const CachedPage> Get(uintptr_t pageAddr, uint64_t refreshNs = 0);
+    // Queues the uncached pages of [addr, addr + n) behind demand reads.
+    void Prefetch(uintptr_t addr, size_t n);
+
+    void Clear();
+    PageCacheStats Stats() const;
+
+private:
+    struct Node {
+        std::shared_ptr<const CachedPage> page;
+        std::list<uintptr_t>::iterator lru;
+    };
+
+    void Run();
+    enum : uint8_t { kPrefetch = 1, kDemand = 2, kInFlight = 3 };
+    bool Queue(uintptr_t page, bool demand);       // caller holds mu_; false if already queued
+    void Store(std::shared_ptr<const CachedPage> p); // caller holds mu_
+
+    std::shared_ptr<const IMemorySource> mem_;
+    size_t capacity_;
+
+    mutable std::mutex mu_;
+    std::condition_variable cv_;
+    bool stop_ = false;
+    std::unordered_map<uintptr_t, Node> pages_;
+    std::list<uintptr_t> lru_;                  // most recent first
+    std::vector<uintptr_t> demand_;             // newest last
+    std::vector<uintptr_t> prefetch_;
+    std::unordered_map<uintptr_t, uint8_t> queued_;
+    PageCacheStats stats_;
+    std::thread worker_;
+};
+
+}} // namespace
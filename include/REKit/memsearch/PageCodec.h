@@ -0,0 +1,25 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+// Small LZ77 block codec for memory pages (LZ4-style sequences). No platform
+// or UI dependencies.
+//
+// A block is a run of sequences: a token byte (literal count in the high
+// nibble, match length - 4 in the low nibble, 15 = more length bytes follow,
+// each adding up to 255), the literals, then a 16-bit little-endian match
+// offset. The last sequence has literals only. Blocks are at most 64KB.
+
+namespace REKit { namespace MemSearch {
+
+constexpr size_t kLzMaxBlock = 1 << 16;
+
+// Compresses src[0, n) into dst; returns the compressed size, or 0 if it
+// would not fit in cap or n exceeds kLzMaxBlock.
+size_t LzCompress(const uint8_t* src, size_t n, uint8_t* dst, size_t cap);
+
+// Decompresses a block; returns the decompressed size, 0 if the block is
+// malformed or does not fit in cap.
+size_t LzDecompress(const uint8_t* src, size_t n, uint8_t* dst, size_t cap);
+
+}} // namespace
@@ -0,0 +1,120 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <memory>
+#include <shared_mutex>
+#include <atomic>
+#include <unordered_map>
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+
+#include "include/REKit/memsearch/MemorySource.h"
+
+// Page snapshots of a target for comparison scans.
+//
+// PageStore keeps distinct 4KB pages once, keyed by a 128-bit content hash:
+// all-zero pages are a marker and never stored, the rest are compressed with
+// PageCodec (or kept raw when that does not pay). Snapshots taken into the same
+// store share every page they have in common, across regions and over time.
+//
+// A PageSnapshot is a memory source over the pages it captured: any scan can
+// run on it, a page is decompressed only when read, and two snapshots of one
+// store compare equal pages by id without decompressing either.
+
+namespace REKit { namespace MemSearch {
+
+struct SnapshotStats {
+    uint64_t pages = 0;         // pages captured
+    uint64_t zeroPages = 0;
+    uint64_t dupPages = 0;      // already in the store
+    uint64_t newPages = 0;      // added to the store
+    uint64_t missingPages = 0;  // could not be read
+    uint64_t storedBytes = 0;   // bytes the new pages take in the store
+    uint64_t ns = 0;
+};
+
+class PageStore {
+public:
+    static constexpr size_t   kPage = 4096;
+    static constexpr uint32_t kZero = 0;            // page id of an all-zero page
+    static constexpr uint32_t kMissing = 0xFFFFFFFFu;
+
+    PageStore();
+    PageStore(const PageStore&) = delete;
+    PageStore& operator=(const PageStore&) = delete;
+
+    // Id of page's content, adding it if new. dup is set when it was already stored.
+    uint32_t Put(const uint8_t* page, bool* dup = nullptr);
+    // Decompresses page id into out[0, kPage); false for kMissing or a bad id.
+    // Safe while other threads Put.
+    bool Get(uint32_t id, uint8_t* out) const;
+
+    size_t   Pages() const;         // distinct non-zero pages
+    uint64_t StoredBytes() const;   // compressed bytes held
+    uint64_t MemoryBytes() const;   // including the index
+
+    bool Save(FILE* f) const;
+    bool Load(FILE* f);
+
+    // Changes whenever page ids may mean different content (new store, Load).
+    uint64_t Serial() const { return serial_; }
+
+private:
+    static constexpr size_t kChunk = 4 << 20;      // blob chunks never move once allocated
+
+    struct Key {
+        uint64_t a, b;
+        bool operator==(const Key& o) const { return a == o.a && b == o.b; }
+    };
+    struct KeyHash { size_t operator()(const Key& k) const { return (size_t)k.a; } };
+
+    struct Entry { Key key; uint32_t chunk, off, len, raw; };
+
+    static Key HashPage(const uint8_t* page);
+    uint32_t Append(const Key& key, const uint8_t* data, size_t len, bool raw);     // caller holds mu_
+
+    mutable std::shared_mutex mu_;
+    uint64_t serial_;
+    std::vector<Entry> entries_;    // id - 1
+    std::vector<std::unique_ptr<uint8_t[]>> chunks_;
+    size_t chunkUsed_ = kChunk;
+    uint64_t stored_ = 0;
+    std::unordered_map<Key, uint32_t, KeyHash> index_;
+};
+
+class PageSnapshot : public IMemorySource {
+public:
+    explicit PageSnapshot(std::shared_ptr<PageStore> store = nullptr);
+
+    // Captures mem's readable regions (clipped to [clipBase, clipEnd) when
+    // clipEnd > clipBase), replacing what the snapshot held.
+    bool Capture(const IMemorySource& mem, std::atomic<bool>& cancel, std::atomic<float>& progress,
+                 SnapshotStats* stats = nullptr, uintptr_t clipBase = 0, uintptr_t clipEnd = 0, unsigned threads = 0);
+
+    bool IsOpen() const override { return !areas_.empty(); }
+    unsigned int Pid() const override { return 0; }
+    size_t Read(uintptr_t addr, void* dst, size_t n) const override;
+    void EnumReadableRegions(std::vector<Region>& out, uintptr_t clipBase = 0, uintptr_t clipEnd = 0) const override;
+    bool QueryRegion(uintptr_t addr, RegionInfo& out) const override;
+
+    // Id of the page holding addr, kMissing outside. Pages start at their
+    // region's base; pageBase gets the start of addr's page.
+    uint32_t PageAt(uintptr_t addr, uintptr_t* pageBase = nullptr) const;
+    const std::shared_ptr<PageStore>& Store() const { return store_; }
+    uint64_t MemoryBytes() const;   // page table, not counting the store
+
+    // Store and snapshot in one file.
+    bool Save(const std::string& path) const;
+    bool Load(const std::string& path);
+
+private:
+    struct Area { uintptr_t base; size_t size; size_t first; };    // first: index into ids_
+    size_t Find(uintptr_t addr) const;     // index of the area holding addr, or areas_.size()
+
+    std::shared_ptr<PageStore> store_;
+    std::vector<Area> areas_;
+    std::vector<uint32_t> ids_;
+};
+
+}} // namespace
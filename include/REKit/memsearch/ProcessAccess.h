@@ -0,0 +1,122 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <cstdint>
+#include <cstddef>
+
+#include "include/REKit/memsearch/MemorySource.h"
+
+// Shared, reference-counted access to target processes.
+//
+// Every consumer used to open (and close) its own handle per click, scan or
+// injection. ProcessAccess keeps one handle per pid and access level, hands
+// out shared references and closes it when the last holder is done and it
+// has been idle for a while. A cached handle is checked before reuse, so a
+// pid that was recycled by a new process gets a fresh handle.
+//
+// Windows: process HANDLE; liveness from GetExitCodeProcess.
+// Linux:   /proc/<pid> directory fd (maps etc. are opened relative to it)
+//          and a pidfd for liveness; both stay bound to the process they were
+//          opened for, unlike the pid. Reads still go through process_vm_readv
+//          (/proc/<pid>/mem would also read PROT_NONE pages); readers check
+//          liveness after reading so bytes of a recycled pid are discarded.
+
+namespace REKit { namespace MemSearch {
+
+class ProcessMemory;
+
+class ProcessHandle {
+public:
+    ~ProcessHandle();
+    ProcessHandle(const ProcessHandle&) = delete;
+    ProcessHandle& operator=(const ProcessHandle&) = delete;
+
+    unsigned int Pid() const { return pid_; }
+    // Creation time (FILETIME on Windows, clock ticks since boot on Linux); with
+    // the pid it identifies the process.
+    uint64_t StartTime() const { return startTime_; }
+    unsigned Rights() const { return rights_; }
+    // False once the process has exited.
+    bool Alive() const;
+
+    void* Native() const { return handle_; }    // HANDLE on Windows
+    int ProcFd() const { return procFd_; }      // Linux; -1 when unavailable
+
+private:
+    friend class ProcessAccess;
+    ProcessHandle() = default;
+
+    unsigned int pid_ = 0;
+    unsigned rights_ = 0;
+    uint64_t startTime_ = 0;
+    void* handle_ = nullptr;
+    int procFd_ = -1, pidFd_ = -1;
+};
+
+class ProcessAccess {
+public:
+    enum Rights : unsigned {
+        kRead   = 1,    // query + read memory
+        kWrite  = 2,    // write memory
+        kInject = 4,    // allocate, write and start threads
+    };
+
+    static ProcessAccess& Shared();
+
+    // Cached handle with at least the requested rights, or null when the
+    // process cannot be opened.
+    std::shared_ptr<const ProcessHandle> Open(unsigned int pid, unsigned rights = kRead);
+    // Pooled reader over Open(pid); readers are thread safe and shared by all callers.
+    std::shared_ptr<const ProcessMemory> Memory(unsigned int pid, bool writable = false);
+
+    // Drops the cached entries of pid; holders keep theirs.
+    void Forget(unsigned int pid);
+    size_t Cached() const;
+
+private:
+    struct HandleEntry { std::shared_ptr<const ProcessHandle> h; uint64_t usedNs; };
+    struct MemoryEntry { std::shared_ptr<const ProcessMemory> mem; bool writable; uint64_t usedNs; };
+
+    static std::shared_ptr<const ProcessHandle> OpenHandle(unsigned int pid, unsigned rights);
+    std::shared_ptr<const ProcessHandle> OpenLocked(unsigned int pid, unsigned rights, uint64_t now);   // caller holds mu_
+    void Sweep(uint64_t now);       // caller holds mu_
+
+    mutable std::mutex mu_;
+    std::vector<HandleEntry> handles_;
+    std::vector<MemoryEntry> readers_;
+    uint64_t lastSweepNs_ = 0;
+};
+
+// Reusable batched reader: queue (addr, size) items, then Run() reads them as
+// coalesced spans in one ReadBatch; items of a span that failed are retried one
+// by one. Buffers are kept between runs, so a reader polled every frame does
+// not allocate.
+class BatchReader {
+public:
+    explicit BatchReader(size_t mergeGap = 256) : gap_(mergeGap) {}
+
+    void Clear();
+    // Returns the item index. Items added in ascending address order within
+    // mergeGap of each other share one span.
+    size_t Add(uintptr_t addr, size_t size);
+    // Returns the number of items that could not be read.
+    size_t Run(const IMemorySource& mem);
+
+    size_t Size() const { return items_.size(); }
+    size_t Spans() const { return spans_.size(); }
+    bool Ok(size_t i) const { return items_[i].ok; }
+    const uint8_t* Data(size_t i) const { return buf_.data() + items_[i].off; }
+
+private:
+    struct Item { uintptr_t addr; size_t size, off, span; bool ok; };
+
+    size_t gap_;
+    std::vector<Item> items_;
+    std::vector<ReadSpan> spans_;
+    std::vector<size_t> spanOff_;
+    std::vector<uint8_t> buf_;
+    std::vector<char> failed_;
+};
+
+}} // namespace
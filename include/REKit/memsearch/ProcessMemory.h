@@ -0,0 +1,65 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+#include <memory>
+#include <atomic>
+
+#include "include/REKit/memsearch/MemorySource.h"
+#include "include/REKit/memsearch/ProcessAccess.h"
+
+namespace REKit { namespace MemSearch {
+
+// Access to another process' address space.
+// Windows: process HANDLE + ReadProcessMemory / WriteProcessMemory / VirtualQueryEx.
+// Linux:   process_vm_readv / process_vm_writev + /proc/<pid>/maps.
+// The handle comes from ProcessAccess and is shared with other users of the pid.
+class ProcessMemory : public IMemorySource {
+public:
+    explicit ProcessMemory(unsigned int pid, bool writable = false);
+    explicit ProcessMemory(std::shared_ptr<const ProcessHandle> handle, bool writable = false);
+    ~ProcessMemory();
+    ProcessMemory(const ProcessMemory&) = delete;
+    ProcessMemory& operator=(const ProcessMemory&) = delete;
+
+    bool IsOpen() const override { return open_; }
+    unsigned int Pid() const override { return pid_; }
+    bool Writable() const { return writable_; }
+    const std::shared_ptr<const ProcessHandle>& Handle() const { return handle_; }
+
+    // Returns the number of bytes read, 0 on failure.
+    size_t Read(uintptr_t addr, void* dst, size_t n) const override;
+
+    // Reads every span, in as few system calls as the platform allows.
+    // failed[i] is set for spans that were not read completely; returns the failure count.
+    size_t ReadBatch(const ReadSpan* spans, size_t n, std::vector<char>* failed = nullptr) const override;
+
+    // Writes every span, in as few system calls as the platform allows.
+    // failed[i] is set for spans that were not written completely; returns the failure count.
+    size_t WriteBatch(const WriteSpan* spans, size_t n, std::vector<char>* failed = nullptr) const;
+
+    // Committed, readable regions; clipped to [clipBase, clipEnd) when clipEnd > clipBase.
+    void EnumReadableRegions(std::vector<Region>& out, uintptr_t clipBase = 0, uintptr_t clipEnd = 0) const override;
+
+    // Region containing addr (Windows only); false past the end of the address space.
+    bool QueryRegion(uintptr_t addr, RegionInfo& out) const override;
+
+    // Loaded modules; the main executable comes first.
+    void EnumModules(std::vector<ModuleInfo>& out) const override;
+
+private:
+    // Linux: false once the process has exited; polled at most every
+    // kAliveRecheckNs unless force is set.
+    bool StillAlive(bool force) const;
+    static constexpr uint64_t kAliveRecheckNs = 10000000;
+
+    unsigned int pid_ = 0;
+    bool  open_ = false;
+    bool  writable_ = false;
+    std::shared_ptr<const ProcessHandle> handle_;
+    mutable std::atomic<uint64_t> aliveNs_{0};     // last time Alive() held
+};
+
+}} // namespace
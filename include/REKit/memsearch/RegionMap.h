@@ -0,0 +1,101 @@
+#pragma once
+#include <vector>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+
+#include "include/REKit/memsearch/MemorySource.h"
+
+// Readable address space of one target, kept between scans.
+//
+// The map is a sorted cover of the queried address space: runs of adjacent
+// readable regions coalesced into one, and the gaps between them. Coalesced
+// runs are read with fewer, larger reads.
+//
+// Refresh after the first full walk:
+//   Windows: one query per run, at its base, which must still find the same
+//            first region; each gap is walked again (usually one region). A
+//            span that no longer matches is re-walked. Changes past the first
+//            region of a run go unnoticed until the next full refresh, which
+//            happens every kFullEvery refreshes; the walker skips chunks that
+//            fail to read in between.
+//   Linux:   /proc/<pid>/maps, opened through the process' /proc directory
+//            handle, is read and parsed again only if its content hash changed.
+
+namespace REKit { namespace MemSearch {
+
+struct RegionMapStats {
+    bool     full = false;          // this refresh walked everything
+    bool     unchanged = false;     // nothing had to be re-walked
+    uint64_t queries = 0;           // VirtualQueryEx calls
+    size_t   runs = 0;              // readable runs after coalescing
+    size_t   rawRegions = 0;        // regions the runs were built from
+    uint64_t ns = 0;
+};
+
+class RegionMap {
+public:
+    static constexpr unsigned kFullEvery = 16;
+
+    using QueryFn = std::function<bool(uintptr_t addr, RegionInfo& out)>;
+
+    // Full walk the first time, when full is set and every kFullEvery calls;
+    // incremental otherwise.
+    void Refresh(const IMemorySource& mem, bool full = false, RegionMapStats* stats = nullptr);
+    // Same over any source answering point queries.
+    void Refresh(const QueryFn& query, bool full = false, RegionMapStats* stats = nullptr);
+
+    // Readable runs, clipped to [clipBase, clipEnd) when clipEnd > clipBase.
+    void Regions(std::vector<Region>& out, uintptr_t clipBase = 0, uintptr_t clipEnd = 0) const;
+    bool Valid() const;
+
+private:
+    struct Span {
+        uintptr_t base;
+        size_t    size;
+        bool      readable;
+        uint32_t  parts;    // raw regions coalesced into this span
+        size_t    first;    // size of the first of them
+    };
+
+    static void Walk(const QueryFn& query, uintptr_t lo, uintptr_t hi, std::vector<Span>& out, uint64_t& queries);
+    static void Append(std::vector<Span>& out, const Span& s);
+    void RefreshMaps(const IMemorySource& mem, bool full, RegionMapStats* stats);     // Linux
+    void Count(RegionMapStats* stats) const;
+
+    std::vector<Span> spans_;
+    uint64_t mapsHash_ = 0;
+    unsigned sinceFull_ = 0;
+    bool valid_ = false;
+    mutable std::mutex mu_;
+};
+
+// Region maps of the most recently scanned targets, keyed by pid and process
+// start time, so a process that reuses a pid starts with a new map.
+class RegionMapCache {
+public:
+    static constexpr size_t kMaxTargets = 8;
+    static RegionMapCache& Shared();
+
+    // Refreshes pid's map and copies out its readable runs.
+    void Regions(const IMemorySource& mem, std::vector<Region>& out, uintptr_t clipBase = 0, uintptr_t clipEnd = 0,
+                 RegionMapStats* stats = nullptr);
+    void Forget(unsigned pid);
+    void Clear();
+
+private:
+    struct Entry {
+        unsigned pid;
+        uint64_t startTime;     // 0 for sources without a process handle
+        std::shared_ptr<RegionMap> map;
+    };
+    std::shared_ptr<RegionMap> Get(unsigned pid, uint64_t startTime);
+
+    std::mutex mu_;
+    std::list<Entry> lru_;      // most recent first
+};
+
+}} // namespace
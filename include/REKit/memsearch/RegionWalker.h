@@ -0,0 +1,88 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <functional>
+
+#include "include/REKit/memsearch/MemorySource.h"
+#include "include/REKit/memsearch/ScanStats.h"
+
+namespace REKit { namespace MemSearch {
+
+// A region is cut into stripes, the unit of parallel work. Stripes are
+// address-ordered, so per-stripe outputs concatenated in stripe order stay sorted.
+struct Stripe {
+    size_t    region;   // index into the region list
+    uintptr_t base;
+    size_t    size;
+    uintptr_t limit;    // end of the owning region; overlap reads never cross it
+    const uint8_t* local = nullptr;     // bytes of [base, localEnd) mapped locally, scanned without reads
+    uintptr_t localEnd = 0;
+};
+
+// One chunk handed to the callback. data[0, size) was read from addr;
+// only matches starting in [0, ownedSize) belong to this chunk, the rest is
+// overlap with the next chunk so patterns spanning a chunk boundary are found.
+struct ChunkView {
+    unsigned       worker;
+    size_t         stripe;
+    size_t         region;
+    uintptr_t      addr;
+    const uint8_t* data;
+    size_t         size;
+    size_t         ownedSize;
+};
+
+struct WalkOptions {
+    size_t   chunkSize  = 1 << 16;  // 64KB per read
+    size_t   largeChunkSize = 0;    // reads inside full-size stripes (0 = chunkSize); drops back to chunkSize after a failed read
+    size_t   overlap    = 0;        // extra bytes read past each chunk
+    size_t   stripeSize = 4 << 20;  // 4MB work items
+    unsigned threads    = 0;        // 0 = hardware concurrency
+    ScanStats* stats    = nullptr;  // optional read/compare accounting per worker
+};
+
+// Bytes visited across workers, mirrored into an optional 0..1 progress value.
+struct WalkProgress {
+    size_t total = 0;
+    std::atomic<size_t> done{0};
+    std::atomic<float>* out = nullptr;
+    void Add(size_t n) {
+        size_t d = done.fetch_add(n) + n;
+        if (out && total) *out = (float)d / (float)total;
+    }
+};
+
+using ChunkFn = std::function<void(const ChunkView&)>;
+using StripeDoneFn = std::function<void(size_t stripe)>;
+
+std::vector<Stripe> PlanStripes(const std::vector<Region>& regs, size_t stripeSize);
+
+// Reads every stripe chunk by chunk on a pool of worker threads; a stripe
+// with local bytes is handed over as one chunk without copying.
+// Unreadable chunks are skipped. progress goes 0..1 by bytes visited.
+void WalkStripes(const IMemorySource& mem,
+                 const std::vector<Stripe>& stripes,
+                 const WalkOptions& wo,
+                 std::atomic<bool>& cancel,
+                 std::atomic<float>& progress,
+                 const ChunkFn& fn);
+
+// Same, calling done(stripe) on the worker once the last chunk of a stripe was
+// handed out (or the stripe was abandoned on cancel).
+void WalkStripes(const IMemorySource& mem,
+                 const std::vector<Stripe>& stripes,
+                 const WalkOptions& wo,
+                 std::atomic<bool>& cancel,
+                 std::atomic<float>& progress,
+                 const ChunkFn& fn,
+                 const StripeDoneFn& done);
+
+// Reads a single stripe on the calling thread; buf is the worker's reusable scratch buffer.
+void WalkStripe(const IMemorySource& mem, const Stripe& s, size_t si, const WalkOptions& wo, unsigned worker,
+                std::vector<uint8_t>& buf, std::atomic<bool>& cancel, const ChunkFn& fn, WalkProgress& prog);
+
+unsigned ResolveThreadCount(unsigned requested, size_t workItems);
+
+}} // namespace
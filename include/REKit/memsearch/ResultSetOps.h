@@ -0,0 +1,34 @@
+#pragma once
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+#include "include/REKit/memsearch/ResultStore.h"
+
+// Set algebra over scan results. Scans emit addresses in ascending order
+// without duplicates, and all inputs here must be in that form; outputs are too.
+//
+// Lists of very different sizes are combined by galloping through the larger
+// one, so the cost follows the smaller list; comparable ones by a merge
+// without data-dependent branches.
+
+namespace REKit { namespace MemSearch {
+
+enum class SetOp {
+    Union,
+    Intersect,
+    Difference,     // in a, not in b
+    Near,           // in a, with an entry of b at most window bytes before or after it
+};
+
+void CombineSorted(SetOp op, const uintptr_t* a, size_t na, const uintptr_t* b, size_t nb,
+                   std::vector<uintptr_t>& out, size_t window = 0);
+
+// Same over result stores, read a block at a time so that only out's memory
+// budget limits what stays in RAM; out is cleared first and keeps its budget.
+// False when cancelled or a spilled block could not be read back.
+bool CombineResults(SetOp op, const ResultStore& a, const ResultStore& b, ResultStore& out,
+                    std::atomic<bool>& cancel, std::atomic<float>& progress, size_t window = 0);
+
+}} // namespace
@@ -0,0 +1,66 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+
+namespace REKit { namespace MemSearch {
+
+// Append-only, ordered list of result addresses with a memory budget.
+// Entries are collected into fixed-size blocks; once a block is full it is
+// sealed, and when the in-memory blocks exceed the budget the oldest sealed
+// blocks are written to an anonymous temporary file and streamed back on demand.
+// A failed allocation spills everything instead of throwing std::bad_alloc;
+// if the spill file cannot be written, blocks stay in memory over the budget,
+// and with no memory left either, further results are dropped (Truncated).
+// Readers report allocation failures by returning false.
+class ResultStore {
+public:
+    static constexpr size_t kBlockEntries = 1 << 16; // 512KB per block on x64
+
+    explicit ResultStore(size_t memoryBudget = 0);   // bytes, 0 = unlimited
+    ~ResultStore();
+    ResultStore(ResultStore&&) noexcept;
+    ResultStore& operator=(ResultStore&&) noexcept;
+    ResultStore(const ResultStore&) = delete;
+    ResultStore& operator=(const ResultStore&) = delete;
+
+    void   SetMemoryBudget(size_t bytes);
+    size_t MemoryBudget() const;
+
+    void Clear();
+    void Swap(ResultStore& o) noexcept;
+    void Append(uintptr_t addr) { Append(&addr, 1); }
+    void Append(const uintptr_t* p, size_t n);
+
+    size_t Size() const;
+    bool   Empty() const { return Size() == 0; }
+    size_t BytesInMemory() const;
+    size_t BytesSpilled() const;
+    bool   SpillFailed() const; // spill file could not be written; results were kept in memory past the budget
+    bool   Truncated() const;   // out of memory with nowhere to spill; some results were dropped
+
+    // Random access; reads from the spill file for spilled blocks.
+    uintptr_t Get(size_t i) const;
+
+    // Streams every entry in order, one block at a time. Stop by returning false.
+    // Also false when a spilled block cannot be read back or buffered.
+    using BlockFn = std::function<bool(const uintptr_t* p, size_t n)>;
+    bool ForEachBlock(const BlockFn& fn) const;
+
+    // Block-granular access for parallel consumers; block i holds entries
+    // [i * kBlockEntries, ...). ReadBlock copies the block into out; false
+    // (out empty) when it cannot be read or allocated.
+    size_t BlockCount() const;
+    bool   ReadBlock(size_t i, std::vector<uintptr_t>& out) const;
+
+    // Every entry; false (out empty) when they cannot all be read or held.
+    bool ToVector(std::vector<uintptr_t>& out) const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+}} // namespace
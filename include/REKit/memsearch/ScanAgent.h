@@ -0,0 +1,79 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+#include "include/REKit/memsearch/MemorySource.h"
+#include "include/REKit/memsearch/ScanPlan.h"
+
+// Scan agent: a small library loaded into the target (agent/ScanAgent.cpp;
+// LD_PRELOAD on Linux, the Injector plugin on Windows) that scans the target's
+// memory in place and streams hits back, so a first scan costs no
+// cross-process reads at all.
+//
+// The agent publishes one shared-memory block per process:
+//   Linux:   shm_open("/rekit-agent-<pid>")
+//   Windows: "Local\REKitAgent<pid>" file mapping
+// holding a request/reply slot, a data window for reads and region lists, and
+// a single-producer ring of hit addresses. Requests are served one at a time
+// by a thread of the agent; a heartbeat counter tells a live agent from a
+// stale block.
+//
+// In-target scans use the same FirstScanPlan as the engine, over the agent's
+// own readable regions minus the shared block. Faults on memory unmapped
+// during the scan skip the rest of that stripe instead of crashing the target.
+// The agent's own working set (its copy of the search value) is part of the
+// target, so a hit or two in it is expected.
+
+namespace REKit { namespace MemSearch {
+
+struct AgentShared;
+
+// Client end. Also a plain memory source: reads go through the data window.
+class ScanAgentClient : public IMemorySource {
+public:
+    ScanAgentClient() = default;
+    ~ScanAgentClient();
+    ScanAgentClient(const ScanAgentClient&) = delete;
+    ScanAgentClient& operator=(const ScanAgentClient&) = delete;
+
+    // Attaches to the agent running in pid; false when none answers.
+    bool Connect(unsigned int pid);
+    void Disconnect();
+
+    bool IsOpen() const override { return sh_ != nullptr; }
+    unsigned int Pid() const override { return pid_; }
+    size_t Read(uintptr_t addr, void* dst, size_t n) const override;
+    void EnumReadableRegions(std::vector<Region>& out, uintptr_t clipBase = 0, uintptr_t clipEnd = 0) const override;
+
+    // Scan types the agent runs in place (everything but Group).
+    static bool Supports(const ScanOptions& opt);
+
+    // First scan inside the target; hits reach sink in ascending order.
+    // Returns false if the agent could not run it or stopped answering;
+    // status says why.
+    bool FirstScan(const ScanOptions& opt, const HitSink& sink, std::atomic<bool>& cancel,
+                   std::atomic<float>& progress, std::string& status, ScanStats* stats = nullptr) const;
+
+private:
+    bool Call(uint32_t op, uint64_t arg0, uint64_t arg1) const;   // caller holds *mu_
+    bool Wait(uint32_t seq) const;
+    bool Alive(uint64_t& beat, uint64_t& since) const;
+
+    AgentShared* sh_ = nullptr;
+    void* mapping_ = nullptr;       // HANDLE on Windows
+    unsigned int pid_ = 0;
+    std::shared_ptr<std::mutex> mu_;    // one request at a time per agent, shared by clients in this process
+};
+
+// Agent end, called by the agent library: publishes the shared block of the
+// current process and serves requests on a background thread. In a forked
+// child both leave the parent's block alone.
+bool StartScanAgent();
+void StopScanAgent();
+
+}} // namespace
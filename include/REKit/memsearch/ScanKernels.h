@@ -0,0 +1,33 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+#include "include/REKit/memsearch/MemSearchEngine.h"
+
+// Buffer-level scan kernels shared by MemSearchEngine and the benchmarks.
+// No platform or UI dependencies.
+
+namespace REKit { namespace MemSearch {
+
+// Parse hex with optional spaces and '?' nibble wildcards into pattern+mask.
+bool ParseHexWithMask(const std::string& src, std::vector<uint8_t>& pat, std::vector<uint8_t>& mask);
+
+// Both kernels report matches starting in buf[0, owned) only; bytes past owned
+// (up to n) are the chunk overlap, read so matches may run into it.
+
+// Appends baseAddr + i for every aligned offset i where buf matches pat under mask.
+void SearchBufferMasked(const uint8_t* buf, size_t n, size_t owned, const uint8_t* pat, const uint8_t* mask, size_t m,
+                        size_t alignment, uintptr_t baseAddr, std::vector<uintptr_t>& out);
+
+// Value / string match of type t against the inputs in opt. Utf16 matches
+// strExpr widened to UTF-16LE, one code unit per byte.
+void SearchBufferValue(const uint8_t* buf, size_t n, size_t owned, ScanType t, const ScanOptions& opt,
+                       uintptr_t baseAddr, std::vector<uintptr_t>& out);
+
+// Length in bytes of a match of type t (0 for Bytes and Group, whose length
+// comes from the pattern).
+size_t ValueMatchSize(ScanType t, const ScanOptions& opt);
+
+}} // namespace
@@ -0,0 +1,87 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <mutex>
+#include <memory>
+#include <atomic>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+
+#include "include/REKit/memsearch/MemSearchEngine.h"
+#include "include/REKit/memsearch/RegionWalker.h"
+#include "include/REKit/memsearch/GroupScan.h"
+#include "include/REKit/memsearch/SigProgram.h"
+#include "include/REKit/memsearch/ModuleImage.h"
+#include "include/REKit/memsearch/RegionMap.h"
+
+namespace REKit { namespace MemSearch {
+
+// Receives hits in ascending address order.
+using HitSink = std::function<void(const uintptr_t* p, size_t n)>;
+
+// The source a scan reads: opt.source when set, otherwise the live process opt.pid.
+std::shared_ptr<const IMemorySource> OpenScanSource(const ScanOptions& opt);
+
+// A first scan broken into independent stripes: regions, walk options and the
+// parsed pattern for one ScanOptions. Match() is safe to call from any worker.
+class FirstScanPlan {
+public:
+    // Enumerates regions and parses the pattern. On failure status says why.
+    bool Prepare(const IMemorySource& mem, const ScanOptions& opt, std::string& status, ScanStats* stats);
+
+    const std::vector<Stripe>& Stripes() const { return stripes_; }
+    const WalkOptions& Walk() const { return wo_; }
+    size_t TotalBytes() const { return totalBytes_; }
+
+    void Match(const ChunkView& v, std::vector<uintptr_t>& out) const;
+
+private:
+    ScanOptions opt_;
+    std::vector<uint8_t> pat_, mask_;
+    GroupMatcher group_;
+    SigProgram sig_;            // Bytes pattern using the extended signature syntax
+    bool useSig_ = false;
+    ModuleImageSet images_;     // keeps the mappings local stripes point into
+    WalkOptions wo_;
+    std::vector<Stripe> stripes_;
+    size_t totalBytes_ = 0;
+};
+
+// Re-check of previous results against a value, a batch of addresses at a time.
+class NextScanFilter {
+public:
+    bool Prepare(const ScanOptions& opt);
+
+    // Appends the addresses that still match to kept. Stops early on cancel.
+    void Filter(const IMemorySource& mem, const uintptr_t* addrs, size_t n, std::vector<uintptr_t>& kept,
+                std::atomic<bool>& cancel, WalkProgress& prog, ScanThreadStats* st) const;
+
+private:
+    ScanOptions opt_;
+    size_t valueSize_ = 1;
+    std::vector<uint8_t> pat_, mask_;   // Bytes pattern, or the widened Utf16 string
+    GroupMatcher group_;
+    SigProgram sig_;
+    bool useSig_ = false;
+};
+
+// Per-work-item hit buffers released to a sink in item order: an item's hits
+// go out once it and every item before it are finished, so only items in
+// flight are buffered.
+class OrderedCommitter {
+public:
+    void Reset(size_t items);
+    std::vector<uintptr_t>& Slot(size_t i) { return hits_[i]; }
+    void Finish(size_t i, const HitSink& sink);
+    void FinishAll(const HitSink& sink);     // on cancel, items behind an unfinished one are still pending
+
+private:
+    void FlushLocked(const HitSink& sink);
+    std::vector<std::vector<uintptr_t>> hits_;
+    std::vector<char> finished_;
+    size_t commit_ = 0;
+    std::mutex mu_;
+};
+
+}} // namespace
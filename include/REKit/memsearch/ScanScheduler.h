@@ -0,0 +1,128 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <map>
+#include <cstdint>
+
+#include "include/REKit/memsearch/MemSearchEngine.h"
+#include "include/REKit/memsearch/ScanPlan.h"
+#include "include/REKit/memsearch/ScanAgent.h"
+
+namespace REKit { namespace MemSearch {
+
+class ScanScheduler;
+
+// One queued scan. Poll it from the UI; Results() is complete once Done().
+class ScanJob {
+public:
+    unsigned Pid() const { return opt_.pid; }
+    int      Priority() const { return priority_; }
+    bool     Done() const { return done_; }
+    float    Progress() const { return progress_; }
+    std::string Status() const;
+
+    void Cancel();
+    void Wait();
+
+    ResultStore& Results() { return results_; }
+    const ScanStats& Stats() const { return stats_; }
+
+private:
+    friend class ScanScheduler;
+    enum class Kind { First, Next };
+
+    Kind kind_ = Kind::First;
+    ScanOptions opt_;
+    int priority_ = 1;
+    uint64_t seq_ = 0;
+    ScanScheduler* owner_ = nullptr;
+
+    // scheduler state, guarded by the scheduler mutex
+    uint64_t pass_ = 0;         // stride-scheduling virtual time
+    uint64_t stride_ = 0;
+    bool     prepared_ = false;
+    bool     preparing_ = false;
+    bool     failed_ = false;
+    bool     finalizing_ = false;
+    size_t   items_ = 0;
+    size_t   next_ = 0;
+    size_t   inFlight_ = 0;
+    const void* target_ = nullptr;  // live process source whose reads count against ioPerTarget
+
+    std::shared_ptr<const IMemorySource> mem_;
+    std::unique_ptr<ScanAgentClient> agent_;  // first scan runs in the target as a single item
+    FirstScanPlan plan_;
+    NextScanFilter filter_;
+    ResultStore prev_;
+    OrderedCommitter committer_;
+    WalkProgress walk_;
+    HitSink sink_;
+
+    ResultStore results_;
+    ScanStats stats_;
+    std::atomic<bool>  cancel_{false};
+    std::atomic<float> progress_{0.f};
+    std::atomic<bool>  done_{false};
+    mutable std::mutex mu_;
+    std::condition_variable doneCv_;
+    std::string status_;
+};
+
+// Shared worker pool for scans of any number of targets. Jobs are split into
+// stripes (first scan) or result blocks (next scan) and workers pick the next
+// item by stride scheduling, so jobs progress in proportion to their priority
+// and a big scan cannot starve a small one. Each live process has a cap on
+// items in flight so several jobs on it do not pile reads onto it; items that
+// read no process memory (core dumps, snapshots, stripes backed by module
+// files) are not capped. The pool leaves one core for the UI thread.
+class ScanScheduler {
+public:
+    struct Config {
+        unsigned workers = 0;       // 0 = hardware concurrency - 1 (at least 1); at most ScanStats::kMaxThreads
+        unsigned ioPerTarget = 0;   // max items reading one process at a time; 0 = all workers
+    };
+
+    ScanScheduler();
+    explicit ScanScheduler(const Config& cfg);
+    ~ScanScheduler();
+    ScanScheduler(const ScanScheduler&) = delete;
+    ScanScheduler& operator=(const ScanScheduler&) = delete;
+
+    static ScanScheduler& Shared();
+
+    // priority 1..100, higher gets proportionally more worker time
+    std::shared_ptr<ScanJob> SubmitFirstScan(const ScanOptions& opt, int priority = 10);
+    std::shared_ptr<ScanJob> SubmitNextScan(const ScanOptions& opt, ResultStore&& prev, int priority = 10);
+
+    unsigned Workers() const { return (unsigned)workers_.size(); }
+    size_t   ActiveJobs() const;
+
+private:
+    friend class ScanJob;
+    std::shared_ptr<ScanJob> Submit(std::shared_ptr<ScanJob> job, int priority);
+    void WorkerLoop(unsigned wid);
+    std::shared_ptr<ScanJob> PickLocked();
+    const void* TargetLocked(const ScanJob& j) const;
+    bool FinishedLocked(const ScanJob& j) const;
+    void Prepare(ScanJob& j);
+    void RunItem(ScanJob& j, size_t item, unsigned wid, std::vector<uint8_t>& buf, std::vector<uintptr_t>& tmp);
+    void Finalize(ScanJob& j);
+    void Wake();
+
+    Config cfg_;
+    mutable std::mutex mu_;
+    std::condition_variable cv_;
+    std::vector<std::shared_ptr<ScanJob>> jobs_;
+    std::map<const void*, unsigned> inFlightPerTarget_;
+    std::vector<std::thread> workers_;
+    uint64_t vtime_ = 0;
+    uint64_t seq_ = 0;
+    bool stop_ = false;
+};
+
+}} // namespace
@@ -0,0 +1,70 @@
+#pragma once
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace REKit { namespace MemSearch {
+
+// Hot-path scan counters. Each worker owns one cache-line sized slot and is its
+// only writer, so updates are plain relaxed load+store (no locked RMW, no false
+// sharing). Pools that record stats therefore run at most ScanStats::kMaxThreads
+// workers. Snapshot() may be called from any thread while a scan is running.
+struct alignas(64) ScanThreadStats {
+    std::atomic<uint64_t> bytesRequested{0};
+    std::atomic<uint64_t> bytesRead{0};
+    std::atomic<uint64_t> readCalls{0};
+    std::atomic<uint64_t> readFailures{0};
+    std::atomic<uint64_t> bytesMapped{0};   // scanned in place from mapped module files
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> readNs{0};
+    std::atomic<uint64_t> compareNs{0};
+
+    static void Add(std::atomic<uint64_t>& c, uint64_t v) {
+        c.store(c.load(std::memory_order_relaxed) + v, std::memory_order_relaxed);
+    }
+};
+
+struct ScanThreadTotals {
+    unsigned thread = 0;
+    uint64_t bytesRequested = 0, bytesRead = 0;
+    uint64_t readCalls = 0, readFailures = 0;
+    uint64_t bytesMapped = 0;
+    uint64_t hits = 0;
+    uint64_t readNs = 0, compareNs = 0;
+};
+
+struct ScanStatsSnapshot {
+    ScanThreadTotals total;                 // sum over threads (total.thread unused)
+    uint64_t enumerateNs = 0;
+    uint64_t wallNs = 0;                    // so far, if still running
+    bool     running = false;
+    std::vector<ScanThreadTotals> perThread; // threads that did any work
+};
+
+class ScanStats {
+public:
+    static constexpr unsigned kMaxThreads = 64;
+
+    void Reset();
+    void Begin();   // Reset() + start the wall clock
+    void End();
+
+    ScanThreadStats& Thread(unsigned worker) { return threads_[worker % kMaxThreads]; }
+    void AddEnumerate(uint64_t ns) { ScanThreadStats::Add(enumerateNs_, ns); }
+
+    ScanStatsSnapshot Snapshot() const;
+
+    static uint64_t NowNs() {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+private:
+    ScanThreadStats threads_[kMaxThreads];
+    std::atomic<uint64_t> enumerateNs_{0};
+    std::atomic<uint64_t> beginNs_{0};
+    std::atomic<uint64_t> endNs_{0};
+};
+
+}} // namespace
@@ -0,0 +1,103 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <map>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+#include "include/REKit/memsearch/MemorySource.h"
+#include "include/REKit/memsearch/SigProgram.h"
+
+// Signature database and resolver.
+//
+//   # comment
+//   [client.dll]                    entries below are scoped to this module (file name, any case)
+//   GetTls   = 48 8B 05 $off:4 48 85 C0
+//   Dispatch = 40 53 48 83 EC 20 [0-8] (E8|E9) $rel:4
+//   [*]                             the main executable; also the scope before any section
+//   Main     = 55 48 89 E5
+//
+// Patterns use the SigProgram syntax. Hits are cached per (module content
+// hash, signature id); the id covers module and pattern, so an edited entry
+// is resolved again while renaming one is not.
+
+namespace REKit { namespace MemSearch {
+
+struct SigEntry {
+    std::string name;
+    std::string module;         // "*" for the main executable
+    std::string pattern;
+    uint64_t    id = 0;
+    SigProgram  prog;
+};
+
+class SigDatabase {
+public:
+    // Load replaces the contents; Parse appends. Errors name the line.
+    bool Load(const std::string& path, std::string* error = nullptr);
+    bool Parse(const std::string& text, std::string* error = nullptr);
+    bool Add(const std::string& name, const std::string& module, const std::string& pattern, std::string* error = nullptr);
+    void Clear() { entries_.clear(); }
+
+    size_t Size() const { return entries_.size(); }
+    const SigEntry& At(size_t i) const { return entries_[i]; }
+    int Find(const std::string& name) const;
+
+private:
+    std::vector<SigEntry> entries_;
+};
+
+// Persistent hits keyed by (module content hash, signature id), stored
+// module-relative so they survive ASLR. Content hashes of module files are
+// memoized by (path, size, mtime), so an unchanged module is not even read.
+class SigCache {
+public:
+    bool Load(const std::string& path);
+    bool Save(const std::string& path) const;
+    void Clear() { files_.clear(); hits_.clear(); dirty_ = false; }
+    bool Dirty() const { return dirty_; }
+    size_t Size() const { return hits_.size(); }
+
+    bool Lookup(uint64_t moduleHash, uint64_t sigId, SigHits& rel) const;
+    void Store(uint64_t moduleHash, uint64_t sigId, const SigHits& rel);
+
+    // Content hash of the file at path; false if it cannot be read.
+    bool FileHash(const std::string& path, uint64_t& hash);
+
+private:
+    struct FileMemo { uint64_t size = 0, mtime = 0, hash = 0; };
+    std::map<std::string, FileMemo> files_;
+    std::map<std::pair<uint64_t, uint64_t>, SigHits> hits_;
+    bool dirty_ = false;
+};
+
+struct SigResolved {
+    const SigEntry* entry = nullptr;
+    bool      moduleFound = false;
+    bool      fromCache = false;
+    uintptr_t moduleBase = 0;
+    SigHits   hits;             // absolute addresses
+};
+
+struct SigResolveStats {
+    size_t   modules = 0;           // modules with at least one entry in scope
+    size_t   modulesScanned = 0;
+    size_t   cacheHits = 0;
+    size_t   cacheMisses = 0;
+    uint64_t bytesScanned = 0;
+    uint64_t hashNs = 0;
+    uint64_t scanNs = 0;
+};
+
+// Resolves every entry of db against mem, one entry per db index in out.
+// A module whose file can be mapped is searched in its read-only sections
+// only, minus the pages the loader writes (see ModuleImage), so a hit and its
+// captures do not depend on the load address and can be cached. A module
+// without a readable file is searched in its whole live image and is never
+// cached. Cached entries are not scanned; the misses of one module share a
+// single SigProgramSet pass. cache may be null.
+void ResolveSignatures(const IMemorySource& mem, const SigDatabase& db, SigCache* cache,
+                       std::vector<SigResolved>& out, SigResolveStats* stats = nullptr, unsigned threads = 0);
+
+}} // namespace
@@ -0,0 +1,121 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+
+#include "include/REKit/memsearch/MemorySource.h"
+
+// Extended signature language, compiled to matcher bytecode.
+//
+//   48 8B 05 $off:4 48 85 C0 [2-6] (E8|E9) $rel:4 {70-7F}
+//
+//   48  4?  ??  ?       byte, nibble wildcard, any byte ("?" == "??")
+//   488B05              hex runs without spaces split into bytes, as in ParseHexWithMask
+//   [4]  [4-8]          fixed / variable gap of any bytes (at most kMaxGap)
+//   (E8|E9|0?)          one byte out of a set; alternatives may use nibble wildcards
+//   {70-7F}             one byte in an inclusive range
+//   $name:4             named capture: 1..8 any bytes, returned little-endian with each hit
+//   $name               named capture of the current offset only
+//
+// The longest literal run at a fixed offset from the start drives an SSE2
+// first/last-byte prefilter; the bytecode only runs at its candidates.
+
+namespace REKit { namespace MemSearch {
+
+struct SigCaptureValue {
+    uint32_t offset;    // from the hit address
+    uint64_t value;     // little-endian, 0 for offset-only captures
+};
+
+// Hits of one SigProgram; every hit has CaptureCount() capture slots.
+struct SigHits {
+    size_t captureCount = 0;
+    std::vector<uintptr_t> addrs;
+    std::vector<uint32_t>  lengths;
+    std::vector<SigCaptureValue> captures;      // addrs.size() * captureCount
+
+    size_t Size() const { return addrs.size(); }
+    const SigCaptureValue* Captures(size_t hit) const { return captures.data() + hit * captureCount; }
+    void Clear() { addrs.clear(); lengths.clear(); captures.clear(); }
+    void Append(const SigHits& o);
+};
+
+class SigProgram {
+public:
+    static constexpr size_t kMaxGap = 1024;
+    static constexpr size_t kMaxLength = 4096;
+
+    bool Compile(const std::string& src, std::string* error = nullptr);
+
+    // True if src uses anything beyond ParseHexWithMask syntax.
+    static bool IsExtended(const std::string& src);
+
+    size_t MinLength() const { return minLen_; }
+    size_t MaxLength() const { return maxLen_; }
+    size_t CaptureCount() const { return capNames_.size(); }
+    const std::string& CaptureName(size_t i) const { return capNames_[i]; }
+    int    CaptureIndex(const std::string& name) const;
+    size_t CodeSize() const { return code_.size(); }
+
+    // Prefilter literal and its offset from the match start; empty if no literal is at a fixed offset.
+    const std::vector<uint8_t>& Literal() const { return lit_; }
+    size_t LiteralOffset() const { return litOff_; }
+
+    // Hits starting in buf[0, owned), in ascending order. buf must extend
+    // MaxLength() - 1 bytes past owned (or to the end of the region).
+    void Search(const uint8_t* buf, size_t n, size_t owned, uintptr_t baseAddr, SigHits& out, size_t alignment = 1) const;
+    void Search(const uint8_t* buf, size_t n, size_t owned, uintptr_t baseAddr, std::vector<uintptr_t>& out, size_t alignment = 1) const;
+
+    // Match starting exactly at p. caps needs CaptureCount() slots (may be null if there are none).
+    bool MatchAt(const uint8_t* p, size_t n, uint32_t* length = nullptr, SigCaptureValue* caps = nullptr) const;
+
+private:
+    enum Op : uint8_t { OpEnd, OpLit, OpMask, OpSkip, OpSet, OpGap, OpCap };
+
+    bool Exec(size_t pc, const uint8_t* p, size_t pos, size_t n, uint32_t& len, SigCaptureValue* caps) const;
+    template <class Fn> void Candidates(const uint8_t* buf, size_t n, size_t owned, Fn&& fn) const;
+
+    std::vector<uint8_t> code_;
+    std::vector<uint8_t> sets_;             // 32-byte bitmaps for OpSet
+    std::vector<std::string> capNames_;
+    size_t minLen_ = 0, maxLen_ = 0;
+    // prefilter literal, at a fixed offset from the match start
+    std::vector<uint8_t> lit_;
+    size_t litOff_ = 0;
+};
+
+// Many programs matched in one pass over a buffer. Programs are bucketed by
+// the first two bytes of their prefilter literal, and a 64K-bit table keyed
+// on the same two bytes rejects almost every position with a single load.
+// Programs whose literal is shorter than two bytes are searched on their own.
+class SigProgramSet {
+public:
+    // fn(index, addr, length, caps) per hit; hits of one program come in ascending order.
+    using HitFn = std::function<void(size_t index, uintptr_t addr, uint32_t length, const SigCaptureValue* caps)>;
+
+    void Clear();
+    size_t Add(const SigProgram* prog);     // not owned; returns its index
+    void Build();                           // after the last Add, before Search
+    size_t Size() const { return progs_.size(); }
+    size_t MaxLength() const { return maxLen_; }
+
+    // Hits starting in buf[0, owned); buf must extend MaxLength() - 1 bytes past owned.
+    void Search(const uint8_t* buf, size_t n, size_t owned, uintptr_t baseAddr, const HitFn& fn) const;
+
+private:
+    std::vector<const SigProgram*> progs_;
+    std::vector<uint64_t> bits_;            // 65536 bits, key = first two literal bytes
+    std::vector<uint32_t> start_;           // 65537 bucket offsets into bucket_
+    std::vector<uint32_t> bucket_;          // program indices grouped by key
+    std::vector<uint32_t> alone_;           // programs without a two-byte literal
+    size_t maxLen_ = 0, maxLitOff_ = 0, maxCaps_ = 0;
+};
+
+// Scans [base, base + length) of mem (every readable region if length is 0)
+// on the region walker's pool. Hits come back sorted, with captures.
+void ScanSigProgram(const IMemorySource& mem, const SigProgram& prog, uintptr_t base, size_t length,
+                    SigHits& out, size_t alignment = 1, unsigned threads = 0);
+
+}} // namespace
@@ -0,0 +1,169 @@
+#pragma once
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+#include "include/REKit/memsearch/RegionWalker.h"
+
+// Compile-time signatures.
+//
+//   constexpr auto kGetTls = REKIT_SIG("48 8B 05 ?? ?? ?? ?? 48 85 C0");
+//   std::vector<uintptr_t> hits;
+//   REKit::MemSearch::SearchSignature(kGetTls, buf, n, base, hits);
+//
+// Same grammar as ParseHexWithMask: whitespace is ignored, every two
+// characters form a byte, '?' is a wildcard nibble. The hex is parsed and
+// validated by the compiler; a malformed signature fails the build with the
+// name of one of the Sig* functions below in the error. The result is a
+// Signature<N, A> whose length N and anchor byte A are template parameters,
+// so SearchSignature is instantiated per shape: memchr on the anchor byte,
+// then a fully unrolled masked compare.
+
+namespace REKit { namespace MemSearch {
+
+namespace sig_detail {
+
+// Not constexpr on purpose: reaching one during constant evaluation is the error.
+inline void SigErrorBadHexDigit() {}
+inline void SigErrorOddNibbleCount() {}
+inline void SigErrorEmpty() {}
+inline void SigErrorAllWildcards() {}
+
+constexpr bool IsSpace(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+
+constexpr int Nibble(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return 10 + (c - 'a');
+    if (c >= 'A' && c <= 'F') return 10 + (c - 'A');
+    if (c == '?') return -1;
+    return (SigErrorBadHexDigit(), -2);
+}
+
+// Same ranking as the group-scan anchor: zero and 0xFF fill most memory.
+constexpr int ByteWeight(uint8_t b) {
+    return b == 0x00 ? 1 : b == 0xFF ? 2 : b < 0x10 ? 3 : 8;
+}
+
+template <size_t L>
+constexpr size_t Length(const char (&s)[L]) {
+    size_t nibbles = 0;
+    for (size_t i = 0; i + 1 < L; ++i) {
+        if (IsSpace(s[i])) continue;
+        Nibble(s[i]);
+        ++nibbles;
+    }
+    if (nibbles == 0) SigErrorEmpty();
+    if (nibbles % 2) SigErrorOddNibbleCount();
+    return nibbles / 2;
+}
+
+template <size_t N>
+struct Parsed {
+    uint8_t pat[N] = {};
+    uint8_t mask[N] = {};
+    size_t  anchor = 0;
+};
+
+template <size_t N, size_t L>
+constexpr Parsed<N> Parse(const char (&s)[L]) {
+    Parsed<N> p;
+    size_t k = 0;
+    int hi = -3;
+    for (size_t i = 0; i + 1 < L; ++i) {
+        if (IsSpace(s[i])) continue;
+        int v = Nibble(s[i]);
+        if (hi == -3) { hi = v; continue; }
+        uint8_t m = 0xFF, b = 0;
+        if (hi >= 0) b = (uint8_t)(hi << 4); else m &= 0x0F;
+        if (v >= 0)  b |= (uint8_t)v;        else m &= 0xF0;
+        p.pat[k] = b; p.mask[k] = m;
+        ++k;
+        hi = -3;
+    }
+    int best = -1;
+    for (size_t i = 0; i < N; ++i) {
+        if (p.mask[i] != 0xFF) continue;
+        if (best < 0 || ByteWeight(p.pat[i]) > ByteWeight(p.pat[(size_t)best])) best = (int)i;
+    }
+    if (best < 0) SigErrorAllWildcards();
+    p.anchor = (size_t)best;
+    return p;
+}
+
+} // namespace sig_detail
+
+// N bytes of pattern and mask; A is the fully specified byte searched with memchr.
+template <size_t N, size_t A>
+struct Signature {
+    static_assert(N > 0 && A < N, "bad signature shape");
+    static constexpr size_t kSize = N;
+    static constexpr size_t kAnchor = A;
+    uint8_t pat[N] = {};
+    uint8_t mask[N] = {};
+
+    constexpr Signature() = default;
+    constexpr explicit Signature(const sig_detail::Parsed<N>& p) {
+        for (size_t i = 0; i < N; ++i) { pat[i] = p.pat[i]; mask[i] = p.mask[i]; }
+    }
+};
+
+#define REKIT_SIG(str) ([]() {                                                                   \
+        constexpr size_t rekitN_ = ::REKit::MemSearch::sig_detail::Length(str);                  \
+        constexpr auto rekitP_ = ::REKit::MemSearch::sig_detail::Parse<rekitN_>(str);            \
+        constexpr ::REKit::MemSearch::Signature<rekitN_, rekitP_.anchor> rekitS_(rekitP_);       \
+        return rekitS_;                                                                          \
+    }())
+
+namespace sig_detail {
+
+template <size_t N, size_t A, size_t I = 0>
+inline bool MatchRest(const Signature<N, A>& s, const uint8_t* p) {
+    if constexpr (I == N) return true;
+    else if constexpr (I == A) return MatchRest<N, A, I + 1>(s, p);
+    else return (p[I] & s.mask[I]) == s.pat[I] && MatchRest<N, A, I + 1>(s, p);
+}
+
+} // namespace sig_detail
+
+// Appends baseAddr + i for every aligned offset i where buf matches sig.
+template <size_t N, size_t A>
+void SearchSignature(const Signature<N, A>& sig, const uint8_t* buf, size_t n, uintptr_t baseAddr,
+                     std::vector<uintptr_t>& out, size_t alignment = 1) {
+    if (n < N) return;
+    const uint8_t key = sig.pat[A];
+    const uint8_t* p = buf + A;
+    const uint8_t* end = buf + (n - N) + A + 1;
+    while (p < end) {
+        const uint8_t* q = (const uint8_t*)memchr(p, key, (size_t)(end - p));
+        if (!q) break;
+        const uint8_t* start = q - A;
+        if ((alignment <= 1 || (baseAddr + (uintptr_t)(start - buf)) % alignment == 0) && sig_detail::MatchRest(sig, start))
+            out.push_back(baseAddr + (uintptr_t)(start - buf));
+        p = q + 1;
+    }
+}
+
+// Scans [base, base + length) of mem (every readable region if length is 0)
+// for sig on the region walker's thread pool. Results come back sorted.
+template <size_t N, size_t A>
+void ScanSignature(const IMemorySource& mem, const Signature<N, A>& sig, uintptr_t base, size_t length,
+                   std::vector<uintptr_t>& out, size_t alignment = 1, unsigned threads = 0) {
+    std::vector<Region> regs;
+    mem.EnumReadableRegions(regs, length ? base : 0, length ? base + length : 0);
+    WalkOptions wo;
+    wo.overlap = N - 1;
+    wo.threads = threads;
+    std::vector<Stripe> stripes = PlanStripes(regs, wo.stripeSize);
+    std::vector<std::vector<uintptr_t>> hits(stripes.size());
+    std::atomic<bool> cancel{false};
+    std::atomic<float> progress{0.f};
+    WalkStripes(mem, stripes, wo, cancel, progress, [&](const ChunkView& v) {
+        SearchSignature(sig, v.data, v.size, v.addr, hits[v.stripe], alignment);
+    });
+    for (auto& h : hits) out.insert(out.end(), h.begin(), h.end());
+}
+
+}} // namespace
@@ -0,0 +1,57 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+#include "include/REKit/memsearch/MemorySource.h"
+
+// Whole-address-space diff: which bytes changed between two memory sources,
+// typically two PageSnapshots (T0, T1) or a snapshot and the live process.
+//
+// Only addresses readable in both are compared. The common ranges are cut
+// into 4MB work items compared on a pool of threads in 64-byte blocks (SSE2
+// where available). When both sides are PageSnapshots of one PageStore, pages
+// with the same id are skipped without being read or decompressed.
+
+namespace REKit { namespace MemSearch {
+
+struct DiffRange { uintptr_t addr; size_t size; };
+
+struct DiffOptions {
+    size_t   mergeGap = 0;      // ranges separated by at most this many equal bytes are merged
+    unsigned threads  = 0;      // 0 = hardware concurrency
+};
+
+struct DiffStats {
+    uint64_t bytes = 0;         // common bytes
+    uint64_t sameIdBytes = 0;   // skipped by page id
+    uint64_t comparedBytes = 0;
+    uint64_t changedBytes = 0;  // in the output ranges, gaps included
+    uint64_t ranges = 0;
+    uint64_t unreadBytes = 0;   // common bytes one side failed to read
+    uint64_t ns = 0;
+};
+
+// Changed ranges between before and after, ascending and disjoint. Returns
+// false when cancelled (out then holds what was found so far, unsorted).
+bool DiffMemory(const IMemorySource& before, const IMemorySource& after, std::vector<DiffRange>& out,
+                std::atomic<bool>& cancel, std::atomic<float>& progress,
+                const DiffOptions& opt = DiffOptions(), DiffStats* stats = nullptr);
+
+// Before/after of a changed range, decoded by a guess at its type: a range
+// inside one aligned 4- or 8-byte slot is read as an integer or float over
+// that slot, anything larger as bytes (the first 16 shown).
+enum class DiffType { Bytes, Int32, Float, Int64, Double };
+
+struct DiffValue {
+    uintptr_t   addr;       // start of the decoded slot
+    size_t      size;
+    DiffType    type;
+    std::string before, after;
+};
+
+DiffValue DecodeDiff(const IMemorySource& before, const IMemorySource& after, const DiffRange& r);
+
+}} // namespace
@@ -0,0 +1,112 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <cstdint>
+
+#include "include/REKit/memsearch/MemSearchEngine.h"
+
+namespace REKit { namespace MemSearch {
+
+struct WatchSample {
+    uint64_t timeNs;    // ScanStats::NowNs() clock
+    uint64_t raw;       // value bytes, zero-extended
+};
+
+// Public view of one watched address.
+struct WatchInfo {
+    uint64_t  id = 0;
+    uintptr_t addr = 0;
+    ScanType  type = ScanType::Int32;
+    size_t    size = 0;
+    bool      valid = false;        // last poll read the value
+    uint64_t  raw = 0;              // last value
+    double    value = 0, min = 0, max = 0;
+    uint64_t  changes = 0;
+    uint64_t  lastChangeNs = 0;     // 0 = never changed since added
+    size_t    samples = 0;          // entries in the history ring
+};
+
+struct WatchStats {
+    uint64_t polls = 0;
+    uint64_t pages = 0;             // distinct pages in the current layout
+    uint64_t readCalls = 0;         // ReadBatch spans issued, summed over polls
+    uint64_t readFailures = 0;      // pages still unreadable after a failed span was retried page by page
+    uint64_t pollAvgNs = 0;
+    uint64_t pollMaxNs = 0;
+};
+
+// Polls a set of addresses at a fixed rate. Watched addresses are grouped by
+// page and adjacent pages merged into one read, all issued through a single
+// ReadBatch per poll, so the cost follows the number of distinct pages rather
+// than the number of entries. Each entry keeps a fixed-size ring of samples;
+// a sample is appended only when the value changes.
+class WatchList {
+public:
+    static constexpr size_t kHistory = 256;     // samples per entry
+
+    WatchList();
+    ~WatchList();
+    WatchList(const WatchList&) = delete;
+    WatchList& operator=(const WatchList&) = delete;
+
+    bool Start(unsigned pid, unsigned rateHz = 20);
+    void Stop();
+    bool Running() const { return running_; }
+    unsigned Pid() const { return pid_; }
+
+    void     SetRate(unsigned rateHz);
+    unsigned Rate() const { return rateHz_; }
+
+    // size is taken from type for numeric types; values wider than 8 bytes are not supported.
+    uint64_t Add(uintptr_t addr, ScanType type, size_t size = 0);
+    bool     Remove(uint64_t id);
+    void     Clear();
+    size_t   Count() const;
+
+    std::vector<WatchInfo> Entries() const;
+    // Oldest to newest, as numbers; returns false for an unknown id.
+    bool History(uint64_t id, std::vector<double>& values, std::vector<uint64_t>* timesNs = nullptr) const;
+
+    WatchStats Stats() const;
+
+    static double Decode(ScanType type, size_t size, uint64_t raw);
+
+private:
+    struct Entry {
+        WatchInfo info;
+        WatchSample ring[kHistory];
+        size_t head = 0;            // next slot to write
+    };
+    struct Read { uintptr_t addr; size_t size; size_t off; };
+
+    void Run();
+    void RebuildLocked();
+    void Record(Entry& e, uint64_t raw, uint64_t now);
+
+    mutable std::mutex mu_;
+    std::condition_variable cv_;
+    std::thread thread_;
+    std::unique_ptr<ProcessMemory> mem_;
+    std::atomic<bool> running_{false};
+    bool stop_ = false;
+    unsigned pid_ = 0;
+    std::atomic<unsigned> rateHz_{20};
+
+    std::vector<std::unique_ptr<Entry>> entries_;   // sorted by address
+    uint64_t nextId_ = 1;
+    bool dirty_ = false;
+
+    // read layout, owned by the poll thread
+    std::vector<Read> reads_;
+    std::vector<size_t> entryRead_;     // per entry: index into reads_
+    std::vector<uint8_t> buf_;
+
+    WatchStats stats_;
+    uint64_t pollSumNs_ = 0;
+};
+
+}} // namespace
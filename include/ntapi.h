@@ -344,4 +344,15 @@ typedef NTSTATUS(WINAPI* NTQUERYSYSTEMINFORMATION)(
     PVOID SystemInformation,
     ULONG SystemInformationLength,
     PULONG ReturnLength
-    );
\ No newline at end of file
+    );
+
+// PROCESSINFOCLASS value for the command line (UNICODE_STRING + buffer), Windows 8.1+.
+#define ProcessCommandLineInformation 60
+
+typedef NTSTATUS(WINAPI* NTQUERYINFORMATIONPROCESS)(
+    HANDLE ProcessHandle,
+    ULONG ProcessInformationClass,
+    PVOID ProcessInformation,
+    ULONG ProcessInformationLength,
+    PULONG ReturnLength
+    );
@@ -1,11 +1,15 @@
 #pragma once
+#ifdef _WIN32
 #include <Windows.h>
+#endif
 #include <string>
 
 std::string WStringToString(const std::wstring& wstr);
 std::string WStringToUTF8(const std::wstring& wstr);
 std::wstring UTF8ToWString(const std::string& str);
 
+#ifdef _WIN32
 BOOL EnableDebugPrivilege();
 BOOL TerminateProcessByPID(ULONG pid);
 BOOL OpenDllFileDialogW(std::wstring& filePath);
+#endif
@@ -0,0 +1,225 @@
+#include <memory>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+
+#include "plugins/IModule.h"
+#include "ui/UiRoot.h"
+#include "imgui/imgui.h"
+#include "include/SelectedPidProvider.h"
+#include "include/MemoryBrowseRequest.h"
+
+#include "include/REKit/memsearch/PageCache.h"
+#include "include/REKit/memsearch/ProcessMemory.h"
+#include "include/REKit/memsearch/ScanStats.h"
+
+namespace REKit { namespace Plugins {
+    using PageCache = REKit::MemSearch::PageCache;
+    using CachedPage = REKit::MemSearch::CachedPage;
+
+// Hex / typed view of a target's memory. Every byte shown comes from the
+// PageCache: rows whose page has not arrived yet show "..", so scrolling
+// never waits on the target, and pages ahead of the scroll direction are
+// prefetched. Bytes that differ from the previous read of their page are
+// highlighted.
+class MemBrowserModule final : public IModule {
+public:
+    const char* Name() const override { return "MemBrowser"; }
+
+    void OnLoad(ModuleContext& ctx) override {
+        ctx.ui.AddPanel("View/Memory Browser", [this](){
+            DrawUI();
+        });
+    }
+    void OnUnload(ModuleContext&) override { cache_.reset(); }
+
+private:
+    enum Mode { Hex, Int32, Int64, Float, Double };
+
+    static constexpr size_t   kRow = 16;
+    static constexpr size_t   kSpan = 16 << 20;             // rows laid out at once; re-centred while scrolling
+    static constexpr size_t   kAheadPages = 64;             // prefetched in the scroll direction
+    static constexpr size_t   kBehindPages = 8;
+    static constexpr uint64_t kRefreshNs = 250000000;       // visible pages re-read at 4 Hz when live
+
+    int  manualPid_ = 0;
+    char addrBuf_[32] = {0};
+    int  mode_ = Hex;
+    bool live_ = true;
+    static constexpr uint64_t kReopenNs = 1000000000;       // retry of a process that could not be opened
+
+    std::shared_ptr<PageCache> cache_;
+    unsigned cachePid_ = 0;
+    uint64_t cacheStart_ = 0;       // with the pid, identifies the process cache_ reads
+    uint64_t openFailedNs_ = 0;
+    uintptr_t viewBase_ = 0;        // address of row 0, page aligned
+    uintptr_t target_ = 0;          // last address jumped to, highlighted
+    bool scrollToTarget_ = false;
+    float lastScrollY_ = 0.f;
+
+    void DrawUI() {
+        int pid = GetSelectedPidOrFallback(manualPid_);
+        ImGui::Text("Selected PID: %d", pid);
+        ImGui::SameLine();
+        ImGui::InputInt("Manual PID (fallback)", &manualPid_);
+        if (pid <= 0) {
+            ImGui::TextColored(ImVec4(1,0.6f,0,1), "Select a process in ProcessExplorer or input PID.");
+            return;
+        }
+        if (!OpenCache((unsigned)pid)) {
+            ImGui::TextColored(ImVec4(1,0.6f,0,1), "Cannot open process %d for reading.", pid);
+            return;
+        }
+
+        uintptr_t req = 0;
+        if (TakeMemoryBrowseRequest(req)) {
+            snprintf(addrBuf_, sizeof(addrBuf_), "%llX", (unsigned long long)req);
+            GoTo(req);
+        }
+        ImGui::InputText("Address (hex)", addrBuf_, sizeof(addrBuf_));
+        ImGui::SameLine();
+        if (ImGui::Button("Go")) GoTo((uintptr_t)strtoull(addrBuf_, nullptr, 16));
+        const char* modes[] = {"Hex","Int32","Int64","Float","Double"};
+        ImGui::SetNextItemWidth(120);
+        ImGui::Combo("View", &mode_, modes, IM_ARRAYSIZE(modes));
+        ImGui::SameLine(); ImGui::Checkbox("Live", &live_);
+        if (ImGui::IsItemHovered()) ImGui::SetTooltip("Re-read visible pages a few times a second and highlight bytes that changed");
+
+        const REKit::MemSearch::PageCacheStats st = cache_->Stats();
+        ImGui::TextDisabled("Cached pages: %llu  Hits: %llu  Misses: %llu  Reads: %llu in %llu batches  Failed: %llu",
+            (unsigned long long)st.pages, (unsigned long long)st.hits, (unsigned long long)st.misses,
+            (unsigned long long)st.reads, (unsigned long long)st.batches, (unsigned long long)st.readFailures);
+
+        ImGui::BeginChild("mem", ImVec2(0, 0), true);
+        DrawRows();
+        ImGui::EndChild();
+    }
+
+    // A new cache when the pid now names another process (its start time
+    // changed) or the old one exited; an open that failed is retried after kReopenNs.
+    bool OpenCache(unsigned pid) {
+        const uint64_t now = REKit::MemSearch::ScanStats::NowNs();
+        if (!cache_ && cachePid_ == pid && openFailedNs_ && now - openFailedNs_ < kReopenNs) return false;
+        std::shared_ptr<const REKit::MemSearch::ProcessMemory> mem = REKit::MemSearch::ProcessAccess::Shared().Memory(pid);
+        if (!mem->IsOpen()) {
+            cache_.reset();
+            cachePid_ = pid;
+            openFailedNs_ = now;
+            return false;
+        }
+        const uint64_t start = mem->Handle()->StartTime();
+        if (!cache_ || cachePid_ != pid || cacheStart_ != start) {
+            cache_ = std::make_shared<PageCache>(mem);
+            cachePid_ = pid;
+            cacheStart_ = start;
+            openFailedNs_ = 0;
+        }
+        return true;
+    }
+
+    void GoTo(uintptr_t addr) {
+        if (!addr) return;
+        target_ = addr;
+        uintptr_t page = addr & ~(uintptr_t)(PageCache::kPage - 1);
+        viewBase_ = page > kSpan / 2 ? page - kSpan / 2 : 0;
+        scrollToTarget_ = true;
+    }
+
+    void DrawRows() {
+        const float lineH = ImGui::GetTextLineHeightWithSpacing();
+        const int rows = (int)(kSpan / kRow);
+        if (scrollToTarget_) {
+            ImGui::SetScrollY((float)((target_ - viewBase_) / kRow) * lineH - ImGui::GetWindowHeight() * 0.3f);
+            scrollToTarget_ = false;
+        }
+
+        const uint64_t refresh = live_ ? kRefreshNs : 0;
+        int firstRow = -1, lastRow = -1;
+        ImGuiListClipper clipper;
+        clipper.Begin(rows, lineH);
+        while (clipper.Step()) {
+            uintptr_t pageAddr = 1;
+            std::shared_ptr<const CachedPage> page;
+            for (int r = clipper.DisplayStart; r < clipper.DisplayEnd; ++r) {
+                if (firstRow < 0) firstRow = r;
+                lastRow = r;
+                const uintptr_t addr = viewBase_ + (uintptr_t)r * kRow;
+                const uintptr_t pa = addr & ~(uintptr_t)(PageCache::kPage - 1);
+                if (pa != pageAddr) { page = cache_->Get(pa, refresh); pageAddr = pa; }
+                DrawRow(addr, page.get());
+            }
+        }
+
+        // prefetch in the direction of the scroll, then keep the view inside the span
+        const float scrollY = ImGui::GetScrollY();
+        if (firstRow >= 0) {
+            const uintptr_t first = viewBase_ + (uintptr_t)firstRow * kRow;
+            const uintptr_t end = viewBase_ + (uintptr_t)(lastRow + 1) * kRow;
+            const bool up = scrollY < lastScrollY_;
+            const size_t ahead = kAheadPages * PageCache::kPage, behind = kBehindPages * PageCache::kPage;
+            auto prefetchBefore = [&](uintptr_t a, size_t n) {
+                uintptr_t b = a > n ? a - n : 0;
+                cache_->Prefetch(b, (size_t)(a - b));
+            };
+            if (up) { prefetchBefore(first, ahead); cache_->Prefetch(end, behind); }
+            else    { cache_->Prefetch(end, ahead); prefetchBefore(first, behind); }
+
+            const int margin = rows / 8;
+            uintptr_t shift = 0;
+            if (firstRow < margin && viewBase_ > 0) {
+                shift = (std::min)(viewBase_, (uintptr_t)kSpan / 2);
+                viewBase_ -= shift;
+                ImGui::SetScrollY(scrollY + (float)(shift / kRow) * lineH);
+            }
+            else if (lastRow > rows - margin && viewBase_ + kSpan < (uintptr_t)-1 - kSpan) {
+                shift = kSpan / 2;
+                viewBase_ += shift;
+                ImGui::SetScrollY(scrollY - (float)(shift / kRow) * lineH);
+            }
+        }
+        lastScrollY_ = ImGui::GetScrollY();
+    }
+
+    void DrawRow(uintptr_t addr, const CachedPage* page) {
+        const bool isTarget = target_ >= addr && target_ < addr + kRow;
+        if (isTarget) ImGui::TextColored(ImVec4(1, 0.85f, 0.2f, 1), "%016llX", (unsigned long long)addr);
+        else ImGui::Text("%016llX", (unsigned long long)addr);
+        ImGui::SameLine();
+        if (!page) { ImGui::TextDisabled(".."); return; }
+        if (!page->ok) { ImGui::TextDisabled("??"); return; }
+
+        const size_t off = (size_t)(addr - page->addr);
+        const uint8_t* p = page->data + off;
+        const uint8_t* q = page->prev ? page->prev.get() + off : nullptr;
+        const ImVec4 changedCol(1, 0.35f, 0.35f, 1);
+        const size_t w = mode_ == Hex ? 1 : (mode_ == Int32 || mode_ == Float) ? 4 : 8;
+        char s[40];
+        for (size_t i = 0; i < kRow; i += w) {
+            switch (mode_) {
+            case Int32:  { int32_t v; memcpy(&v, p + i, 4); snprintf(s, sizeof(s), "%12d", v); break; }
+            case Int64:  { long long v; memcpy(&v, p + i, 8); snprintf(s, sizeof(s), "%21lld", v); break; }
+            case Float:  { float v; memcpy(&v, p + i, 4); snprintf(s, sizeof(s), "%14g", v); break; }
+            case Double: { double v; memcpy(&v, p + i, 8); snprintf(s, sizeof(s), "%22g", v); break; }
+            default:     snprintf(s, sizeof(s), "%02X", p[i]); break;
+            }
+            const bool changed = q && memcmp(p + i, q + i, w) != 0;
+            if (changed) ImGui::TextColored(changedCol, "%s", s);
+            else ImGui::TextUnformatted(s);
+            ImGui::SameLine();
+        }
+        if (mode_ == Hex) {
+            char ascii[kRow + 1];
+            for (size_t i = 0; i < kRow; ++i) ascii[i] = (p[i] >= 32 && p[i] < 127) ? (char)p[i] : '.';
+            ascii[kRow] = 0;
+            ImGui::TextUnformatted(ascii);
+        }
+        else ImGui::NewLine();
+    }
+};
+
+std::unique_ptr<IModule> CreateMemBrowser() { return std::make_unique<MemBrowserModule>(); }
+
+}} // namespace
@@ -8,23 +8,42 @@
 #include <cctype>
 #include <cstring>
 #include <sstream>
+#include <unordered_map>
+#include <climits>
 #include <iomanip>
 
 #include "plugins/IModule.h"
 #include "ui/UiRoot.h"
 #include "imgui/imgui.h"
 #include "include/SelectedPidProvider.h"
+#include "include/MemoryBrowseRequest.h"
 
 #ifdef _WIN32
 #  include <windows.h>
 #endif
 
 #include "include/REKit/memsearch/MemSearchEngine.h"
+#include "include/REKit/memsearch/ScanScheduler.h"
+#include "include/REKit/memsearch/Freezer.h"
+#include "include/REKit/memsearch/WatchList.h"
+#include "include/REKit/memsearch/GroupScan.h"
+#include "include/REKit/memsearch/CoreDumpSource.h"
+#include "include/REKit/memsearch/PageSnapshot.h"
+#include "include/REKit/memsearch/SnapshotDiff.h"
+#include "include/REKit/memsearch/ResultSetOps.h"
+#include "include/REKit/memsearch/SigDatabase.h"
+#include "include/REKit/memsearch/SigProgram.h"
 
 namespace REKit { namespace Plugins {
     using ScanType = REKit::MemSearch::ScanType;
     using CompareMode = REKit::MemSearch::CompareMode;
     using ScanOptions = REKit::MemSearch::ScanOptions;
+    using ScanStats = REKit::MemSearch::ScanStats;
+    using ResultStore = REKit::MemSearch::ResultStore;
+    using ScanJob = REKit::MemSearch::ScanJob;
+    using ScanScheduler = REKit::MemSearch::ScanScheduler;
+    using Freezer = REKit::MemSearch::Freezer;
+    using WatchList = REKit::MemSearch::WatchList;
 
 static bool ParseHexWithMask(const std::string& src, std::vector<uint8_t>& pat, std::vector<uint8_t>& mask) {
     pat.clear(); mask.clear();
@@ -144,34 +163,120 @@ public:
             DrawUI();
         });
     }
-    void OnUnload(ModuleContext&) override {}
+    void OnUnload(ModuleContext&) override { StopSnapshotWork(); StopSetWork(); StopSigWork(); }
+    ~MemSearchModule() override { StopSnapshotWork(); StopSetWork(); StopSigWork(); }
 
 private:
-    std::vector<uintptr_t> results_;
-    std::vector<uintptr_t> prevResults_;
-    std::atomic<bool> cancel_{false};
-    std::atomic<float> progress_ = 0.f;
+    ResultStore results_;
+    ResultStore saved_;                 // a result set kept aside to combine with later ones
+    // Addresses from a core dump mean nothing in the selected process, so
+    // Freeze, Watch and Browse are off for them.
+    bool resultsFromCore_ = false;
+    bool savedFromCore_ = false;
+    int  setOp_ = 1;
+    int  nearWindow_ = 16;
+    // Set operations and "Save current" run on their own thread, which reads
+    // results_ and saved_ and owns setOut_, setOk_ and setStatus_ while
+    // setBusy_. Scans and set buttons stay disabled until PollSetWork joins it.
+    std::thread setThread_;
+    std::atomic<bool> setBusy_{false};
+    std::atomic<bool> setCancel_{false};
+    std::atomic<float> setProgress_{0.f};
+    ResultStore setOut_;
+    bool setOk_ = false;
+    bool setToSaved_ = false;           // setOut_ replaces saved_ rather than results_
+    std::string setStatus_;
+    std::shared_ptr<ScanJob> job_;      // last submitted scan, kept for its stats
+    bool collected_ = true;             // job_'s results were moved into results_
     std::string status_;
 
     ScanOptions opt_;
     char hexBuf_[512] = {0};
+    mutable std::string patSizeKey_;    // hexBuf_ that patSize_ was computed for
+    mutable size_t patSize_ = 0;
     char strBuf_[256] = {0};
     char baseBuf_[64] = {0};
+    char coreBuf_[260] = {0};
     char lenBuf_[64]  = {0};
+    char groupBuf_[512] = {0};
+    int  budgetMb_ = 0;
+    int  priority_ = 10;
+    Freezer freezer_;
+    int  freezePeriodUs_ = 10000;
+    WatchList watch_;
+    int  watchHz_ = 20;
+
+    // Whole-process snapshots T0/T1 sharing one page store, and their diff.
+    // The worker thread owns snaps_, diff_ and snapStatus_ while snapBusy_.
+    std::shared_ptr<REKit::MemSearch::PageStore> snapStore_;
+    std::shared_ptr<REKit::MemSearch::PageSnapshot> snaps_[2];
+    std::vector<REKit::MemSearch::DiffRange> diff_;
+    std::string snapStatus_;
+    bool snapFromCore_ = false;         // a snapshot of the current pair read a core dump
+    std::thread snapThread_;
+    std::atomic<bool> snapBusy_{false};
+    std::atomic<bool> snapCancel_{false};
+    std::atomic<float> snapProgress_{0.f};
+
+    // Signature database resolved against the selected process, hits cached
+    // next to the database file. The worker owns sigDb_, sigCache_, sigOut_
+    // and sigStatus_ while sigBusy_.
+    char sigPath_[260] = {0};
+    REKit::MemSearch::SigDatabase sigDb_;
+    REKit::MemSearch::SigCache sigCache_;
+    std::string sigCachePath_;
+    std::vector<REKit::MemSearch::SigResolved> sigOut_;
+    std::string sigStatus_;
+    bool sigFromCore_ = false;
+    std::thread sigThread_;
+    std::atomic<bool> sigBusy_{false};
+
+    // Current values of visible result rows, formatted once per read.
+    struct RowValue { uint64_t readNs = 0; bool ok = false; char text[64] = {0}; };
+    static constexpr uint64_t kRowRefreshNs = 250000000;    // rows re-read at 4 Hz
+    static constexpr uint64_t kRowBudgetNs = 2000000;       // read time per frame
+    static constexpr size_t   kRowGap = 256;                // rows this close share a read
+    std::unordered_map<uintptr_t, RowValue> rowValues_;
+    std::vector<uintptr_t> visibleRows_;
+    std::vector<uintptr_t> rowWant_;
+    REKit::MemSearch::BatchReader rowReader_{ kRowGap };
+    const void* rowKey_ = nullptr;      // source and type the cached texts were made for
+    ScanType rowType_ = ScanType::Bytes;
+    size_t rowBatchMax_ = 256;          // adapts to kRowBudgetNs
+
+    bool Busy() const { return job_ && !job_->Done(); }
+
+    void PollJob() {
+        if (!job_ || collected_ || !job_->Done()) return;
+        results_.Swap(job_->Results());
+        status_ = job_->Status();
+        collected_ = true;
+    }
 
     void DrawUI() {
+        PollJob();
+        PollSetWork();
         int selPid = GetSelectedPidOrFallback((int)opt_.pid);
         ImGui::Text("Selected PID: %d", selPid);
         ImGui::InputInt("Manual PID (fallback)", (int*)&opt_.pid);
+        ImGui::InputText("Core dump", coreBuf_, sizeof(coreBuf_));
+        ImGui::SameLine();
+        if (!opt_.source) { if (ImGui::Button("Open core")) OpenCore(); }
+        else if (ImGui::Button("Close core")) opt_.source.reset();
+        if (opt_.source) ImGui::TextDisabled("Scans read the core dump, not a process");
 
         ImGui::Checkbox("Auto pages", &opt_.autoPages);
+        ImGui::SameLine(); ImGui::Checkbox("Modules from disk", &opt_.moduleFiles);
+        if (ImGui::IsItemHovered()) ImGui::SetTooltip("Scan read-only module sections from their mapped files instead of reading them from the process");
+        ImGui::SameLine(); ImGui::Checkbox("Scan agent", &opt_.useAgent);
+        if (ImGui::IsItemHovered()) ImGui::SetTooltip("Run first scans inside the target when the REKit scan agent is loaded into it (not for Group scans)");
         ImGui::SameLine();
         ImGui::InputText("Base (hex)", baseBuf_, sizeof(baseBuf_));
         ImGui::SameLine();
         ImGui::InputText("Length (hex)", lenBuf_, sizeof(lenBuf_));
 
         ImGui::InputScalar("Alignment", ImGuiDataType_U64, &opt_.alignment);
-        const char* types[] = {"Bytes","ASCII","UTF-16LE","Int32","Float","Double"};
+        const char* types[] = {"Bytes","ASCII","UTF-16LE","Int32","Float","Double","Group"};
         int t = (int)opt_.type;
         if (ImGui::Combo("Type", &t, types, IM_ARRAYSIZE(types))) {
             opt_.type = (ScanType)t;
@@ -179,7 +284,7 @@ private:
 
         if (opt_.type == ScanType::Bytes) {
             ImGui::InputText("Hex pattern", hexBuf_, sizeof(hexBuf_));
-            ImGui::SameLine(); ImGui::TextDisabled("(supports space and '?')");
+            ImGui::SameLine(); ImGui::TextDisabled("(supports space, '?', [n-m] gaps, (A|B), {lo-hi}, $name:4)");
         } else if (opt_.type == ScanType::Ascii) {
             ImGui::InputText("String (ASCII/UTF-8)", strBuf_, sizeof(strBuf_));
         } else if (opt_.type == ScanType::Utf16) {
@@ -190,69 +295,615 @@ private:
             ImGui::InputFloat("Value (float)", &opt_.floatVal);
         } else if (opt_.type == ScanType::Double) {
             ImGui::InputDouble("Value (double)", &opt_.doubleVal);
+        } else if (opt_.type == ScanType::Group) {
+            ImGui::InputText("Terms", groupBuf_, sizeof(groupBuf_));
+            ImGui::SameLine(); ImGui::TextDisabled("(e.g. i32:100 f32:3.5 i16:7 hex:48??8B)");
+            ImGui::InputScalar("Window (bytes)", ImGuiDataType_U64, &opt_.group.window);
+            ImGui::SameLine(); ImGui::Checkbox("Ordered", &opt_.group.ordered);
         }
 
         const char* cmps[] = {"Exact","Increased","Decreased","Changed","Unchanged"};
         int c = (int)opt_.cmp;
         ImGui::Combo("Compare mode (next scan)", &c, cmps, IM_ARRAYSIZE(cmps));
         opt_.cmp = (CompareMode)c;
+        ImGui::InputInt("Result RAM budget (MB, 0 = unlimited)", &budgetMb_);
+        if (budgetMb_ < 0) budgetMb_ = 0;
+        ImGui::SliderInt("Priority", &priority_, 1, 100);
 
         // buttons
+        const bool busy = Busy() || setBusy_;
+        if (busy) ImGui::BeginDisabled();
         if (ImGui::Button("First Scan")) {
-            cancel_ = false;
-            results_.clear();
-            prevResults_.clear();
-            PrepareOptions(selPid);
-            LaunchFirstScan();
+            results_.Clear();
+            if (PrepareOptions(selPid)) LaunchFirstScan();
         }
         ImGui::SameLine();
         if (ImGui::Button("Next Scan")) {
-            cancel_ = false;
-            if (!results_.empty()) {
-                prevResults_ = results_;
-                results_.clear();
-                PrepareOptions(selPid);
-                LaunchNextScan();
+            if (!results_.Empty()) {
+                if (PrepareOptions(selPid)) LaunchNextScan();
             }
         }
+        if (busy) ImGui::EndDisabled();
         ImGui::SameLine();
         if (ImGui::Button("Cancel")) {
-            cancel_ = true;
+            if (job_) job_->Cancel();
+            setCancel_ = true;
         }
 
-        ImGui::Text("Status: %s", status_.c_str());
-        ImGui::ProgressBar(progress_.load(), ImVec2(-FLT_MIN, 0.0f));
+        const bool setBusy = setBusy_;
+        ImGui::Text("Status: %s", Busy() ? job_->Status().c_str() : setBusy ? "Working on result sets..." : status_.c_str());
+        ImGui::ProgressBar(setBusy ? setProgress_.load() : job_ ? job_->Progress() : 0.f, ImVec2(-FLT_MIN, 0.0f));
+        if (ImGui::CollapsingHeader("Scan stats") && job_) DrawStats(job_->Stats());
 
         ImGui::Separator();
-        ImGui::Text("Results: %d", (int)results_.size());
-        ImGui::BeginChild("res", ImVec2(0, 200), true);
-        for (auto addr : results_) {
+        ImGui::Text("Results: %zu", results_.Size());
+        if (results_.BytesSpilled() > 0) {
+            ImGui::SameLine();
+            ImGui::TextDisabled("(%.1f MB spilled to disk)", (double)results_.BytesSpilled() / (1024.0 * 1024.0));
+        }
+        DrawResults(selPid);
+        RefreshRowValues(selPid);
+
+        if (ImGui::CollapsingHeader("Result sets")) DrawResultSets(busy);
+        if (ImGui::CollapsingHeader("Frozen values")) DrawFrozen();
+        if (ImGui::CollapsingHeader("Watch list")) DrawWatch();
+        if (ImGui::CollapsingHeader("Snapshots")) DrawSnapshots(selPid);
+        if (ImGui::CollapsingHeader("Signatures")) DrawSignatures(selPid);
+    }
+
+    // Only the visible rows are built; their values come from RefreshRowValues.
+    void DrawResults(int selPid) {
+        visibleRows_.clear();
+        if (!ImGui::BeginTable("res", 2, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersOuter | ImGuiTableFlags_ScrollY, ImVec2(0, 200))) return;
+        ImGui::TableSetupScrollFreeze(0, 1);
+        ImGui::TableSetupColumn("Address");
+        ImGui::TableSetupColumn("Value");
+        ImGui::TableHeadersRow();
+        ImGuiListClipper clipper;
+        clipper.Begin((int)(std::min)(results_.Size(), (size_t)INT_MAX));
+        while (clipper.Step()) for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row) {
+            uintptr_t addr = results_.Get((size_t)row);
+            visibleRows_.push_back(addr);
+            ImGui::PushID(row);
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
             char line[64];
             snprintf(line, sizeof(line), "0x%p", (void*)addr);
-            if (ImGui::Selectable(line)) {
-#ifdef _WIN32
-                HANDLE h = OpenProcess(PROCESS_VM_READ|PROCESS_QUERY_INFORMATION, FALSE, (DWORD)selPid);
+            if (ImGui::Selectable(line, false, ImGuiSelectableFlags_SpanAllColumns)) {
+                std::shared_ptr<const REKit::MemSearch::IMemorySource> src = opt_.source;
+                if (!src && selPid > 0) src = REKit::MemSearch::ProcessAccess::Shared().Memory((unsigned)selPid);
                 unsigned char buf[64] = {0};
-                SIZE_T br = 0;
-                if (h && ReadProcessMemory(h, (LPCVOID)addr, buf, sizeof(buf), &br)) {
-                    std::string ascii;
-                    ascii.reserve(br);
-                    for (size_t i=0;i<br;++i){
-                        char ch = (char)buf[i];
-                        ascii.push_back((ch>=32 && ch<127)? ch : '.');
-                    }
-                    status_ = "Preview: " + ascii;
-                } else {
-                    status_ = "Preview failed";
+                size_t br = src ? src->Read(addr, buf, sizeof(buf)) : 0;
+                std::string ascii;
+                for (size_t i = 0; i < br; ++i) ascii.push_back(buf[i] >= 32 && buf[i] < 127 ? (char)buf[i] : '.');
+                status_ = br ? "Preview: " + ascii : "Preview failed";
+            }
+            if (ImGui::BeginPopupContextItem()) {
+                const bool live = !resultsFromCore_;
+                if (ImGui::MenuItem("Freeze current value", nullptr, false, live)) FreezeAt(selPid, addr);
+                if (ImGui::MenuItem("Watch", nullptr, false, live)) WatchAt(selPid, addr);
+                if (ImGui::MenuItem("Browse memory", nullptr, false, live)) RequestMemoryBrowse(addr);
+                if (!live) ImGui::TextDisabled("(address from a core dump)");
+                ImGui::EndPopup();
+            }
+            ImGui::TableNextColumn();
+            auto it = rowValues_.find(addr);
+            if (it == rowValues_.end()) ImGui::TextDisabled("...");
+            else if (!it->second.ok) ImGui::TextDisabled("??");
+            else ImGui::TextUnformatted(it->second.text);
+            ImGui::PopID();
+        }
+        ImGui::EndTable();
+    }
+
+    // Combines the current results with the saved set, e.g. candidates minus addresses that change while idle.
+    void DrawResultSets(bool busy) {
+        ImGui::Text("Saved set: %zu", saved_.Size());
+        if (busy) ImGui::BeginDisabled();
+        ImGui::SameLine();
+        if (ImGui::SmallButton("Save current")) SaveCurrent();
+        const char* ops[] = {"Union","Intersect","Current minus saved","Near saved"};
+        ImGui::Combo("Operation", &setOp_, ops, IM_ARRAYSIZE(ops));
+        if (setOp_ == (int)REKit::MemSearch::SetOp::Near) {
+            ImGui::InputInt("Window (bytes)", &nearWindow_);
+            if (nearWindow_ < 0) nearWindow_ = 0;
+        }
+        if (ImGui::Button("Apply to results")) ApplySetOp((REKit::MemSearch::SetOp)setOp_, ops[setOp_]);
+        if (busy) ImGui::EndDisabled();
+    }
+
+    void StopSetWork() {
+        setCancel_ = true;
+        if (setThread_.joinable()) setThread_.join();
+    }
+
+    // Runs fn on the set thread; its output in setOut_ gets the current results' budget.
+    template <typename Fn>
+    void RunSetWork(bool toSaved, Fn fn) {
+        if (setThread_.joinable()) setThread_.join();
+        setOut_ = ResultStore(results_.MemoryBudget());
+        setToSaved_ = toSaved;
+        setOk_ = false;
+        setCancel_ = false;
+        setProgress_ = 0.f;
+        setBusy_ = true;
+        setThread_ = std::thread([this, fn]() { fn(); setBusy_ = false; });
+    }
+
+    void PollSetWork() {
+        if (setBusy_ || !setThread_.joinable()) return;
+        setThread_.join();
+        if (setOk_) (setToSaved_ ? saved_ : results_).Swap(setOut_);
+        if (setOk_ && setToSaved_) savedFromCore_ = resultsFromCore_;
+        else if (setOk_) resultsFromCore_ = resultsFromCore_ || savedFromCore_;
+        setOut_.Clear();
+        status_ = setStatus_;
+    }
+
+    // Copied a block at a time, so spilled results stay on disk.
+    void SaveCurrent() {
+        RunSetWork(true, [this]() {
+            const float blocks = (float)(std::max)(results_.BlockCount(), (size_t)1);
+            size_t done = 0;
+            setOk_ = results_.ForEachBlock([&](const uintptr_t* p, size_t n) {
+                setOut_.Append(p, n);
+                setProgress_ = (float)++done / blocks;
+                return !setCancel_;
+            });
+            char msg[96];
+            if (setOk_) snprintf(msg, sizeof(msg), "Saved %zu results", setOut_.Size());
+            else snprintf(msg, sizeof(msg), "%s", setCancel_ ? "Save cancelled" : "Save failed: spilled results could not be read");
+            setStatus_ = msg;
+        });
+    }
+
+    void ApplySetOp(REKit::MemSearch::SetOp op, const char* name) {
+        const size_t window = (size_t)nearWindow_;
+        RunSetWork(false, [this, op, name, window]() {
+            const uint64_t t0 = ScanStats::NowNs();
+            setOk_ = REKit::MemSearch::CombineResults(op, results_, saved_, setOut_, setCancel_, setProgress_, window);
+            char msg[96];
+            if (setOk_) snprintf(msg, sizeof(msg), "%s: %zu results (%.1f ms)", name, setOut_.Size(), (double)(ScanStats::NowNs() - t0) / 1e6);
+            else snprintf(msg, sizeof(msg), "%s %s", name, setCancel_ ? "cancelled" : "failed: spilled results could not be read");
+            setStatus_ = msg;
+        });
+    }
+
+    void StopSnapshotWork() {
+        snapCancel_ = true;
+        if (snapThread_.joinable()) snapThread_.join();
+    }
+
+    template <typename Fn>
+    void RunSnapshotWork(Fn fn) {
+        if (snapThread_.joinable()) snapThread_.join();
+        snapCancel_ = false;
+        snapProgress_ = 0.f;
+        snapBusy_ = true;
+        snapThread_ = std::thread([this, fn]() { fn(); snapBusy_ = false; });
+    }
+
+    // T0 starts a new page store; T1 shares it, so unchanged pages cost nothing and diff by id.
+    void TakeSnapshot(int pid, int slot) {
+        std::shared_ptr<const REKit::MemSearch::IMemorySource> src = opt_.source;
+        if (!src) {
+            if (pid <= 0) { snapStatus_ = "Snapshot: no process selected"; return; }
+            src = REKit::MemSearch::ProcessAccess::Shared().Memory((unsigned)pid);
+        }
+        if (slot == 0 || !snapStore_) {
+            snapStore_ = std::make_shared<REKit::MemSearch::PageStore>();
+            snaps_[0].reset(); snaps_[1].reset();
+            snapFromCore_ = false;
+        }
+        if (opt_.source) snapFromCore_ = true;
+        diff_.clear();
+        auto store = snapStore_;
+        RunSnapshotWork([this, src, store, slot]() {
+            auto snap = std::make_shared<REKit::MemSearch::PageSnapshot>(store);
+            REKit::MemSearch::SnapshotStats st;
+            char msg[160];
+            if (!snap->Capture(*src, snapCancel_, snapProgress_, &st)) { snapStatus_ = "Snapshot cancelled"; return; }
+            const double raw = (double)st.pages * REKit::MemSearch::PageStore::kPage;
+            snprintf(msg, sizeof(msg), "T%d: %llu pages (%llu zero, %llu shared), %.1f MB stored for %.1f MB, %.0f ms", slot,
+                (unsigned long long)st.pages, (unsigned long long)st.zeroPages, (unsigned long long)st.dupPages,
+                (double)st.storedBytes / (1024.0 * 1024.0), raw / (1024.0 * 1024.0), (double)st.ns / 1e6);
+            snapStatus_ = msg;
+            snaps_[slot] = snap;
+        });
+    }
+
+    void RunDiff() {
+        auto a = snaps_[0], b = snaps_[1];
+        diff_.clear();
+        RunSnapshotWork([this, a, b]() {
+            std::vector<REKit::MemSearch::DiffRange> out;
+            REKit::MemSearch::DiffStats st;
+            if (!REKit::MemSearch::DiffMemory(*a, *b, out, snapCancel_, snapProgress_, REKit::MemSearch::DiffOptions(), &st)) {
+                snapStatus_ = "Diff cancelled";
+                return;
+            }
+            char msg[160];
+            snprintf(msg, sizeof(msg), "%zu changed ranges, %llu bytes, %.0f ms (%.1f MB compared, rest equal by page)", out.size(),
+                (unsigned long long)st.changedBytes, (double)st.ns / 1e6, (double)st.comparedBytes / (1024.0 * 1024.0));
+            snapStatus_ = msg;
+            diff_.swap(out);
+        });
+    }
+
+    void DrawSnapshots(int selPid) {
+        const bool busy = snapBusy_;
+        if (!busy && snapThread_.joinable()) snapThread_.join();
+        if (busy) ImGui::BeginDisabled();
+        if (ImGui::Button("Snapshot T0")) TakeSnapshot(selPid, 0);
+        ImGui::SameLine();
+        if (ImGui::Button("Snapshot T1")) TakeSnapshot(selPid, 1);
+        ImGui::SameLine();
+        // snaps_ and diff_ belong to the worker from the moment a button above
+        // starts it until it has been joined, so snapBusy_ is read again here
+        const bool ready = !snapBusy_ && snaps_[0] && snaps_[1];
+        if (!busy && !ready) ImGui::BeginDisabled();
+        if (ImGui::Button("Diff T0 -> T1")) RunDiff();
+        if (!busy && !ready) ImGui::EndDisabled();
+        if (busy) ImGui::EndDisabled();
+        ImGui::SameLine();
+        if (ImGui::SmallButton("Cancel##snap")) snapCancel_ = true;
+        ImGui::Text("%s", busy ? "Working..." : snapStatus_.c_str());
+        ImGui::ProgressBar(snapProgress_, ImVec2(-FLT_MIN, 0.0f));
+        if (snapBusy_ || diff_.empty()) return;
+
+        if (!ImGui::BeginTable("diff", 4, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersOuter | ImGuiTableFlags_ScrollY, ImVec2(0, 240))) return;
+        ImGui::TableSetupScrollFreeze(0, 1);
+        ImGui::TableSetupColumn("Address");
+        ImGui::TableSetupColumn("Size");
+        ImGui::TableSetupColumn("T0");
+        ImGui::TableSetupColumn("T1");
+        ImGui::TableHeadersRow();
+        // decode only the visible rows
+        ImGuiListClipper clipper;
+        clipper.Begin((int)diff_.size());
+        while (clipper.Step()) {
+            for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i) {
+                const REKit::MemSearch::DiffValue v = REKit::MemSearch::DecodeDiff(*snaps_[0], *snaps_[1], diff_[i]);
+                ImGui::PushID(i);
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                char line[64];
+                snprintf(line, sizeof(line), "0x%p", (void*)v.addr);
+                ImGui::Selectable(line, false, ImGuiSelectableFlags_SpanAllColumns);
+                if (ImGui::BeginPopupContextItem()) {
+                    if (ImGui::MenuItem("Watch", nullptr, false, !snapFromCore_)) WatchAt(selPid, v.addr);
+                    if (snapFromCore_) ImGui::TextDisabled("(address from a core dump)");
+                    ImGui::EndPopup();
                 }
-                if (h) CloseHandle(h);
-#endif
+                ImGui::TableNextColumn(); ImGui::Text("%zu", diff_[i].size);
+                ImGui::TableNextColumn(); ImGui::TextUnformatted(v.before.c_str());
+                ImGui::TableNextColumn(); ImGui::TextUnformatted(v.after.c_str());
+                ImGui::PopID();
             }
         }
-        ImGui::EndChild();
+        ImGui::EndTable();
+    }
+
+    void StopSigWork() {
+        if (sigThread_.joinable()) sigThread_.join();
+    }
+
+    // Loads the database and its cache on every run, so edits to either file
+    // are picked up; only entries missing from the cache scan their module.
+    void ResolveSigs(int pid) {
+        std::shared_ptr<const REKit::MemSearch::IMemorySource> src = opt_.source;
+        if (!src) {
+            if (pid <= 0) { sigStatus_ = "Signatures: no process selected"; return; }
+            src = REKit::MemSearch::ProcessAccess::Shared().Memory((unsigned)pid);
+        }
+        sigFromCore_ = (bool)opt_.source;
+        const std::string path = sigPath_;
+        sigOut_.clear();
+        if (sigThread_.joinable()) sigThread_.join();
+        sigBusy_ = true;
+        sigThread_ = std::thread([this, src, path]() {
+            std::string err;
+            if (!sigDb_.Load(path, &err)) { sigStatus_ = "Signatures: " + err; sigBusy_ = false; return; }
+            const std::string cachePath = path + ".cache";
+            if (cachePath != sigCachePath_) { sigCache_.Clear(); sigCache_.Load(cachePath); sigCachePath_ = cachePath; }
+            REKit::MemSearch::SigResolveStats st;
+            const uint64_t t0 = ScanStats::NowNs();
+            REKit::MemSearch::ResolveSignatures(*src, sigDb_, &sigCache_, sigOut_, &st);
+            if (sigCache_.Dirty()) sigCache_.Save(cachePath);
+            char msg[160];
+            snprintf(msg, sizeof(msg), "%zu signatures, %zu cached, %zu modules scanned (%.1f MB), %.1f ms", sigOut_.size(),
+                st.cacheHits, st.modulesScanned, (double)st.bytesScanned / (1024.0 * 1024.0), (double)(ScanStats::NowNs() - t0) / 1e6);
+            sigStatus_ = msg;
+            sigBusy_ = false;
+        });
+    }
+
+    void DrawSignatures(int selPid) {
+        const bool busy = sigBusy_;
+        if (!busy && sigThread_.joinable()) sigThread_.join();
+        ImGui::InputText("Database", sigPath_, sizeof(sigPath_));
+        ImGui::SameLine();
+        if (busy) ImGui::BeginDisabled();
+        if (ImGui::Button("Resolve")) ResolveSigs(selPid);
+        if (busy) ImGui::EndDisabled();
+        ImGui::Text("%s", busy ? "Working..." : sigStatus_.c_str());
+        if (sigBusy_ || sigOut_.empty()) return;
+
+        if (!ImGui::BeginTable("sigs", 4, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersOuter | ImGuiTableFlags_ScrollY, ImVec2(0, 240))) return;
+        ImGui::TableSetupScrollFreeze(0, 1);
+        ImGui::TableSetupColumn("Name");
+        ImGui::TableSetupColumn("Module");
+        ImGui::TableSetupColumn("Address");
+        ImGui::TableSetupColumn("Hits");
+        ImGui::TableHeadersRow();
+        for (size_t i = 0; i < sigOut_.size(); ++i) {
+            const REKit::MemSearch::SigResolved& r = sigOut_[i];
+            ImGui::PushID((int)i);
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn(); ImGui::TextUnformatted(r.entry->name.c_str());
+            ImGui::TableNextColumn(); ImGui::TextUnformatted(r.entry->module.c_str());
+            ImGui::TableNextColumn();
+            if (!r.moduleFound) ImGui::TextDisabled("module not loaded");
+            else if (r.hits.Size() == 0) ImGui::TextDisabled("not found");
+            else {
+                char line[64];
+                snprintf(line, sizeof(line), "0x%p", (void*)r.hits.addrs[0]);
+                ImGui::Selectable(line, false, ImGuiSelectableFlags_SpanAllColumns);
+                if (ImGui::BeginPopupContextItem()) {
+                    if (ImGui::MenuItem("Copy address")) ImGui::SetClipboardText(line);
+                    if (ImGui::MenuItem("Browse memory", nullptr, false, !sigFromCore_)) RequestMemoryBrowse(r.hits.addrs[0]);
+                    if (sigFromCore_) ImGui::TextDisabled("(address from a core dump)");
+                    ImGui::EndPopup();
+                }
+            }
+            ImGui::TableNextColumn(); ImGui::Text("%zu%s", r.hits.Size(), r.fromCache ? " (cached)" : "");
+            ImGui::PopID();
+        }
+        ImGui::EndTable();
+    }
+
+    // Re-reads the visible rows whose values are stale, in one batched read of
+    // coalesced spans; the number of rows per frame adapts to the time budget.
+    void RefreshRowValues(int pid) {
+        std::shared_ptr<const REKit::MemSearch::IMemorySource> mem = opt_.source;
+        if (!mem) {
+            if (pid <= 0) return;
+            mem = REKit::MemSearch::ProcessAccess::Shared().Memory((unsigned)pid);
+        }
+        if (rowKey_ != mem.get() || rowType_ != opt_.type) {
+            rowValues_.clear();
+            rowKey_ = mem.get();
+            rowType_ = opt_.type;
+        }
+        if (rowValues_.size() > 8192) rowValues_.clear();
+
+        const uint64_t now = ScanStats::NowNs();
+        std::vector<uintptr_t>& want = rowWant_;
+        want.clear();
+        for (uintptr_t a : visibleRows_) {
+            auto it = rowValues_.find(a);
+            if (it == rowValues_.end() || now - it->second.readNs >= kRowRefreshNs) want.push_back(a);
+        }
+        if (want.empty()) return;
+        std::sort(want.begin(), want.end());
+        want.erase(std::unique(want.begin(), want.end()), want.end());
+        if (want.size() > rowBatchMax_) want.resize(rowBatchMax_);
+
+        size_t n = ValueSize();
+        if (n == 0 || n > 16) n = 16;
+        rowReader_.Clear();
+        for (uintptr_t a : want) rowReader_.Add(a, n);
+        rowReader_.Run(*mem);
+        const uint64_t took = ScanStats::NowNs() - now;
+        if (took > kRowBudgetNs && rowBatchMax_ > 16) rowBatchMax_ /= 2;
+        else if (took * 4 < kRowBudgetNs && rowBatchMax_ < 4096) rowBatchMax_ *= 2;
+
+        for (size_t i = 0; i < want.size(); ++i) {
+            RowValue& v = rowValues_[want[i]];
+            v.readNs = now;
+            v.ok = rowReader_.Ok(i);
+            if (v.ok) FormatValue(rowReader_.Data(i), n, v.text, sizeof(v.text));
+        }
+    }
+
+    void FormatValue(const uint8_t* p, size_t n, char* out, size_t cap) const {
+        switch (opt_.type) {
+        case ScanType::Int32:  { int32_t v; memcpy(&v, p, 4); snprintf(out, cap, "%d", v); return; }
+        case ScanType::Float:  { float v;   memcpy(&v, p, 4); snprintf(out, cap, "%g", v); return; }
+        case ScanType::Double: { double v;  memcpy(&v, p, 8); snprintf(out, cap, "%g", v); return; }
+        case ScanType::Ascii:
+        case ScanType::Utf16: {
+            const size_t step = opt_.type == ScanType::Utf16 ? 2 : 1;
+            size_t k = 0;
+            for (size_t i = 0; i < n && k + 1 < cap; i += step) out[k++] = (p[i] >= 32 && p[i] < 127) ? (char)p[i] : '.';
+            out[k] = 0;
+            return;
+        }
+        case ScanType::Bytes:
+        case ScanType::Group: break;
+        }
+        size_t k = 0;
+        for (size_t i = 0; i < n && k + 4 <= cap; ++i) k += (size_t)snprintf(out + k, cap - k, i ? " %02X" : "%02X", p[i]);
+    }
+
+    size_t ValueSize() const {
+        switch (opt_.type) {
+        case ScanType::Int32:  return sizeof(int32_t);
+        case ScanType::Float:  return sizeof(float);
+        case ScanType::Double: return sizeof(double);
+        case ScanType::Ascii:  return strlen(strBuf_);
+        case ScanType::Utf16:  return strlen(strBuf_) * 2;
+        case ScanType::Bytes:  return PatternSize();
+        case ScanType::Group:  return 0;
+        }
+        return 0;
+    }
+
+    // Bytes every hit of the pattern covers. Extended signatures go through
+    // their compiled SigProgram; one with variable gaps gives its shortest
+    // match, so Freeze and Watch never reach past a hit. Cached per pattern
+    // text, as rows ask every frame.
+    size_t PatternSize() const {
+        if (patSizeKey_ == hexBuf_) return patSize_;
+        patSizeKey_ = hexBuf_;
+        patSize_ = 0;
+        if (REKit::MemSearch::SigProgram::IsExtended(patSizeKey_)) {
+            REKit::MemSearch::SigProgram prog;
+            if (prog.Compile(patSizeKey_)) patSize_ = prog.MinLength();
+        }
+        else {
+            std::vector<uint8_t> pat, mask;
+            if (ParseHexWithMask(patSizeKey_, pat, mask)) patSize_ = pat.size();
+        }
+        return patSize_;
+    }
+
+    // Locks addr at the value it holds right now, typed by the current scan type.
+    void FreezeAt(int pid, uintptr_t addr) {
+        uint8_t buf[256];
+        size_t n = ValueSize();
+        if (pid <= 0 || n == 0 || n > sizeof(buf)) { status_ = "Freeze: no value size for this type"; return; }
+        if (REKit::MemSearch::ProcessAccess::Shared().Memory((unsigned)pid)->Read(addr, buf, n) != n) { status_ = "Freeze: read failed"; return; }
+        if (!freezer_.Running() || freezer_.Pid() != (unsigned)pid) {
+            freezer_.Clear();
+            if (!freezer_.Start((unsigned)pid, (unsigned)freezePeriodUs_)) { status_ = "Freeze: cannot open process for writing"; return; }
+        }
+        freezer_.Add(REKit::MemSearch::MakeFreezeBytes(addr, buf, n, opt_.type));
+    }
+
+    void WatchAt(int pid, uintptr_t addr) {
+        if (pid <= 0) return;
+        if (!watch_.Running() || watch_.Pid() != (unsigned)pid) {
+            watch_.Clear();
+            if (!watch_.Start((unsigned)pid, (unsigned)watchHz_)) { status_ = "Watch: OpenProcess failed"; return; }
+        }
+        if (!watch_.Add(addr, opt_.type, ValueSize())) status_ = "Watch: values wider than 8 bytes are not supported";
+    }
+
+    void DrawWatch() {
+        if (ImGui::SliderInt("Rate (Hz)", &watchHz_, 1, 200)) watch_.SetRate((unsigned)watchHz_);
+        const REKit::MemSearch::WatchStats ws = watch_.Stats();
+        ImGui::Text("Entries: %zu  Pages: %llu  Polls: %llu  Failed reads: %llu  Poll avg %.3f ms, max %.3f ms",
+            watch_.Count(), (unsigned long long)ws.pages, (unsigned long long)ws.polls, (unsigned long long)ws.readFailures,
+            (double)ws.pollAvgNs / 1e6, (double)ws.pollMaxNs / 1e6);
+        ImGui::SameLine();
+        if (ImGui::SmallButton("Clear")) { watch_.Clear(); watch_.Stop(); }
+
+        if (!ImGui::BeginTable("watch", 7, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersOuter | ImGuiTableFlags_ScrollY, ImVec2(0, 240))) return;
+        ImGui::TableSetupScrollFreeze(0, 1);
+        ImGui::TableSetupColumn("Address");
+        ImGui::TableSetupColumn("Value");
+        ImGui::TableSetupColumn("Min");
+        ImGui::TableSetupColumn("Max");
+        ImGui::TableSetupColumn("Changes");
+        ImGui::TableSetupColumn("Last change");
+        ImGui::TableSetupColumn("History");
+        ImGui::TableHeadersRow();
+        const uint64_t now = REKit::MemSearch::ScanStats::NowNs();
+        std::vector<double> hist;
+        std::vector<float> plot;
+        for (const auto& w : watch_.Entries()) {
+            ImGui::PushID((int)w.id);
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            if (ImGui::SmallButton("x")) watch_.Remove(w.id);
+            ImGui::SameLine(); ImGui::Text("0x%p", (void*)w.addr);
+            ImGui::TableNextColumn();
+            if (w.valid) ImGui::Text("%g", w.value); else ImGui::TextDisabled("??");
+            ImGui::TableNextColumn(); ImGui::Text("%g", w.min);
+            ImGui::TableNextColumn(); ImGui::Text("%g", w.max);
+            ImGui::TableNextColumn(); ImGui::Text("%llu", (unsigned long long)w.changes);
+            ImGui::TableNextColumn();
+            if (w.lastChangeNs) ImGui::Text("%.1f s ago", (double)(now - w.lastChangeNs) / 1e9); else ImGui::TextDisabled("-");
+            ImGui::TableNextColumn();
+            if (watch_.History(w.id, hist) && hist.size() > 1) {
+                plot.assign(hist.begin(), hist.end());
+                ImGui::PlotLines("##h", plot.data(), (int)plot.size(), 0, nullptr, FLT_MAX, FLT_MAX, ImVec2(-FLT_MIN, 0));
+            }
+            ImGui::PopID();
+        }
+        ImGui::EndTable();
+    }
+
+    void DrawFrozen() {
+        if (ImGui::InputInt("Period (us)", &freezePeriodUs_, 1000, 10000)) {
+            freezePeriodUs_ = (std::max)(freezePeriodUs_, 100);
+            freezer_.SetPeriod((unsigned)freezePeriodUs_);
+        }
+        const REKit::MemSearch::FreezeStats fs = freezer_.Stats();
+        ImGui::Text("PID %u %s  Ticks: %llu (missed %llu)  Spans: %llu  Failed writes: %llu",
+            freezer_.Pid(), freezer_.Running() ? "running" : "stopped",
+            (unsigned long long)fs.ticks, (unsigned long long)fs.missedTicks,
+            (unsigned long long)fs.spans, (unsigned long long)fs.writeFailures);
+        ImGui::Text("Jitter avg %.3f ms, max %.3f ms  Write %.3f ms/tick",
+            (double)fs.jitterAvgNs / 1e6, (double)fs.jitterMaxNs / 1e6, (double)fs.tickAvgNs / 1e6);
+        ImGui::SameLine();
+        if (ImGui::SmallButton("Reset stats")) freezer_.ResetStats();
+        ImGui::SameLine();
+        if (ImGui::SmallButton("Unfreeze all")) { freezer_.Clear(); freezer_.Stop(); }
+
+        for (const auto& e : freezer_.Entries()) {
+            char val[64];
+            if (e.type == ScanType::Int32 && e.bytes.size() == 4) { int32_t v; memcpy(&v, e.bytes.data(), 4); snprintf(val, sizeof(val), "%d", v); }
+            else if (e.type == ScanType::Float && e.bytes.size() == 4) { float v; memcpy(&v, e.bytes.data(), 4); snprintf(val, sizeof(val), "%g", v); }
+            else if (e.type == ScanType::Double && e.bytes.size() == 8) { double v; memcpy(&v, e.bytes.data(), 8); snprintf(val, sizeof(val), "%g", v); }
+            else snprintf(val, sizeof(val), "%zu bytes", e.bytes.size());
+            ImGui::PushID((int)e.id);
+            if (ImGui::SmallButton("x")) freezer_.Remove(e.id);
+            ImGui::SameLine();
+            ImGui::Text("0x%p = %s%s", (void*)e.addr, val, e.failures ? "  (write failing)" : "");
+            ImGui::PopID();
+        }
+    }
+
+    void DrawStats(const ScanStats& stats) {
+        const REKit::MemSearch::ScanStatsSnapshot s = stats.Snapshot();
+        const auto& t = s.total;
+        auto ms = [](uint64_t ns) { return (double)ns / 1e6; };
+        double mb = (double)t.bytesRead / (1024.0 * 1024.0);
+        ImGui::Text("Wall: %.1f ms%s", ms(s.wallNs), s.running ? " (running)" : "");
+        ImGui::Text("Enumerate: %.1f ms  Read: %.1f ms  Compare: %.1f ms (thread-summed)",
+            ms(s.enumerateNs), ms(t.readNs), ms(t.compareNs));
+        ImGui::Text("Bytes: %.1f / %.1f MB read  Reads: %llu (%llu failed)  Hits: %llu",
+            mb, (double)t.bytesRequested / (1024.0 * 1024.0),
+            (unsigned long long)t.readCalls, (unsigned long long)t.readFailures, (unsigned long long)t.hits);
+        if (t.bytesMapped) ImGui::Text("Mapped: %.1f MB scanned from module files", (double)t.bytesMapped / (1024.0 * 1024.0));
+        if (s.wallNs > 0) ImGui::Text("Throughput: %.1f MB/s", (mb + (double)t.bytesMapped / (1024.0 * 1024.0)) / ((double)s.wallNs / 1e9));
+
+        if (s.perThread.size() > 1 && ImGui::BeginTable("scanstats", 6, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersOuter)) {
+            ImGui::TableSetupColumn("Thread");
+            ImGui::TableSetupColumn("MB read");
+            ImGui::TableSetupColumn("Reads");
+            ImGui::TableSetupColumn("Failed");
+            ImGui::TableSetupColumn("Read ms");
+            ImGui::TableSetupColumn("Compare ms");
+            ImGui::TableHeadersRow();
+            for (auto& pt : s.perThread) {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn(); ImGui::Text("%u", pt.thread);
+                ImGui::TableNextColumn(); ImGui::Text("%.1f", (double)pt.bytesRead / (1024.0 * 1024.0));
+                ImGui::TableNextColumn(); ImGui::Text("%llu", (unsigned long long)pt.readCalls);
+                ImGui::TableNextColumn(); ImGui::Text("%llu", (unsigned long long)pt.readFailures);
+                ImGui::TableNextColumn(); ImGui::Text("%.1f", ms(pt.readNs));
+                ImGui::TableNextColumn(); ImGui::Text("%.1f", ms(pt.compareNs));
+            }
+            ImGui::EndTable();
+        }
+    }
+
+    void OpenCore() {
+        auto core = std::make_shared<REKit::MemSearch::CoreDumpSource>();
+        std::string err;
+        if (!core->Open(coreBuf_, &err)) { status_ = "Core dump: " + err; return; }
+        std::vector<REKit::MemSearch::Region> regs;
+        core->EnumReadableRegions(regs);
+        char msg[128];
+        snprintf(msg, sizeof(msg), "Core dump: %zu regions, %.1f MB", regs.size(), (double)core->DumpedBytes() / (1024.0 * 1024.0));
+        status_ = msg;
+        opt_.source = core;
     }
 
-    void PrepareOptions(int selPid) {
+    bool PrepareOptions(int selPid) {
         if (selPid > 0) opt_.pid = (unsigned)selPid;
         opt_.base = 0; opt_.length = 0;
         {
@@ -263,18 +914,24 @@ private:
         }
         opt_.hexExpr = hexBuf_;
         opt_.strExpr = strBuf_;
+        opt_.resultMemoryBudget = (size_t)budgetMb_ << 20;
+        if (opt_.type == ScanType::Group && !REKit::MemSearch::ParseGroupExpr(groupBuf_, opt_.group, &status_)) return false;
+        return true;
     }
 
+    // Scans run on the shared scheduler pool; PollJob() picks up the results.
     void LaunchFirstScan() {
-        status_ = "Scanning...";
-        progress_.store(0.0f);
-        REKit::MemSearch::StartFirstScan(opt_, results_, cancel_, progress_, status_);
+        resultsFromCore_ = opt_.source != nullptr;
+        job_ = ScanScheduler::Shared().SubmitFirstScan(opt_, priority_);
+        collected_ = false;
     }
 
     void LaunchNextScan() {
-        status_ = "Filtering...";
-        progress_.store(0.0f);
-        REKit::MemSearch::StartNextScan(opt_, prevResults_, results_, cancel_, progress_, status_);
+        ResultStore prev;
+        prev.Swap(results_);
+        if (opt_.source) resultsFromCore_ = true;
+        job_ = ScanScheduler::Shared().SubmitNextScan(opt_, std::move(prev), priority_);
+        collected_ = false;
     }
 };
 
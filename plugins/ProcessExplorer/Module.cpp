@@ -5,6 +5,7 @@
 #include <vector>
 #include <algorithm>
 #include <cstring>
+#include <cstdio>
 
 #include "plugins/IModule.h"
 #include "ui/UiRoot.h"
@@ -13,13 +14,14 @@
 #include "include/ntapi.h"
 #include "include/utils.h"
 #include "include/EnumProcessInfo.h"
+#include "include/ProcessSnapshot.h"
 #include "include/injector.h"
 
 extern char processKeyword[256];
 extern int g_selectedProcess;
 extern int g_selectedPid;
 extern std::wstring g_dllPathW;
-static std::vector<ProcessInfo> GetFilteredProcessList();
+static void FilterProcessList(const ProcessSnapshot& snapshot, std::vector<uint32_t>& out);
 
 namespace REKit {
     namespace Plugins {
@@ -56,16 +58,25 @@ namespace REKit {
                     static char lastKeyword[256] = "";
                     static ImGuiTableSortSpecs lastSortSpecs = {};
                     static bool hasSortSpecs = false;
+                    // filtered, sorted rows of viewSnapshot; rebuilt when a new poll
+                    // is published or the keyword changes, not every frame
+                    static ProcessSnapshotPtr viewSnapshot;
+                    static std::vector<uint32_t> filteredProcesses;
 
-                    if (std::strcmp(lastKeyword, processKeyword) != 0) {
+                    ProcessSnapshotPtr snapshot = GetProcessSnapshot();
+                    if (snapshot != viewSnapshot || std::strcmp(lastKeyword, processKeyword) != 0) {
                         strcpy_s(lastKeyword, processKeyword);
+                        viewSnapshot = snapshot;
+                        FilterProcessList(*viewSnapshot, filteredProcesses);
+                        if (hasSortSpecs) {
+                            SortProcessList(*viewSnapshot, filteredProcesses, &lastSortSpecs);
+                        }
                     }
-
-                    std::vector<ProcessInfo> filteredProcesses = GetFilteredProcessList();
-                    std::vector<ProcessInfo> currentProcesses = GetProcessList();
+                    const ProcessSnapshot& snap = *viewSnapshot;
+                    const StringArena& strings = snap.strings;
 
                     ImGui::Text("显示: %zu / %zu 个进程",
-                        filteredProcesses.size(), currentProcesses.size());
+                        filteredProcesses.size(), snap.Size());
                     ImGui::Separator();
 
                     const bool emptyAfterFilter =
@@ -75,10 +86,6 @@ namespace REKit {
                         ImGui::TextColored(ImVec4(1.0f, 0.5f, 0.5f, 1.0f), "未找到匹配的进程");
                     }
                     else {
-                        if (hasSortSpecs) {
-                            SortProcessList(filteredProcesses, &lastSortSpecs);
-                        }
-
                         if (ImGui::BeginTable("ProcessTable", 5,
                             ImGuiTableFlags_Resizable | ImGuiTableFlags_Sortable |
                             ImGuiTableFlags_ScrollY | ImGuiTableFlags_RowBg |
@@ -100,50 +107,59 @@ namespace REKit {
 
                             if (ImGuiTableSortSpecs* sort_specs = ImGui::TableGetSortSpecs()) {
                                 if (sort_specs->SpecsDirty) {
-                                    SortProcessList(filteredProcesses, sort_specs);
+                                    SortProcessList(snap, filteredProcesses, sort_specs);
                                     lastSortSpecs = *sort_specs;
                                     hasSortSpecs = true;
                                     sort_specs->SpecsDirty = false;
                                 }
                             }
 
-                            for (int i = 0; i < (int)filteredProcesses.size(); ++i) {
-                                const ProcessInfo& proc = filteredProcesses[i];
+                            // only the visible rows are submitted; strings come from the arena as is
+                            ImGuiListClipper clipper;
+                            clipper.Begin((int)filteredProcesses.size());
+                            while (clipper.Step()) for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i) {
+                                const uint32_t row = filteredProcesses[i];
+                                const ULONG pid = snap.pid[row];
+                                const char* processName = strings.Utf8(snap.name[row]);
 
+                                ImGui::PushID((int)pid);
                                 ImGui::TableNextRow();
                                 ImGui::TableNextColumn();
 
                                 const bool is_selected = (g_selectedProcess == i);
-                                std::string processName = WStringToString(proc.name);
-                                std::string uniqueLabel = processName + "##" + std::to_string(proc.pid);
-
-                                if (ImGui::Selectable(uniqueLabel.c_str(), is_selected,
+                                if (ImGui::Selectable(processName, is_selected,
                                     ImGuiSelectableFlags_SpanAllColumns)) {
                                     g_selectedProcess = i;
-                                    g_selectedPid = (int)proc.pid;
+                                    g_selectedPid = (int)pid;
                                 }
 
                                 if (ImGui::BeginPopupContextItem()) {
-                                    ImGui::Text("进程: %s (PID: %lu)", processName.c_str(), proc.pid);
+                                    ImGui::Text("进程: %s (PID: %lu)", processName, pid);
+                                    if (snap.userName[row]) ImGui::Text("用户: %s", strings.Utf8(snap.userName[row]));
+                                    if (snap.commandLine[row]) {
+                                        ImGui::PushTextWrapPos(ImGui::GetFontSize() * 40.0f);
+                                        ImGui::TextWrapped("命令行: %s", strings.Utf8(snap.commandLine[row]));
+                                        ImGui::PopTextWrapPos();
+                                    }
                                     ImGui::Separator();
                                     if (ImGui::MenuItem("结束进程")) {
-                                        TerminateProcessByPID(proc.pid);
+                                        TerminateProcessByPID(pid);
                                     }
                                     if (ImGui::MenuItem("打开文件位置")) {
-                                        std::wstring wImagePath = proc.imagePath;
-                                        if (!wImagePath.empty()) {
-                                            ShellExecuteW(NULL, L"open", L"explorer",
-                                                (L"/select,\"" + wImagePath + L"\"").c_str(),
+                                        if (snap.imagePath[row]) {
+                                            std::wstring args = std::wstring(L"/select,\"") + strings.Wide(snap.imagePath[row]) + L"\"";
+                                            ShellExecuteW(NULL, L"open", L"explorer", args.c_str(),
                                                 NULL, SW_SHOWNORMAL);
                                         }
                                     }
                                     ImGui::EndPopup();
                                 }
 
-                                ImGui::TableNextColumn(); ImGui::Text("%lu", proc.pid);
-                                ImGui::TableNextColumn(); ImGui::Text("%lu", proc.threads);
-                                ImGui::TableNextColumn(); ImGui::Text("%lu", proc.handles);
-                                ImGui::TableNextColumn(); ImGui::Text("%s", WStringToString(proc.imagePath).c_str());
+                                ImGui::TableNextColumn(); ImGui::Text("%lu", pid);
+                                ImGui::TableNextColumn(); ImGui::Text("%lu", snap.threads[row]);
+                                ImGui::TableNextColumn(); ImGui::Text("%lu", snap.handles[row]);
+                                ImGui::TableNextColumn(); ImGui::TextUnformatted(strings.Utf8(snap.imagePath[row]));
+                                ImGui::PopID();
                             }
 
                             ImGui::EndTable();
@@ -167,37 +183,28 @@ int g_selectedProcess = -1;
 int g_selectedPid = 0;
 std::wstring g_dllPathW = L"";
 
-static std::vector<ProcessInfo> GetFilteredProcessList() {
-    std::vector<ProcessInfo> currentProcesses = GetProcessList();
-    std::vector<ProcessInfo> filteredProcesses;
+static void FilterProcessList(const ProcessSnapshot& snapshot, std::vector<uint32_t>& out) {
+    out.clear();
 
     if (std::strlen(processKeyword) == 0) {
-        filteredProcesses = currentProcesses;
+        for (uint32_t row = 0; row < (uint32_t)snapshot.Size(); ++row) out.push_back(row);
     }
     else {
-        std::string keyword = processKeyword;
-        std::transform(keyword.begin(), keyword.end(), keyword.begin(), ::tolower);
-
-        for (const auto& proc : currentProcesses) {
-            bool match = false;
+        const std::string keyword = LowerAscii(processKeyword);
+        const StringArena& strings = snapshot.strings;
 
-            std::string name = WStringToString(proc.name);
-            std::transform(name.begin(), name.end(), name.begin(), ::tolower);
-            if (name.find(keyword) != std::string::npos) match = true;
+        for (uint32_t row = 0; row < (uint32_t)snapshot.Size(); ++row) {
+            bool match = std::strstr(strings.Lower(snapshot.name[row]), keyword.c_str()) != nullptr;
 
             if (!match) {
-                std::string pidStr = std::to_string(proc.pid);
-                if (pidStr.find(keyword) != std::string::npos) match = true;
+                char pidStr[16];
+                snprintf(pidStr, sizeof(pidStr), "%lu", (unsigned long)snapshot.pid[row]);
+                match = std::strstr(pidStr, keyword.c_str()) != nullptr;
             }
 
-            if (!match) {
-                std::string path = WStringToString(proc.imagePath);
-                std::transform(path.begin(), path.end(), path.begin(), ::tolower);
-                if (path.find(keyword) != std::string::npos) match = true;
-            }
+            if (!match) match = std::strstr(strings.Lower(snapshot.imagePath[row]), keyword.c_str()) != nullptr;
 
-            if (match) filteredProcesses.push_back(proc);
+            if (match) out.push_back(row);
         }
     }
-    return filteredProcesses;
 }
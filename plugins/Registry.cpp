@@ -9,4 +9,5 @@ namespace REKit { namespace Plugins {
     std::unique_ptr<IModule> CreateModuleEnum();
     std::unique_ptr<IModule> CreateMemSearch();
     std::unique_ptr<IModule> CreateInjector();
+    std::unique_ptr<IModule> CreateMemBrowser();
 }} // namespace
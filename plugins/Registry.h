@@ -19,5 +19,6 @@ namespace REKit {
         std::unique_ptr<IModule> CreateModuleEnum();
         std::unique_ptr<IModule> CreateMemSearch();
         std::unique_ptr<IModule> CreateInjector();
+        std::unique_ptr<IModule> CreateMemBrowser();
     }
 } // namespace
@@ -1,4 +1,5 @@
 #include "include/injector.h"
+#include "include/REKit/memsearch/ProcessAccess.h"
 
 BOOL ApcInject(DWORD pid, LPCWSTR dwDLLPath)
 {
@@ -22,8 +23,11 @@ BOOL ApcInject(DWORD pid, LPCWSTR dwDLLPath)
         (NTQUERYSYSTEMINFORMATION)GetProcAddress(hNtDll, "NtQuerySystemInformation");
     if (!NtQuerySystemInformation) return FALSE;
 
-    HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_OPERATION | PROCESS_VM_WRITE | PROCESS_VM_READ, FALSE, (DWORD)(ULONG_PTR)pid);
-    if (!hProcess) return FALSE;
+    // shared, cached handle; closed by ProcessAccess once unused. kWrite opens
+    // query + read + write + VM operation, all an APC injection needs.
+    auto process = REKit::MemSearch::ProcessAccess::Shared().Open((unsigned)pid, REKit::MemSearch::ProcessAccess::kWrite);
+    if (!process) return FALSE;
+    HANDLE hProcess = (HANDLE)process->Native();
 
     SIZE_T dllPathSize = (wcslen(dwDLLPath) + 1) * sizeof(WCHAR);
 
@@ -35,13 +39,11 @@ BOOL ApcInject(DWORD pid, LPCWSTR dwDLLPath)
         PAGE_READWRITE
     );
     if (!lpBaseAddress) {
-        CloseHandle(hProcess);
         return FALSE;
     }
 
     if (!WriteProcessMemory(hProcess, lpBaseAddress, dwDLLPath, dllPathSize, NULL)) {
         VirtualFreeEx(hProcess, lpBaseAddress, 0, MEM_RELEASE);
-        CloseHandle(hProcess);
         return FALSE;
     }
 
@@ -50,7 +52,6 @@ BOOL ApcInject(DWORD pid, LPCWSTR dwDLLPath)
 
     if (!pBuffer) {
         VirtualFreeEx(hProcess, lpBaseAddress, 0, MEM_RELEASE);
-        CloseHandle(hProcess);
         return FALSE;
     }
 
@@ -70,7 +71,6 @@ BOOL ApcInject(DWORD pid, LPCWSTR dwDLLPath)
             if (!pNewBuffer) {
                 free(pBuffer);
                 VirtualFreeEx(hProcess, lpBaseAddress, 0, MEM_RELEASE);
-                CloseHandle(hProcess);
                 return FALSE;
             }
             pBuffer = pNewBuffer;
@@ -83,7 +83,6 @@ BOOL ApcInject(DWORD pid, LPCWSTR dwDLLPath)
     if (status != 0) {
         free(pBuffer);
         VirtualFreeEx(hProcess, lpBaseAddress, 0, MEM_RELEASE);
-        CloseHandle(hProcess);
         return FALSE;
     }
 
@@ -113,7 +112,6 @@ BOOL ApcInject(DWORD pid, LPCWSTR dwDLLPath)
     if (!injected) {
         VirtualFreeEx(hProcess, lpBaseAddress, 0, MEM_RELEASE);
     }
-    CloseHandle(hProcess);
     return injected;
 }
 
@@ -144,6 +142,8 @@ static HANDLE RtlCreateUserThread(HANDLE hProcess, LPVOID lpBaseAddress, LPVOID
 
 
 BOOL RtlThreadInject(DWORD pid, LPCWSTR dwDLLPath) {
+    // own handle with only these rights: ProcessAccess handles also ask for
+    // query + read, which targets may not grant
     HANDLE hProcess = OpenProcess(PROCESS_CREATE_THREAD | PROCESS_VM_OPERATION | PROCESS_VM_WRITE, FALSE, pid);
     if (hProcess == NULL) return FALSE;
 
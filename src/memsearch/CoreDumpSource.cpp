@@ -0,0 +1,229 @@
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cstring>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "include/REKit/memsearch/CoreDumpSource.h"
+
+namespace REKit { namespace MemSearch {
+
+namespace {
+
+uint16_t Rd16(const uint8_t* p) { uint16_t v; memcpy(&v, p, 2); return v; }
+uint32_t Rd32(const uint8_t* p) { uint32_t v; memcpy(&v, p, 4); return v; }
+uint64_t Rd64(const uint8_t* p) { uint64_t v; memcpy(&v, p, 8); return v; }
+
+const uint32_t kNtFile = 0x46494C45;    // "FILE"
+
+bool Fail(std::string* err, const char* why) {
+    if (err) *err = why;
+    return false;
+}
+
+} // namespace
+
+CoreDumpSource::~CoreDumpSource() { Close(); }
+
+void CoreDumpSource::Close() {
+#ifdef _WIN32
+    if (view_) UnmapViewOfFile(view_);
+    if (mapping_) CloseHandle((HANDLE)mapping_);
+    if (file_) CloseHandle((HANDLE)file_);
+#else
+    if (view_) munmap(const_cast<uint8_t*>(view_), (size_t)size_);
+#endif
+    view_ = nullptr; mapping_ = nullptr; file_ = nullptr;
+    size_ = 0;
+    segs_.clear();
+    modules_.clear();
+    path_.clear();
+}
+
+bool CoreDumpSource::Open(const std::string& path, std::string* err) {
+    Close();
+    if (path.empty()) return Fail(err, "No file");
+#ifdef _WIN32
+    int n = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0);
+    if (n <= 0) return Fail(err, "Bad path");
+    std::wstring w(n - 1, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, &w[0], n);
+    HANDLE f = CreateFileW(w.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                           FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (f == INVALID_HANDLE_VALUE) return Fail(err, "Cannot open file");
+    file_ = f;
+    LARGE_INTEGER sz;
+    if (!GetFileSizeEx(f, &sz) || sz.QuadPart <= 0) { Close(); return Fail(err, "Empty file"); }
+    size_ = (uint64_t)sz.QuadPart;
+    mapping_ = CreateFileMappingW(f, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping_) { Close(); return Fail(err, "Cannot map file"); }
+    view_ = (const uint8_t*)MapViewOfFile((HANDLE)mapping_, FILE_MAP_READ, 0, 0, 0);
+#else
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return Fail(err, "Cannot open file");
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) { close(fd); return Fail(err, "Empty file"); }
+    size_ = (uint64_t)st.st_size;
+    void* v = mmap(nullptr, (size_t)size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    view_ = v == MAP_FAILED ? nullptr : (const uint8_t*)v;
+#endif
+    if (!view_) { Close(); return Fail(err, "Cannot map file"); }
+    if (!Parse(err)) { Close(); return false; }
+    path_ = path;
+    return true;
+}
+
+bool CoreDumpSource::Parse(std::string* err) {
+    const uint8_t* v = view_;
+    if (size_ < 0x34 || memcmp(v, "\x7F" "ELF", 4) != 0) return Fail(err, "Not an ELF file");
+    const bool is64 = v[4] == 2;
+    if (v[5] != 1) return Fail(err, "Big-endian cores are not supported");
+    if (Rd16(v + 16) != 4) return Fail(err, "Not a core file");     // ET_CORE
+    if (is64 && size_ < 0x40) return Fail(err, "Truncated ELF header");
+    uint64_t phoff = is64 ? Rd64(v + 0x20) : Rd32(v + 0x1C);
+    uint16_t phsize = Rd16(v + (is64 ? 0x36 : 0x2A));
+    uint16_t phnum = Rd16(v + (is64 ? 0x38 : 0x2C));
+    // sizeof(Elf64_Phdr) / sizeof(Elf32_Phdr); phoff is checked before it is added to, so it cannot wrap
+    if (phsize < (is64 ? 56u : 32u) || phoff > size_ || phnum > (size_ - phoff) / phsize) return Fail(err, "Bad program headers");
+
+    for (uint16_t i = 0; i < phnum; ++i) {
+        const uint8_t* p = v + phoff + (uint64_t)i * phsize;
+        const uint32_t type = Rd32(p);
+        uint64_t off, vaddr, filesz;
+        if (is64) { off = Rd64(p + 8); vaddr = Rd64(p + 16); filesz = Rd64(p + 32); }
+        else      { off = Rd32(p + 4); vaddr = Rd32(p + 8); filesz = Rd32(p + 16); }
+        if (off >= size_) continue;
+        filesz = (std::min)(filesz, size_ - off);     // truncated dump; off + filesz stays within the file
+        if (type == 1) {            // PT_LOAD
+            if (filesz && vaddr + filesz > vaddr && vaddr + filesz - 1 <= (uintptr_t)-1)
+                segs_.push_back({ (uintptr_t)vaddr, (size_t)filesz, off, 0 });
+        }
+        else if (type == 4) {       // PT_NOTE
+            const uint8_t* n = v + off;
+            const uint8_t* end = n + filesz;
+            while (end - n >= 12) {
+                uint32_t namesz = Rd32(n), descsz = Rd32(n + 4), ntype = Rd32(n + 8);
+                const uint64_t nameLen = ((uint64_t)namesz + 3) & ~3ull;
+                if (nameLen > (uint64_t)(end - n) - 12) break;
+                const uint8_t* desc = n + 12 + nameLen;
+                if (descsz > (uint64_t)(end - desc)) break;
+                if (ntype == kNtFile && namesz == 5 && memcmp(n + 12, "CORE", 5) == 0) ParseFileNote(desc, descsz, is64);
+                const uint64_t descLen = ((uint64_t)descsz + 3) & ~3ull;
+                if (descLen >= (uint64_t)(end - desc)) break;
+                n = desc + descLen;
+            }
+        }
+    }
+    if (segs_.empty()) return Fail(err, "No memory in the core file");
+
+    std::sort(segs_.begin(), segs_.end(), [](const Segment& a, const Segment& b) { return a.base < b.base; });
+    std::vector<Segment> kept;
+    for (auto& s : segs_) {
+        if (!kept.empty() && s.base < kept.back().base + kept.back().size) continue;   // overlapping: keep the first
+        kept.push_back(s);
+    }
+    segs_.swap(kept);
+    // runs of adjacent segments, so scans read overlap across segment boundaries
+    for (size_t i = segs_.size(); i-- > 0;) {
+        uintptr_t end = segs_[i].base + segs_[i].size;
+        segs_[i].runEnd = (i + 1 < segs_.size() && segs_[i + 1].base == end) ? segs_[i + 1].runEnd : end;
+    }
+    return true;
+}
+
+// NT_FILE: count, page size, count x (start, end, file offset in pages), then count NUL-terminated paths.
+void CoreDumpSource::ParseFileNote(const uint8_t* desc, uint64_t size, bool is64) {
+    const uint64_t word = is64 ? 8 : 4;
+    auto rd = [&](uint64_t at) { return is64 ? Rd64(desc + at) : Rd32(desc + at); };
+    if (size < word * 2) return;
+    const uint64_t count = rd(0);
+    if (count > (size - word * 2) / (word * 3)) return;
+    const char* names = (const char*)desc + word * 2 + count * word * 3;
+    const char* namesEnd = (const char*)desc + size;
+    for (uint64_t i = 0; i < count && names < namesEnd; ++i) {
+        const uint64_t start = rd(word * 2 + i * word * 3), end = rd(word * 2 + i * word * 3 + word);
+        const char* name = names;
+        const char* nul = (const char*)memchr(name, 0, namesEnd - name);
+        if (!nul) break;
+        names = nul + 1;
+        if (end <= start) continue;
+        std::string path(name, nul);
+        // consecutive mappings of one file form one module, as for a live process
+        if (!modules_.empty() && modules_.back().path == path && modules_.back().base + modules_.back().size <= (uintptr_t)start) {
+            modules_.back().size = (size_t)((uintptr_t)end - modules_.back().base);
+            continue;
+        }
+        ModuleInfo m;
+        m.base = (uintptr_t)start;
+        m.size = (size_t)(end - start);
+        size_t slash = path.find_last_of('/');
+        m.name = slash == std::string::npos ? path : path.substr(slash + 1);
+        m.path = std::move(path);
+        modules_.push_back(std::move(m));
+    }
+}
+
+size_t CoreDumpSource::Find(uintptr_t addr) const {
+    auto it = std::upper_bound(segs_.begin(), segs_.end(), addr, [](uintptr_t a, const Segment& s) { return a < s.base; });
+    if (it == segs_.begin()) return segs_.size();
+    --it;
+    return addr - it->base < it->size ? (size_t)(it - segs_.begin()) : segs_.size();
+}
+
+size_t CoreDumpSource::Read(uintptr_t addr, void* dst, size_t n) const {
+    size_t i = Find(addr);
+    size_t done = 0;
+    while (done < n && i < segs_.size()) {
+        const Segment& s = segs_[i];
+        uintptr_t at = addr + done;
+        if (at < s.base || at - s.base >= s.size) break;
+        size_t k = (std::min)(n - done, (size_t)(s.base + s.size - at));
+        memcpy((uint8_t*)dst + done, view_ + s.off + (at - s.base), k);
+        done += k;
+        ++i;
+    }
+    return done;
+}
+
+void CoreDumpSource::EnumReadableRegions(std::vector<Region>& out, uintptr_t clipBase, uintptr_t clipEnd) const {
+    out.clear();
+    for (auto& s : segs_) {
+        uintptr_t b = s.base, e = s.base + s.size;
+        if (clipEnd > clipBase) {
+            if (e <= clipBase || b >= clipEnd) continue;
+            b = (std::max)(b, clipBase); e = (std::min)(e, clipEnd);
+        }
+        if (e <= b) continue;
+        uintptr_t limit = s.runEnd;
+        if (clipEnd > clipBase) limit = (std::min)(limit, clipEnd);
+        out.push_back({ b, (size_t)(e - b), view_ + s.off + (b - s.base), limit });
+    }
+}
+
+bool CoreDumpSource::QueryRegion(uintptr_t addr, RegionInfo& out) const {
+    auto it = std::upper_bound(segs_.begin(), segs_.end(), addr, [](uintptr_t a, const Segment& s) { return a < s.base; });
+    if (it != segs_.begin() && addr - (it - 1)->base < (it - 1)->size) {
+        out = { (it - 1)->base, (it - 1)->size, true };
+        return true;
+    }
+    if (it == segs_.end()) return false;
+    uintptr_t lo = it == segs_.begin() ? 0 : (it - 1)->base + (it - 1)->size;
+    out = { lo, (size_t)(it->base - lo), false };
+    return true;
+}
+
+uint64_t CoreDumpSource::DumpedBytes() const {
+    uint64_t n = 0;
+    for (auto& s : segs_) n += s.size;
+    return n;
+}
+
+}} // namespace
@@ -0,0 +1,137 @@
+#include <vector>
+#include <string>
+#include <atomic>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "include/REKit/memsearch/Entropy.h"
+#include "include/REKit/memsearch/RegionWalker.h"
+
+namespace REKit { namespace MemSearch {
+
+// Byte histogram over n <= 64KB bytes. Bytes are pulled 8 at a time from one
+// 64-bit load and spread across four sub-histograms, so runs of equal bytes do
+// not serialize on a single counter (store-to-load forwarding stalls); the
+// sub-histograms are folded at the end.
+static void HistogramPage(const uint8_t* p, size_t n, uint32_t* out256) {
+    uint16_t h[4][256];
+    memset(h, 0, sizeof(h));
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        uint64_t w; memcpy(&w, p + i, sizeof(w));
+        ++h[0][(uint8_t)(w      )]; ++h[1][(uint8_t)(w >>  8)];
+        ++h[2][(uint8_t)(w >> 16)]; ++h[3][(uint8_t)(w >> 24)];
+        ++h[0][(uint8_t)(w >> 32)]; ++h[1][(uint8_t)(w >> 40)];
+        ++h[2][(uint8_t)(w >> 48)]; ++h[3][(uint8_t)(w >> 56)];
+    }
+    for (; i < n; ++i) ++h[i & 3][p[i]];
+    for (int b = 0; b < 256; ++b)
+        out256[b] = (uint32_t)h[0][b] + h[1][b] + h[2][b] + h[3][b];
+}
+
+float ShannonEntropy(const uint64_t* hist256, uint64_t total) {
+    if (total == 0) return 0.f;
+    double h = 0.0, inv = 1.0 / (double)total;
+    for (int b = 0; b < 256; ++b) {
+        if (!hist256[b]) continue;
+        double p = (double)hist256[b] * inv;
+        h -= p * std::log2(p);
+    }
+    return (float)h;
+}
+
+void AnalyzeEntropy(const EntropyOptions& opt, EntropyReport& report, std::atomic<bool>& cancel, std::atomic<float>& progress, std::string& status) {
+    report.regions.clear();
+    size_t page = opt.pageSize;
+    if (page < 256 || page > (1 << 16) || (page & (page - 1))) { status = "Invalid page size"; return; }
+    report.pageSize = page;
+
+    ProcessMemory mem(opt.pid);
+    if (!mem.IsOpen()) { status = "OpenProcess failed"; return; }
+    std::vector<Region> regs;
+    mem.EnumReadableRegions(regs, opt.length > 0 ? opt.base : 0, opt.length > 0 ? opt.base + opt.length : 0);
+    if (regs.empty()) { status = "No readable regions"; return; }
+
+    report.regions.resize(regs.size());
+    for (size_t i = 0; i < regs.size(); ++i) {
+        RegionEntropy& re = report.regions[i];
+        re.base = regs[i].base;
+        re.size = regs[i].size;
+        re.pageEntropy.assign((regs[i].size + page - 1) / page, -1.f);
+    }
+
+    // c*log2(c) for every count a page can produce; page entropy is then
+    // log2(n) - sum(c*log2(c))/n without a log per bucket.
+    std::vector<float> clog(page + 1);
+    clog[0] = 0.f;
+    for (size_t c = 1; c <= page; ++c) clog[c] = (float)((double)c * std::log2((double)c));
+
+    WalkOptions wo;
+    wo.chunkSize = (std::max)(wo.chunkSize, page);
+    wo.threads = opt.threads;
+    std::vector<Stripe> stripes = PlanStripes(regs, wo.stripeSize);
+    std::vector<std::array<uint64_t, 256>> stripeHist(stripes.size());
+    std::vector<uint64_t> stripeBytes(stripes.size(), 0);
+    for (auto& h : stripeHist) h.fill(0);
+
+    status = "Analyzing...";
+    progress = 0.f;
+    WalkStripes(mem, stripes, wo, cancel, progress, [&](const ChunkView& v) {
+        RegionEntropy& re = report.regions[v.region];
+        std::array<uint64_t, 256>& acc = stripeHist[v.stripe];
+        uint32_t ph[256];
+        size_t firstPage = (size_t)(v.addr - re.base) / page;
+        for (size_t off = 0, pi = firstPage; off < v.ownedSize; off += page, ++pi) {
+            size_t n = (std::min)(page, v.ownedSize - off);
+            HistogramPage(v.data + off, n, ph);
+            float sum = 0.f;
+            for (int b = 0; b < 256; ++b) { sum += clog[ph[b]]; acc[b] += ph[b]; }
+            float h = (float)std::log2((double)n) - sum / (float)n;
+            re.pageEntropy[pi] = h < 0.f ? 0.f : h;
+        }
+        stripeBytes[v.stripe] += v.ownedSize;
+    });
+
+    for (size_t si = 0; si < stripes.size(); ++si) {
+        RegionEntropy& re = report.regions[stripes[si].region];
+        for (int b = 0; b < 256; ++b) re.histogram[b] += stripeHist[si][b];
+        re.bytesRead += stripeBytes[si];
+    }
+    for (auto& re : report.regions) re.entropy = ShannonEntropy(re.histogram.data(), re.bytesRead);
+    status = cancel ? "Canceled" : "Done";
+}
+
+EntropyHeatMap BuildEntropyHeatMap(const EntropyReport& report, size_t maxCells) {
+    EntropyHeatMap map;
+    size_t totalPages = 0;
+    for (auto& re : report.regions) totalPages += re.pageEntropy.size();
+    if (totalPages == 0) return map;
+    if (maxCells == 0) maxCells = 1;
+    map.pagesPerCell = (totalPages + maxCells - 1) / maxCells;
+
+    const size_t page = report.pageSize;
+    for (auto& re : report.regions) {
+        const size_t np = re.pageEntropy.size();
+        for (size_t p0 = 0; p0 < np; p0 += map.pagesPerCell) {
+            size_t p1 = (std::min)(np, p0 + map.pagesPerCell);
+            float sum = 0.f, mx = -1.f;
+            size_t readable = 0;
+            for (size_t p = p0; p < p1; ++p) {
+                float e = re.pageEntropy[p];
+                if (e < 0.f) continue;
+                sum += e; ++readable;
+                mx = (std::max)(mx, e);
+            }
+            EntropyHeatCell c;
+            c.base = re.base + p0 * page;
+            c.size = (std::min)(re.size, p1 * page) - p0 * page;
+            c.mean = readable ? sum / (float)readable : -1.f;
+            c.max  = mx;
+            map.cells.push_back(c);
+        }
+    }
+    return map;
+}
+
+}} // namespace
@@ -0,0 +1,219 @@
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#ifdef _WIN32
+#include <windows.h>
+#include <timeapi.h>
+#pragma comment(lib, "winmm.lib")
+#endif
+
+#include "include/REKit/memsearch/Freezer.h"
+
+namespace REKit { namespace MemSearch {
+
+static constexpr uintptr_t kPageSize = 4096;
+
+FreezeEntry MakeFreezeBytes(uintptr_t addr, const void* data, size_t n, ScanType type) {
+    FreezeEntry e;
+    e.addr = addr;
+    e.type = type;
+    e.bytes.assign((const uint8_t*)data, (const uint8_t*)data + n);
+    return e;
+}
+
+FreezeEntry MakeFreezeInt32(uintptr_t addr, int32_t v) { return MakeFreezeBytes(addr, &v, sizeof(v), ScanType::Int32); }
+FreezeEntry MakeFreezeFloat(uintptr_t addr, float v) { return MakeFreezeBytes(addr, &v, sizeof(v), ScanType::Float); }
+FreezeEntry MakeFreezeDouble(uintptr_t addr, double v) { return MakeFreezeBytes(addr, &v, sizeof(v), ScanType::Double); }
+
+Freezer::Freezer() {}
+
+Freezer::~Freezer() { Stop(); }
+
+bool Freezer::Start(unsigned pid, unsigned periodUs) {
+    Stop();
+    std::unique_ptr<ProcessMemory> mem(new ProcessMemory(pid, true));
+    if (!mem->Writable()) return false;
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        mem_ = std::move(mem);
+        pid_ = pid;
+        stop_ = false;
+        dirty_ = true;
+    }
+    SetPeriod(periodUs);
+    running_ = true;
+    thread_ = std::thread(&Freezer::Run, this);
+    return true;
+}
+
+void Freezer::Stop() {
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) thread_.join();
+    running_ = false;
+    mem_.reset();
+}
+
+void Freezer::SetPeriod(unsigned periodUs) {
+    periodUs_ = (std::max)(periodUs, 100u);
+    cv_.notify_all();
+}
+
+uint64_t Freezer::Add(FreezeEntry e) {
+    if (e.bytes.empty()) return 0;
+    std::lock_guard<std::mutex> lk(mu_);
+    const uint64_t id = nextId_++;
+    e.id = id;
+    e.failures = 0;
+    auto it = std::upper_bound(entries_.begin(), entries_.end(), e.addr,
+        [](uintptr_t a, const FreezeEntry& x) { return a < x.addr; });
+    entries_.insert(it, std::move(e));
+    dirty_ = true;
+    return id;
+}
+
+bool Freezer::Remove(uint64_t id) {
+    std::lock_guard<std::mutex> lk(mu_);
+    auto it = std::find_if(entries_.begin(), entries_.end(), [&](const FreezeEntry& x) { return x.id == id; });
+    if (it == entries_.end()) return false;
+    entries_.erase(it);
+    dirty_ = true;
+    return true;
+}
+
+bool Freezer::SetValue(uint64_t id, const void* data, size_t n) {
+    std::lock_guard<std::mutex> lk(mu_);
+    auto it = std::find_if(entries_.begin(), entries_.end(), [&](const FreezeEntry& x) { return x.id == id; });
+    if (it == entries_.end() || n == 0) return false;
+    it->bytes.assign((const uint8_t*)data, (const uint8_t*)data + n);
+    dirty_ = true;
+    return true;
+}
+
+void Freezer::Clear() {
+    std::lock_guard<std::mutex> lk(mu_);
+    entries_.clear();
+    dirty_ = true;
+}
+
+size_t Freezer::Count() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return entries_.size();
+}
+
+std::vector<FreezeEntry> Freezer::Entries() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return entries_;
+}
+
+FreezeStats Freezer::Stats() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    FreezeStats s = stats_;
+    if (s.ticks) {
+        s.jitterAvgNs = jitterSumNs_ / s.ticks;
+        s.tickAvgNs = tickSumNs_ / s.ticks;
+    }
+    return s;
+}
+
+void Freezer::ResetStats() {
+    std::lock_guard<std::mutex> lk(mu_);
+    uint64_t spans = stats_.spans;
+    stats_ = FreezeStats();
+    stats_.spans = spans;
+    jitterSumNs_ = tickSumNs_ = 0;
+}
+
+// Merges touching entries into spans over one flat image, then cuts spans at
+// page boundaries so one protected page only fails its own piece.
+void Freezer::RebuildLocked() {
+    image_.clear();
+    spans_.clear();
+    std::vector<Span> merged;
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        const FreezeEntry& e = entries_[i];
+        if (merged.empty() || e.addr > merged.back().addr + merged.back().size) {
+            merged.push_back({ e.addr, image_.size(), 0, i, i });
+        }
+        Span& s = merged.back();
+        size_t rel = (size_t)(e.addr - s.addr);
+        size_t end = (std::max)(s.size, rel + e.bytes.size());
+        image_.resize(s.off + end);
+        memcpy(image_.data() + s.off + rel, e.bytes.data(), e.bytes.size());  // later entries win on overlap
+        s.size = end;
+        s.last = i;
+    }
+    for (const Span& s : merged) {
+        uintptr_t cur = s.addr, end = s.addr + s.size;
+        while (cur < end) {
+            uintptr_t pageEnd = (cur & ~(kPageSize - 1)) + kPageSize;
+            size_t n = (size_t)((std::min)(end, pageEnd) - cur);
+            spans_.push_back({ cur, s.off + (size_t)(cur - s.addr), n, s.first, s.last });
+            cur += n;
+        }
+    }
+    stats_.spans = spans_.size();
+    dirty_ = false;
+}
+
+void Freezer::Run() {
+    using Clock = std::chrono::steady_clock;
+#ifdef _WIN32
+    timeBeginPeriod(1);     // default 15.6ms timer resolution is too coarse for ms periods
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_ABOVE_NORMAL);
+#endif
+    std::vector<WriteSpan> batch;
+    std::vector<char> failed;
+    auto deadline = Clock::now();
+    std::unique_lock<std::mutex> lk(mu_);
+    for (;;) {
+        auto period = std::chrono::microseconds(periodUs_.load());
+        deadline += period;
+        cv_.wait_until(lk, deadline, [&] { return stop_; });
+        if (stop_) break;
+        auto woke = Clock::now();
+        uint64_t late = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(woke - deadline).count();
+
+        if (dirty_) RebuildLocked();
+        lk.unlock();
+
+        batch.resize(spans_.size());
+        for (size_t i = 0; i < spans_.size(); ++i) batch[i] = { spans_[i].addr, image_.data() + spans_[i].off, spans_[i].size };
+        size_t bad = batch.empty() ? 0 : mem_->WriteBatch(batch.data(), batch.size(), &failed);
+        auto wrote = Clock::now();
+
+        lk.lock();
+        FreezeStats& s = stats_;
+        ++s.ticks;
+        s.writeCalls += batch.empty() ? 0 : 1;
+        s.writeFailures += bad;
+        for (auto& w : batch) s.bytesWritten += w.size;
+        jitterSumNs_ += late;
+        s.jitterMaxNs = (std::max)(s.jitterMaxNs, late);
+        tickSumNs_ += (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(wrote - woke).count();
+        if (bad && !dirty_) {
+            // entries_ still matches spans_ unless it changed while writing
+            for (size_t i = 0; i < failed.size(); ++i) {
+                if (!failed[i]) continue;
+                for (size_t k = spans_[i].first; k <= spans_[i].last && k < entries_.size(); ++k) entries_[k].failures++;
+            }
+        }
+
+        // an overrun skips the deadlines it missed instead of bursting to catch up
+        auto now = Clock::now();
+        if (now > deadline + period) {
+            uint64_t missed = (uint64_t)((now - deadline) / period);
+            s.missedTicks += missed;
+            deadline += period * (long long)missed;
+        }
+    }
+#ifdef _WIN32
+    timeEndPeriod(1);
+#endif
+}
+
+}} // namespace
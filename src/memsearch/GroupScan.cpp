@@ -0,0 +1,286 @@
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <cctype>
+
+#include "include/REKit/memsearch/GroupScan.h"
+#include "include/REKit/memsearch/ScanKernels.h"
+
+namespace REKit { namespace MemSearch {
+
+template <class T> static void Encode(GroupTerm& t, T v) {
+    t.pat.resize(sizeof(T));
+    memcpy(t.pat.data(), &v, sizeof(T));
+    t.mask.assign(sizeof(T), 0xFF);
+}
+
+static bool ParseTerm(const std::string& tok, GroupTerm& t) {
+    size_t colon = tok.find(':');
+    if (colon == std::string::npos || colon + 1 >= tok.size()) return false;
+    std::string kind = tok.substr(0, colon);
+    for (char& c : kind) c = (char)tolower((unsigned char)c);
+    const std::string val = tok.substr(colon + 1);
+    const char* s = val.c_str();
+    char* end = nullptr;
+    errno = 0;
+
+    if (kind == "hex") {
+        t.type = GroupTermType::Bytes;
+        return ParseHexWithMask(val, t.pat, t.mask);
+    }
+    if (kind == "f32" || kind == "f64") {
+        double d = strtod(s, &end);
+        if (end == s || *end || errno) return false;
+        if (kind == "f32") { t.type = GroupTermType::Float;  Encode(t, (float)d); }
+        else               { t.type = GroupTermType::Double; Encode(t, d); }
+        return true;
+    }
+    int bits = 0;
+    bool sign = false;
+    if (kind.size() >= 2 && (kind[0] == 'i' || kind[0] == 'u') && kind.find_first_not_of("0123456789", 1) == std::string::npos) {
+        sign = kind[0] == 'i';
+        bits = atoi(kind.c_str() + 1);
+    }
+    if (bits != 8 && bits != 16 && bits != 32 && bits != 64) return false;
+    uint64_t u;
+    if (sign) {
+        long long v = strtoll(s, &end, 0);
+        if (end == s || *end || errno) return false;
+        if (bits < 64) {
+            long long lim = 1LL << (bits - 1);
+            if (v < -lim || v >= lim) return false;
+        }
+        u = (uint64_t)v;
+    }
+    else {
+        if (*s == '-') return false;
+        u = strtoull(s, &end, 0);
+        if (end == s || *end || errno) return false;
+        if (bits < 64 && (u >> bits)) return false;
+    }
+    switch (bits) {
+    case 8:  t.type = GroupTermType::Int8;  Encode(t, (uint8_t)u);  break;
+    case 16: t.type = GroupTermType::Int16; Encode(t, (uint16_t)u); break;
+    case 32: t.type = GroupTermType::Int32; Encode(t, (uint32_t)u); break;
+    default: t.type = GroupTermType::Int64; Encode(t, u);           break;
+    }
+    return true;
+}
+
+bool ParseGroupExpr(const std::string& src, GroupScanSpec& spec, std::string* error) {
+    spec.terms.clear();
+    std::string tok;
+    for (size_t i = 0; i <= src.size(); ++i) {
+        char c = i < src.size() ? src[i] : ' ';
+        if (!isspace((unsigned char)c) && c != ',') { tok.push_back(c); continue; }
+        if (tok.empty()) continue;
+        GroupTerm t;
+        if (!ParseTerm(tok, t)) {
+            if (error) *error = "Invalid group term: " + tok;
+            spec.terms.clear();
+            return false;
+        }
+        spec.terms.push_back(std::move(t));
+        tok.clear();
+    }
+    if (spec.terms.empty()) { if (error) *error = "Group is empty"; return false; }
+    return true;
+}
+
+// Rough per-byte selectivity: zero and 0xFF fill most memory, small values are next.
+static int ByteWeight(uint8_t b) {
+    if (b == 0x00) return 1;
+    if (b == 0xFF) return 2;
+    if (b < 0x10) return 3;
+    return 8;
+}
+
+bool GroupMatcher::Compile(const GroupScanSpec& spec, size_t alignment) {
+    terms_ = spec.terms;
+    window_ = spec.window;
+    ordered_ = spec.ordered;
+    align_ = alignment ? alignment : 1;
+    if (terms_.empty()) return false;
+
+    size_t need = 0;
+    int best = -1;
+    for (size_t i = 0; i < terms_.size(); ++i) {
+        const GroupTerm& t = terms_[i];
+        if (t.pat.empty() || t.pat.size() != t.mask.size()) return false;
+        need = ordered_ ? need + t.pat.size() : (std::max)(need, t.pat.size());
+        int score = 0;
+        for (size_t k = 0; k < t.pat.size(); ++k) if (t.mask[k] == 0xFF) score += ByteWeight(t.pat[k]);
+        if (score > best) { best = score; anchor_ = i; }
+    }
+    if (window_ < need) return false;
+
+    // memchr on the anchor byte least likely to occur; -1 if the anchor is all wildcards
+    const GroupTerm& a = terms_[anchor_];
+    int rare = -1;
+    for (size_t k = 0; k < a.pat.size(); ++k) {
+        if (a.mask[k] != 0xFF) continue;
+        if (rare < 0 || ByteWeight(a.pat[k]) > ByteWeight(a.pat[(size_t)rare])) rare = (int)k;
+    }
+    rareOff_ = rare < 0 ? (size_t)-1 : (size_t)rare;
+    rareByte_ = rare < 0 ? 0 : a.pat[(size_t)rare];
+    return true;
+}
+
+bool GroupMatcher::TermAt(size_t t, const uint8_t* buf, size_t n, size_t pos, uintptr_t baseAddr) const {
+    const GroupTerm& g = terms_[t];
+    if (pos + g.pat.size() > n || (baseAddr + pos) % align_) return false;
+    for (size_t k = 0; k < g.pat.size(); ++k) {
+        if ((buf[pos + k] & g.mask[k]) != (g.pat[k] & g.mask[k])) return false;
+    }
+    return true;
+}
+
+// Terms before the anchor are placed as late as possible and terms after it as
+// early as possible, which gives the tightest span if any placement fits.
+bool GroupMatcher::Ordered(const uint8_t* buf, size_t n, size_t a, uintptr_t baseAddr, size_t& start) const {
+    const size_t aEnd = a + terms_[anchor_].pat.size();
+    const size_t lo = aEnd > window_ ? aEnd - window_ : 0;
+    size_t limit = a;
+    for (size_t t = anchor_; t-- > 0; ) {
+        const size_t m = terms_[t].pat.size();
+        if (limit < lo + m) return false;
+        size_t p = limit - m;
+        for (;; --p) {
+            if (TermAt(t, buf, n, p, baseAddr)) break;
+            if (p == lo) return false;
+        }
+        limit = p;
+    }
+    start = limit;
+    const size_t bound = (std::min)(n, start + window_);
+    size_t cur = aEnd;
+    for (size_t t = anchor_ + 1; t < terms_.size(); ++t) {
+        const size_t m = terms_[t].pat.size();
+        size_t p = cur;
+        for (; p + m <= bound; ++p) if (TermAt(t, buf, n, p, baseAddr)) break;
+        if (p + m > bound) return false;
+        cur = p + m;
+    }
+    return true;
+}
+
+// Smallest window start that covers the anchor and one occurrence of every term.
+bool GroupMatcher::Unordered(const uint8_t* buf, size_t n, size_t a, uintptr_t baseAddr, size_t& start,
+                             std::vector<std::vector<size_t>>& occ) const {
+    const size_t aEnd = a + terms_[anchor_].pat.size();
+    const size_t lo = aEnd > window_ ? aEnd - window_ : 0;
+    const size_t hi = (std::min)(n, a + window_);
+    std::vector<size_t> cand(1, a);
+    for (size_t t = 0; t < terms_.size(); ++t) {
+        std::vector<size_t>& o = occ[t];
+        o.clear();
+        if (t == anchor_) continue;
+        const size_t m = terms_[t].pat.size();
+        for (size_t p = lo; p + m <= hi; ++p) if (TermAt(t, buf, n, p, baseAddr)) o.push_back(p);
+        if (o.empty()) return false;
+        for (size_t p : o) if (p < a) cand.push_back(p);
+    }
+    std::sort(cand.begin(), cand.end());
+    for (size_t s : cand) {
+        bool ok = true;
+        for (size_t t = 0; t < terms_.size() && ok; ++t) {
+            if (t == anchor_) continue;
+            const size_t m = terms_[t].pat.size();
+            auto it = std::lower_bound(occ[t].begin(), occ[t].end(), s);
+            ok = (it != occ[t].end() && *it + m <= s + window_);
+        }
+        if (ok && Distinct(occ, s, s + window_, anchor_, a)) { start = s; return true; }
+    }
+    return false;
+}
+
+// Gives every term its own occurrence in [lo, hi), term fixed at fixedPos, so
+// one occurrence cannot stand for two identical terms. Bipartite matching by
+// augmenting paths; occ[t] is ascending and occ[fixed] is not used.
+bool GroupMatcher::Distinct(const std::vector<std::vector<size_t>>& occ, size_t lo, size_t hi, size_t fixed, size_t fixedPos) const {
+    std::unordered_map<size_t, size_t> owner;   // offset -> term
+    std::unordered_set<size_t> seen;
+    std::function<bool(size_t)> place = [&](size_t t) {
+        const size_t m = terms_[t].pat.size();
+        for (auto it = std::lower_bound(occ[t].begin(), occ[t].end(), lo); it != occ[t].end() && *it + m <= hi; ++it) {
+            const size_t p = *it;
+            if (p == fixedPos || !seen.insert(p).second) continue;
+            auto o = owner.find(p);
+            if (o == owner.end() || place(o->second)) { owner[p] = t; return true; }
+        }
+        return false;
+    };
+    for (size_t t = 0; t < terms_.size(); ++t) {
+        if (t == fixed) continue;
+        seen.clear();
+        if (!place(t)) return false;
+    }
+    return true;
+}
+
+void GroupMatcher::Search(const uint8_t* buf, size_t n, size_t owned, uintptr_t baseAddr, std::vector<uintptr_t>& out) const {
+    if (terms_.empty()) return;
+    const size_t am = terms_[anchor_].pat.size();
+    if (n < am) return;
+    // anchors past this cannot belong to a group starting in the owned range
+    const size_t aEnd = (std::min)(n - am + 1, owned + window_ - am);
+    std::vector<std::vector<size_t>> occ(terms_.size());
+    size_t last = (size_t)-1;
+
+    auto tryAnchor = [&](size_t a) {
+        if (!TermAt(anchor_, buf, n, a, baseAddr)) return;
+        size_t s = 0;
+        bool hit = ordered_ ? Ordered(buf, n, a, baseAddr, s) : Unordered(buf, n, a, baseAddr, s, occ);
+        // starts never decrease with the anchor, so duplicates are adjacent
+        if (hit && s < owned && s != last) { out.push_back(baseAddr + s); last = s; }
+    };
+
+    if (rareOff_ == (size_t)-1) {
+        for (size_t a = 0; a < aEnd; ++a) tryAnchor(a);
+        return;
+    }
+    const uint8_t* p = buf + rareOff_;
+    const uint8_t* end = buf + aEnd + rareOff_;
+    while (p < end) {
+        const uint8_t* q = (const uint8_t*)memchr(p, rareByte_, (size_t)(end - p));
+        if (!q) break;
+        tryAnchor((size_t)(q - buf) - rareOff_);
+        p = q + 1;
+    }
+}
+
+bool GroupMatcher::MatchAt(const uint8_t* buf, size_t n, uintptr_t addr) const {
+    if (terms_.empty()) return false;
+    n = (std::min)(n, window_);
+    if (ordered_) {
+        if (!TermAt(0, buf, n, 0, addr)) return false;
+        size_t cur = terms_[0].pat.size();
+        for (size_t t = 1; t < terms_.size(); ++t) {
+            const size_t m = terms_[t].pat.size();
+            size_t p = cur;
+            for (; p + m <= n; ++p) if (TermAt(t, buf, n, p, addr)) break;
+            if (p + m > n) return false;
+            cur = p + m;
+        }
+        return true;
+    }
+    std::vector<std::vector<size_t>> occ(terms_.size());
+    for (size_t t = 0; t < terms_.size(); ++t) {
+        const size_t m = terms_[t].pat.size();
+        for (size_t p = 0; p + m <= n; ++p) if (TermAt(t, buf, n, p, addr)) occ[t].push_back(p);
+        if (occ[t].empty()) return false;
+    }
+    // some term has to start the group
+    for (size_t t = 0; t < terms_.size(); ++t) {
+        if (occ[t][0] == 0 && Distinct(occ, 0, n, t, 0)) return true;
+    }
+    return false;
+}
+
+}} // namespace
@@ -0,0 +1,282 @@
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cstring>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "include/REKit/memsearch/ModuleImage.h"
+
+namespace REKit { namespace MemSearch {
+
+namespace {
+
+const uint64_t kPage = 0x1000;
+
+uint16_t Rd16(const uint8_t* p) { uint16_t v; memcpy(&v, p, 2); return v; }
+uint32_t Rd32(const uint8_t* p) { uint32_t v; memcpy(&v, p, 4); return v; }
+uint64_t Rd64(const uint8_t* p) { uint64_t v; memcpy(&v, p, 8); return v; }
+
+} // namespace
+
+ModuleImage::~ModuleImage() { Close(); }
+
+void ModuleImage::Close() {
+#ifdef _WIN32
+    if (view_) UnmapViewOfFile(view_);
+    if (mapping_) CloseHandle((HANDLE)mapping_);
+    if (file_) CloseHandle((HANDLE)file_);
+#else
+    if (view_) munmap(const_cast<uint8_t*>(view_), (size_t)size_);
+#endif
+    view_ = nullptr; mapping_ = nullptr; file_ = nullptr;
+    size_ = 0;
+    spans_.clear();
+}
+
+bool ModuleImage::Open(const IMemorySource& mem, const ModuleInfo& mod, bool baseIndependent) {
+    Close();
+    if (mod.path.empty()) return false;
+#ifdef _WIN32
+    int n = MultiByteToWideChar(CP_UTF8, 0, mod.path.c_str(), -1, nullptr, 0);
+    if (n <= 0) return false;
+    std::wstring w(n - 1, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, mod.path.c_str(), -1, &w[0], n);
+    HANDLE f = CreateFileW(w.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                           nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (f == INVALID_HANDLE_VALUE) return false;
+    file_ = f;
+    LARGE_INTEGER sz;
+    if (!GetFileSizeEx(f, &sz) || sz.QuadPart <= 0) { Close(); return false; }
+    size_ = (uint64_t)sz.QuadPart;
+    mapping_ = CreateFileMappingW(f, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping_) { Close(); return false; }
+    view_ = (const uint8_t*)MapViewOfFile((HANDLE)mapping_, FILE_MAP_READ, 0, 0, 0);
+#else
+    int fd = open(mod.path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) { close(fd); return false; }
+    size_ = (uint64_t)st.st_size;
+    void* v = mmap(nullptr, (size_t)size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    view_ = v == MAP_FAILED ? nullptr : (const uint8_t*)v;
+#endif
+    if (!view_) { Close(); return false; }
+
+    bool ok = false;
+    if (size_ >= 0x40 && view_[0] == 'M' && view_[1] == 'Z') ok = LayoutPe(mod.base, baseIndependent);
+    else if (size_ >= 0x40 && memcmp(view_, "\x7F" "ELF", 4) == 0) ok = LayoutElf(mod.base);
+    if (!ok) { Close(); return false; }
+
+    // Trust a span only if its first page matches the target.
+    std::vector<uint8_t> page(kPage);
+    std::vector<Region> kept;
+    for (auto& s : spans_) {
+        size_t n = (size_t)(std::min<uint64_t>)(s.size, kPage - (s.base & (kPage - 1)));
+        if (mem.Read(s.base, page.data(), n) == n && memcmp(page.data(), s.local, n) == 0) kept.push_back(s);
+    }
+    spans_.swap(kept);
+    if (spans_.empty()) { Close(); return false; }
+    return true;
+}
+
+void ModuleImage::AddSpan(uintptr_t addr, uint64_t fileOff, uint64_t size) {
+    if (size == 0 || fileOff >= size_) return;
+    size = (std::min)(size, size_ - fileOff);
+    if (!spans_.empty() && spans_.back().base + spans_.back().size == addr
+        && spans_.back().local + spans_.back().size == view_ + fileOff) {
+        spans_.back().size += (size_t)size;
+        return;
+    }
+    Region r;
+    r.base = addr;
+    r.size = (size_t)size;
+    r.local = view_ + fileOff;
+    spans_.push_back(r);
+}
+
+bool ModuleImage::LayoutPe(uintptr_t base, bool baseIndependent) {
+    const uint8_t* v = view_;
+    uint32_t nt = Rd32(v + 0x3C);
+    if ((uint64_t)nt + 24 > size_ || memcmp(v + nt, "PE\0\0", 4) != 0) return false;
+    uint16_t sections = Rd16(v + nt + 6);
+    uint16_t optSize = Rd16(v + nt + 20);
+    const uint64_t opt = nt + 24;
+    if (opt + optSize > size_ || optSize < 2) return false;
+    const bool pe64 = Rd16(v + opt) == 0x20B;
+    if (optSize < (pe64 ? 112u : 96u)) return false;
+    const uint64_t imageBase = pe64 ? Rd64(v + opt + 24) : Rd32(v + opt + 28);
+    const uint32_t dirCount = Rd32(v + opt + (pe64 ? 108 : 92));
+    const uint64_t dirs = opt + (pe64 ? 112 : 96);
+    const uint64_t sect = opt + optSize;
+    if (sect + (uint64_t)sections * 40 > size_) return false;
+
+    auto rvaToFile = [&](uint32_t rva, uint64_t& off) {
+        for (uint16_t i = 0; i < sections; ++i) {
+            const uint8_t* s = v + sect + (uint64_t)i * 40;
+            uint32_t va = Rd32(s + 12), raw = Rd32(s + 16), ptr = Rd32(s + 20);
+            if (rva >= va && rva < va + raw) { off = (uint64_t)ptr + (rva - va); return off < size_; }
+        }
+        return false;
+    };
+
+    // Pages the loader rewrote.
+    std::vector<uint32_t> rewritten;
+    auto addPages = [&](uint64_t rva, uint64_t len) {
+        if (!len || rva + len > 0xFFFFFFFFull) return;
+        for (uint64_t pg = rva & ~(kPage - 1); pg < rva + len; pg += kPage) rewritten.push_back((uint32_t)pg);
+    };
+
+    // Import address table: filled with the resolved imports at every load,
+    // usually inside .rdata.
+    if (dirCount > 12 && dirs + 13 * 8 <= size_) addPages(Rd32(v + dirs + 12 * 8), Rd32(v + dirs + 12 * 8 + 4));
+
+    // Load config: the directory itself and the pointer slots it names (CFG/XFG
+    // check and dispatch functions, security cookie, ...), which the loader sets.
+    if (dirCount > 10 && dirs + 11 * 8 <= size_) {
+        uint32_t rva = Rd32(v + dirs + 10 * 8), len = Rd32(v + dirs + 10 * 8 + 4);
+        uint64_t off = 0;
+        if (len && rvaToFile(rva, off) && off + 4 <= size_) {
+            addPages(rva, len);
+            const uint64_t have = (std::min<uint64_t>)(Rd32(v + off), size_ - off);
+            const unsigned ptr = pe64 ? 8 : 4;
+            // IMAGE_LOAD_CONFIG_DIRECTORY64 / 32 offsets of SecurityCookie, GuardCFCheckFunctionPointer,
+            // GuardCFDispatchFunctionPointer, GuardRFFailureRoutineFunctionPointer,
+            // GuardRFVerifyStackPointerFunctionPointer, GuardXFGCheck/Dispatch/TableDispatchFunctionPointer,
+            // CastGuardOsDeterminedFailureMode, GuardMemcpyFunctionPointer
+            static const uint16_t slots64[] = { 0x58, 0x70, 0x78, 0xD8, 0xE8, 0x118, 0x120, 0x128, 0x130, 0x138 };
+            static const uint16_t slots32[] = { 0x3C, 0x48, 0x4C, 0x84, 0x90, 0xAC, 0xB0, 0xB4, 0xB8, 0xBC };
+            for (size_t i = 0; i < sizeof(slots64) / sizeof(slots64[0]); ++i) {
+                const uint64_t field = pe64 ? slots64[i] : slots32[i];
+                if (field + ptr > have) break;
+                const uint64_t va = pe64 ? Rd64(v + off + field) : Rd32(v + off + field);
+                if (va > imageBase) addPages(va - imageBase, ptr);
+            }
+        }
+    }
+
+    // Base relocations; only applied away from the preferred base.
+    if ((baseIndependent || (uint64_t)base != imageBase) && dirCount > 5 && dirs + 6 * 8 <= size_) {
+        uint32_t rva = Rd32(v + dirs + 5 * 8), len = Rd32(v + dirs + 5 * 8 + 4);
+        uint64_t off = 0;
+        if (len && rvaToFile(rva, off)) {
+            uint64_t end = (std::min)(off + len, size_);
+            while (off + 8 <= end) {
+                uint32_t page = Rd32(v + off), block = Rd32(v + off + 4);
+                if (block < 8 || off + block > end) break;
+                bool any = false, spill = false;
+                for (uint64_t e = off + 8; e + 2 <= off + block; e += 2) {
+                    uint16_t x = Rd16(v + e);
+                    if ((x >> 12) == 0) continue;   // IMAGE_REL_BASED_ABSOLUTE padding
+                    any = true;
+                    if ((x & 0xFFF) > 0xFF8) spill = true;
+                }
+                if (any) rewritten.push_back(page);
+                if (spill) rewritten.push_back(page + (uint32_t)kPage);
+                off += block;
+            }
+        }
+    }
+    std::sort(rewritten.begin(), rewritten.end());
+
+    for (uint16_t i = 0; i < sections; ++i) {
+        const uint8_t* s = v + sect + (uint64_t)i * 40;
+        uint32_t vsize = Rd32(s + 8), va = Rd32(s + 12), raw = Rd32(s + 16), ptr = Rd32(s + 20), ch = Rd32(s + 36);
+        if ((ch & 0x80000000u) || !(ch & 0x40000000u)) continue;   // IMAGE_SCN_MEM_WRITE / IMAGE_SCN_MEM_READ
+        uint64_t len = vsize ? (std::min)(vsize, raw) : raw;
+        // split around rewritten pages
+        uint64_t cur = va, end = (uint64_t)va + len;
+        while (cur < end) {
+            uint64_t stop = end;
+            auto it = std::lower_bound(rewritten.begin(), rewritten.end(), (uint32_t)(cur & ~(kPage - 1)));
+            if (it != rewritten.end() && *it < end) stop = (std::max<uint64_t>)(*it, cur);
+            AddSpan(base + (uintptr_t)cur, (uint64_t)ptr + (cur - va), stop - cur);
+            if (stop == end) break;
+            cur = (stop & ~(kPage - 1)) + kPage;
+        }
+    }
+    return true;
+}
+
+bool ModuleImage::LayoutElf(uintptr_t base) {
+    const uint8_t* v = view_;
+    const bool is64 = v[4] == 2;
+    if (v[5] != 1) return false;    // little-endian only
+    uint64_t phoff = is64 ? Rd64(v + 0x20) : Rd32(v + 0x1C);
+    uint16_t phsize = Rd16(v + (is64 ? 0x36 : 0x2A));
+    uint16_t phnum = Rd16(v + (is64 ? 0x38 : 0x2C));
+    if (phsize < (is64 ? 56u : 32u) || phoff + (uint64_t)phsize * phnum > size_) return false;
+
+    struct Load { uint32_t flags; uint64_t off, vaddr, filesz; };
+    std::vector<Load> loads;
+    for (uint16_t i = 0; i < phnum; ++i) {
+        const uint8_t* p = v + phoff + (uint64_t)i * phsize;
+        if (Rd32(p) != 1) continue;     // PT_LOAD
+        Load l;
+        if (is64) { l.flags = Rd32(p + 4); l.off = Rd64(p + 8); l.vaddr = Rd64(p + 16); l.filesz = Rd64(p + 32); }
+        else      { l.flags = Rd32(p + 24); l.off = Rd32(p + 4); l.vaddr = Rd32(p + 8); l.filesz = Rd32(p + 16); }
+        loads.push_back(l);
+    }
+    if (loads.empty()) return false;
+    // the module base is the start of the lowest mapping
+    uint64_t lowest = loads[0].vaddr;
+    for (auto& l : loads) lowest = (std::min)(lowest, l.vaddr);
+    const uintptr_t bias = base - (uintptr_t)(lowest & ~(kPage - 1));
+    for (auto& l : loads) {
+        if (l.flags & 2) continue;      // PF_W
+        AddSpan(bias + (uintptr_t)l.vaddr, l.off, l.filesz);
+    }
+    return true;
+}
+
+size_t ModuleImageSet::Open(const IMemorySource& mem) {
+    images_.clear();
+    std::vector<ModuleInfo> mods;
+    mem.EnumModules(mods);
+    for (auto& m : mods) {
+        std::unique_ptr<ModuleImage> img(new ModuleImage());
+        if (img->Open(mem, m)) images_.push_back(std::move(img));
+    }
+    return images_.size();
+}
+
+void ModuleImageSet::Overlay(std::vector<Region>& regs) const {
+    std::vector<Region> spans;
+    for (auto& img : images_) spans.insert(spans.end(), img->Spans().begin(), img->Spans().end());
+    if (spans.empty()) return;
+    std::sort(spans.begin(), spans.end(), [](const Region& a, const Region& b) { return a.base < b.base; });
+
+    std::vector<Region> out;
+    out.reserve(regs.size() + spans.size() * 2);
+    size_t j = 0;
+    for (const Region& r : regs) {
+        uintptr_t cur = r.base, end = r.base + r.size;
+        uintptr_t limit = (std::max)(end, r.limit);     // pieces keep reading overlap across each other
+        while (j < spans.size() && spans[j].base + spans[j].size <= cur) ++j;
+        for (size_t k = j; k < spans.size() && spans[k].base < end && cur < end; ++k) {
+            const Region& s = spans[k];
+            uintptr_t sb = (std::max)(s.base, cur), se = (std::min)(s.base + s.size, end);
+            if (se <= sb) continue;
+            if (sb > cur) out.push_back({ cur, (size_t)(sb - cur), r.local ? r.local + (cur - r.base) : nullptr, limit });
+            out.push_back({ sb, (size_t)(se - sb), s.local + (sb - s.base), limit });
+            cur = se;
+        }
+        if (cur < end) out.push_back({ cur, (size_t)(end - cur), r.local ? r.local + (cur - r.base) : nullptr, limit });
+    }
+    regs.swap(out);
+}
+
+size_t ModuleImageSet::MappedBytes() const {
+    size_t n = 0;
+    for (auto& img : images_) for (auto& s : img->Spans()) n += s.size;
+    return n;
+}
+
+}} // namespace
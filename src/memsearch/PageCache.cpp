@@ -0,0 +1,196 @@
+#include <vector>
+#include <algorithm>
+#include <cstring>
+
+#include "include/REKit/memsearch/PageCache.h"
+#include "include/REKit/memsearch/ScanStats.h"
+
+namespace REKit { namespace MemSearch {
+
+namespace {
+
+const size_t kBatchPages = 256;         // pages per worker pass
+const size_t kMaxSpanPages = 16;        // adjacent pages merged into one read, up to this many
+const size_t kMaxPrefetch = 4096;       // queued prefetches; older ones are dropped
+
+} // namespace
+
+PageCache::PageCache(std::shared_ptr<const IMemorySource> mem, size_t capacityPages)
+    : mem_(std::move(mem)), capacity_((std::max)(capacityPages, (size_t)64)) {
+    worker_ = std::thread([this] { Run(); });
+}
+
+PageCache::~PageCache() {
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    if (worker_.joinable()) worker_.join();
+}
+
+bool PageCache::Queue(uintptr_t page, bool demand) {
+    uint8_t& st = queued_[page];
+    if (st == kInFlight || st == kDemand || (st == kPrefetch && !demand)) return false;
+    // a prefetch promoted to demand leaves a stale entry in prefetch_, skipped by the worker
+    st = demand ? kDemand : kPrefetch;
+    (demand ? demand_ : prefetch_).push_back(page);
+    return true;
+}
+
+std::shared_ptr<const CachedPage> PageCache::Get(uintptr_t pageAddr, uint64_t refreshNs) {
+    pageAddr &= ~(uintptr_t)(kPage - 1);
+    std::shared_ptr<const CachedPage> p;
+    bool wake = false;
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        auto it = pages_.find(pageAddr);
+        if (it != pages_.end()) {
+            lru_.splice(lru_.begin(), lru_, it->second.lru);
+            p = it->second.page;
+            ++stats_.hits;
+            if (refreshNs && ScanStats::NowNs() - p->readNs >= refreshNs) wake = Queue(pageAddr, true);
+        }
+        else {
+            ++stats_.misses;
+            wake = Queue(pageAddr, true);
+        }
+    }
+    if (wake) cv_.notify_one();
+    return p;
+}
+
+void PageCache::Prefetch(uintptr_t addr, size_t n) {
+    if (n == 0) return;
+    uintptr_t first = addr & ~(uintptr_t)(kPage - 1);
+    uintptr_t last = (addr + n - 1) & ~(uintptr_t)(kPage - 1);
+    bool wake = false;
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        for (uintptr_t p = first; p <= last && p >= first; p += kPage) {
+            if (!pages_.count(p) && Queue(p, false)) wake = true;
+        }
+        if (prefetch_.size() > kMaxPrefetch) {
+            size_t drop = prefetch_.size() - kMaxPrefetch;
+            for (size_t i = 0; i < drop; ++i) {
+                auto it = queued_.find(prefetch_[i]);
+                if (it != queued_.end() && it->second == kPrefetch) queued_.erase(it);
+            }
+            prefetch_.erase(prefetch_.begin(), prefetch_.begin() + drop);
+        }
+    }
+    if (wake) cv_.notify_one();
+}
+
+void PageCache::Store(std::shared_ptr<const CachedPage> p) {
+    const uintptr_t addr = p->addr;
+    auto it = pages_.find(addr);
+    if (it != pages_.end()) {
+        it->second.page = std::move(p);
+        return;
+    }
+    lru_.push_front(addr);
+    pages_[addr] = { std::move(p), lru_.begin() };
+    while (pages_.size() > capacity_) {
+        pages_.erase(lru_.back());
+        lru_.pop_back();
+        ++stats_.evictions;
+    }
+}
+
+void PageCache::Clear() {
+    std::lock_guard<std::mutex> lk(mu_);
+    pages_.clear();
+    lru_.clear();
+}
+
+PageCacheStats PageCache::Stats() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    PageCacheStats s = stats_;
+    s.pages = pages_.size();
+    return s;
+}
+
+void PageCache::Run() {
+    std::vector<uintptr_t> take;
+    std::vector<ReadSpan> spans;
+    std::vector<char> failed;
+    std::vector<std::shared_ptr<CachedPage>> fresh;
+    std::vector<size_t> first;
+    std::vector<uint8_t> buf;
+    std::unique_lock<std::mutex> lk(mu_);
+    for (;;) {
+        cv_.wait(lk, [&] { return stop_ || !demand_.empty() || !prefetch_.empty(); });
+        if (stop_) break;
+
+        // newest demand first, then the oldest prefetches
+        take.clear();
+        auto claim = [&](uintptr_t p, uint8_t want) {
+            auto it = queued_.find(p);
+            if (it == queued_.end() || it->second != want) return;
+            it->second = kInFlight;
+            take.push_back(p);
+        };
+        while (!demand_.empty() && take.size() < kBatchPages) {
+            claim(demand_.back(), kDemand);
+            demand_.pop_back();
+        }
+        size_t pre = 0;
+        while (pre < prefetch_.size() && take.size() < kBatchPages) claim(prefetch_[pre++], kPrefetch);
+        prefetch_.erase(prefetch_.begin(), prefetch_.begin() + pre);
+        if (take.empty()) continue;
+
+        // previous copies, for change highlighting
+        std::sort(take.begin(), take.end());
+        fresh.resize(take.size());
+        for (size_t i = 0; i < take.size(); ++i) {
+            auto np = std::make_shared<CachedPage>();
+            np->addr = take[i];
+            auto it = pages_.find(take[i]);
+            if (it != pages_.end() && it->second.page->ok) {
+                np->prev.reset(new uint8_t[kPage]);
+                memcpy(np->prev.get(), it->second.page->data, kPage);
+            }
+            fresh[i] = std::move(np);
+        }
+        lk.unlock();
+
+        // adjacent pages read as one span; a failed span is retried page by page
+        spans.clear();
+        first.clear();
+        buf.resize(take.size() * kPage);
+        for (size_t i = 0; i < take.size(); ++i) {
+            if (!spans.empty() && take[i] == spans.back().addr + spans.back().size && spans.back().size < kMaxSpanPages * kPage)
+                spans.back().size += kPage;
+            else {
+                spans.push_back({ take[i], buf.data() + i * kPage, kPage });
+                first.push_back(i);
+            }
+        }
+        mem_->ReadBatch(spans.data(), spans.size(), &failed);
+        uint64_t failures = 0;
+        const uint64_t now = ScanStats::NowNs();
+        for (size_t s = 0; s < spans.size(); ++s) {
+            size_t n = spans[s].size / kPage;
+            for (size_t k = 0; k < n; ++k) {
+                size_t i = first[s] + k;
+                CachedPage& p = *fresh[i];
+                p.ok = !failed[s] || (n > 1 && mem_->Read(take[i], buf.data() + i * kPage, kPage) == kPage);
+                if (p.ok) memcpy(p.data, buf.data() + i * kPage, kPage);
+                else { memset(p.data, 0, kPage); ++failures; }
+                p.readNs = now;
+            }
+        }
+
+        lk.lock();
+        for (size_t i = 0; i < fresh.size(); ++i) {
+            queued_.erase(take[i]);
+            Store(std::move(fresh[i]));
+        }
+        stats_.reads += take.size();
+        stats_.batches += 1;
+        stats_.readFailures += failures;
+    }
+}
+
+}} // namespace
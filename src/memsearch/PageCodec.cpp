@@ -0,0 +1,110 @@
+#include <cstring>
+
+#include "include/REKit/memsearch/PageCodec.h"
+
+namespace REKit { namespace MemSearch {
+
+namespace {
+
+const size_t kMinMatch = 4;
+const unsigned kHashBits = 12;
+
+uint32_t Rd32(const uint8_t* p) { uint32_t v; memcpy(&v, p, 4); return v; }
+uint32_t Hash4(uint32_t v) { return (v * 2654435761u) >> (32 - kHashBits); }
+
+// 15 in the nibble, then the rest in bytes of up to 255.
+bool PutLength(uint8_t*& op, const uint8_t* end, size_t len) {
+    for (; len >= 255; len -= 255) {
+        if (op >= end) return false;
+        *op++ = 255;
+    }
+    if (op >= end) return false;
+    *op++ = (uint8_t)len;
+    return true;
+}
+
+bool PutSequence(uint8_t*& op, const uint8_t* end, const uint8_t* lit, size_t litLen, size_t offset, size_t matchLen) {
+    if (op >= end) return false;
+    uint8_t* token = op++;
+    const size_t ml = matchLen ? matchLen - kMinMatch : 0;
+    *token = (uint8_t)(((litLen < 15 ? litLen : 15) << 4) | (ml < 15 ? ml : 15));
+    if (litLen >= 15 && !PutLength(op, end, litLen - 15)) return false;
+    if (litLen > (size_t)(end - op)) return false;
+    memcpy(op, lit, litLen);
+    op += litLen;
+    if (!matchLen) return true;
+    if (end - op < 2) return false;
+    *op++ = (uint8_t)offset;
+    *op++ = (uint8_t)(offset >> 8);
+    if (ml >= 15 && !PutLength(op, end, ml - 15)) return false;
+    return true;
+}
+
+bool GetLength(const uint8_t*& ip, const uint8_t* end, size_t& len) {
+    uint8_t b;
+    do {
+        if (ip >= end) return false;
+        b = *ip++;
+        len += b;
+    } while (b == 255);
+    return true;
+}
+
+} // namespace
+
+size_t LzCompress(const uint8_t* src, size_t n, uint8_t* dst, size_t cap) {
+    if (n > kLzMaxBlock) return 0;
+    int32_t table[1 << kHashBits];
+    memset(table, 0xFF, sizeof(table));
+    uint8_t* op = dst;
+    const uint8_t* end = dst + cap;
+    size_t ip = 0, anchor = 0;
+    while (ip + kMinMatch <= n) {
+        const uint32_t h = Hash4(Rd32(src + ip));
+        const int32_t cand = table[h];
+        table[h] = (int32_t)ip;
+        if (cand < 0 || Rd32(src + cand) != Rd32(src + ip)) {
+            ip += 1 + ((ip - anchor) >> 6);     // skip faster through data that does not compress
+            continue;
+        }
+        size_t len = kMinMatch;
+        while (ip + len < n && src[cand + len] == src[ip + len]) ++len;
+        if (!PutSequence(op, end, src + anchor, ip - anchor, ip - (size_t)cand, len)) return 0;
+        ip += len;
+        anchor = ip;
+        if (ip >= 2 && ip + kMinMatch <= n) table[Hash4(Rd32(src + ip - 2))] = (int32_t)(ip - 2);
+    }
+    if (!PutSequence(op, end, src + anchor, n - anchor, 0, 0)) return 0;
+    return (size_t)(op - dst);
+}
+
+size_t LzDecompress(const uint8_t* src, size_t n, uint8_t* dst, size_t cap) {
+    const uint8_t* ip = src;
+    const uint8_t* end = src + n;
+    size_t op = 0;
+    while (ip < end) {
+        const uint8_t token = *ip++;
+        size_t lit = token >> 4;
+        if (lit == 15 && !GetLength(ip, end, lit)) return 0;
+        if (lit > (size_t)(end - ip) || lit > cap - op) return 0;
+        memcpy(dst + op, ip, lit);
+        ip += lit;
+        op += lit;
+        if (ip == end) break;
+        if (end - ip < 2) return 0;
+        const size_t offset = ip[0] | ((size_t)ip[1] << 8);
+        ip += 2;
+        size_t len = token & 15;
+        if (len == 15 && !GetLength(ip, end, len)) return 0;
+        len += kMinMatch;
+        if (offset == 0 || offset > op || len > cap - op) return 0;
+        uint8_t* d = dst + op;
+        const uint8_t* s = d - offset;
+        if (offset >= len) memcpy(d, s, len);
+        else for (size_t i = 0; i < len; ++i) d[i] = s[i];     // overlapping: repeats the last offset bytes
+        op += len;
+    }
+    return op;
+}
+
+}} // namespace
@@ -0,0 +1,354 @@
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <mutex>
+#include <cstring>
+
+#include "include/REKit/memsearch/PageSnapshot.h"
+#include "include/REKit/memsearch/PageCodec.h"
+#include "include/REKit/memsearch/RegionWalker.h"
+#include "include/REKit/memsearch/ScanStats.h"
+
+namespace REKit { namespace MemSearch {
+
+namespace {
+
+std::atomic<uint64_t> g_storeSerial{1};
+
+uint64_t Mix(uint64_t h) {
+    h ^= h >> 33; h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33; h *= 0xC4CEB9FE1A85EC53ull;
+    return h ^ (h >> 33);
+}
+
+bool IsZeroPage(const uint8_t* p) {
+    for (size_t i = 0; i < PageStore::kPage; i += 64) {
+        uint64_t w[8];
+        memcpy(w, p + i, 64);
+        if (w[0] | w[1] | w[2] | w[3] | w[4] | w[5] | w[6] | w[7]) return false;
+    }
+    return true;
+}
+
+template <typename T> bool WriteVal(FILE* f, const T& v) { return fwrite(&v, sizeof(v), 1, f) == 1; }
+template <typename T> bool ReadVal(FILE* f, T& v) { return fread(&v, sizeof(v), 1, f) == 1; }
+
+const char kStoreMagic[8] = { 'R', 'K', 'P', 'A', 'G', 'E', 'S', '1' };
+const char kSnapMagic[8]  = { 'R', 'K', 'S', 'N', 'A', 'P', '0', '1' };
+
+} // namespace
+
+PageStore::PageStore() : serial_(g_storeSerial.fetch_add(1)) {}
+
+// Two independent 64-bit lanes over the page's words; a collision would merge two pages.
+PageStore::Key PageStore::HashPage(const uint8_t* page) {
+    uint64_t a = 0x243F6A8885A308D3ull, b = 0x13198A2E03707344ull;
+    for (size_t i = 0; i < kPage; i += 8) {
+        uint64_t w;
+        memcpy(&w, page + i, 8);
+        a = (a ^ w) * 0x9E3779B97F4A7C15ull; a ^= a >> 29;
+        b = (b + w) * 0xC2B2AE3D27D4EB4Full; b ^= b >> 31;
+    }
+    return { Mix(a), Mix(b ^ a) };
+}
+
+uint32_t PageStore::Append(const Key& key, const uint8_t* data, size_t len, bool raw) {
+    if (chunkUsed_ + len > kChunk) {
+        chunks_.emplace_back(new uint8_t[kChunk]);
+        chunkUsed_ = 0;
+    }
+    memcpy(chunks_.back().get() + chunkUsed_, data, len);
+    entries_.push_back({ key, (uint32_t)(chunks_.size() - 1), (uint32_t)chunkUsed_, (uint32_t)len, raw ? 1u : 0u });
+    chunkUsed_ += len;
+    stored_ += len;
+    uint32_t id = (uint32_t)entries_.size();
+    index_.emplace(key, id);
+    return id;
+}
+
+uint32_t PageStore::Put(const uint8_t* page, bool* dup) {
+    if (dup) *dup = false;
+    if (IsZeroPage(page)) return kZero;
+    const Key key = HashPage(page);
+    {
+        std::shared_lock<std::shared_mutex> lk(mu_);
+        auto it = index_.find(key);
+        if (it != index_.end()) {
+            if (dup) *dup = true;
+            return it->second;
+        }
+    }
+    // compress outside the lock; only pages that shrink are kept compressed
+    uint8_t buf[kPage];
+    size_t len = LzCompress(page, kPage, buf, kPage - 1);
+    std::unique_lock<std::shared_mutex> lk(mu_);
+    auto it = index_.find(key);     // another worker may have added it meanwhile
+    if (it != index_.end()) {
+        if (dup) *dup = true;
+        return it->second;
+    }
+    return len ? Append(key, buf, len, false) : Append(key, page, kPage, true);
+}
+
+bool PageStore::Get(uint32_t id, uint8_t* out) const {
+    if (id == kZero) { memset(out, 0, kPage); return true; }
+    const uint8_t* p;
+    Entry e;
+    {
+        std::shared_lock<std::shared_mutex> lk(mu_);
+        if (id == kMissing || id > entries_.size()) return false;
+        e = entries_[id - 1];
+        p = chunks_[e.chunk].get() + e.off;     // chunks never move, safe to read unlocked
+    }
+    if (e.raw) { memcpy(out, p, kPage); return true; }
+    return LzDecompress(p, e.len, out, kPage) == kPage;
+}
+
+size_t PageStore::Pages() const {
+    std::shared_lock<std::shared_mutex> lk(mu_);
+    return entries_.size();
+}
+
+uint64_t PageStore::StoredBytes() const {
+    std::shared_lock<std::shared_mutex> lk(mu_);
+    return stored_;
+}
+
+uint64_t PageStore::MemoryBytes() const {
+    std::shared_lock<std::shared_mutex> lk(mu_);
+    return (uint64_t)chunks_.size() * kChunk + entries_.capacity() * sizeof(Entry) +
+           index_.size() * (sizeof(Key) + sizeof(uint32_t) + 2 * sizeof(void*)) + index_.bucket_count() * sizeof(void*);
+}
+
+// magic, page count, then per page its key, length and raw flag followed by its bytes
+bool PageStore::Save(FILE* f) const {
+    std::shared_lock<std::shared_mutex> lk(mu_);
+    if (fwrite(kStoreMagic, 1, 8, f) != 8 || !WriteVal(f, (uint64_t)entries_.size())) return false;
+    for (auto& e : entries_) {
+        if (!WriteVal(f, e.key.a) || !WriteVal(f, e.key.b) || !WriteVal(f, e.len) || !WriteVal(f, e.raw)) return false;
+        if (fwrite(chunks_[e.chunk].get() + e.off, 1, e.len, f) != e.len) return false;
+    }
+    return true;
+}
+
+bool PageStore::Load(FILE* f) {
+    std::unique_lock<std::shared_mutex> lk(mu_);
+    entries_.clear(); chunks_.clear(); index_.clear();
+    chunkUsed_ = kChunk;
+    stored_ = 0;
+    serial_ = g_storeSerial.fetch_add(1);
+    char magic[8];
+    uint64_t count;
+    if (fread(magic, 1, 8, f) != 8 || memcmp(magic, kStoreMagic, 8) != 0 || !ReadVal(f, count)) return false;
+    if (count >= kMissing) return false;
+    uint8_t buf[kPage];
+    for (uint64_t i = 0; i < count; ++i) {
+        Key key;
+        uint32_t len, raw;
+        if (!ReadVal(f, key.a) || !ReadVal(f, key.b) || !ReadVal(f, len) || !ReadVal(f, raw)) return false;
+        if (len == 0 || len > kPage || (raw && len != kPage)) return false;
+        if (fread(buf, 1, len, f) != len) return false;
+        Append(key, buf, len, raw != 0);
+    }
+    return true;
+}
+
+PageSnapshot::PageSnapshot(std::shared_ptr<PageStore> store)
+    : store_(store ? std::move(store) : std::make_shared<PageStore>()) {}
+
+bool PageSnapshot::Capture(const IMemorySource& mem, std::atomic<bool>& cancel, std::atomic<float>& progress,
+                           SnapshotStats* stats, uintptr_t clipBase, uintptr_t clipEnd, unsigned threads) {
+    const size_t kPage = PageStore::kPage;
+    uint64_t t0 = ScanStats::NowNs();
+    const uint64_t storedBefore = store_->StoredBytes();
+    areas_.clear();
+    ids_.clear();
+    progress = 0.f;
+
+    std::vector<Region> regs;
+    mem.EnumReadableRegions(regs, clipBase, clipEnd);
+    size_t pages = 0;
+    for (auto& r : regs) {
+        areas_.push_back({ r.base, r.size, pages });
+        pages += (r.size + kPage - 1) / kPage;
+    }
+    ids_.assign(pages, PageStore::kMissing);
+
+    // stripes and chunks start at page multiples from their region's base
+    WalkOptions wo;
+    wo.threads = threads;
+    std::vector<Stripe> stripes = PlanStripes(regs, wo.stripeSize);
+    std::atomic<uint64_t> zero{0}, dup{0}, fresh{0};
+    WalkStripes(mem, stripes, wo, cancel, progress, [&](const ChunkView& v) {
+        const Area& a = areas_[v.region];
+        const uintptr_t areaEnd = a.base + a.size;
+        uint8_t tail[PageStore::kPage];
+        uint64_t z = 0, d = 0, n = 0;
+        for (size_t off = 0; off < v.ownedSize; off += kPage) {
+            const uintptr_t addr = v.addr + off;
+            const size_t want = (std::min)(kPage, (size_t)(areaEnd - addr));
+            if (v.size - off < want) break;     // short read
+            const uint8_t* page = v.data + off;
+            if (want < kPage) {     // region ends mid-page: the rest reads as zeros, Read stops at the end anyway
+                memcpy(tail, page, want);
+                memset(tail + want, 0, kPage - want);
+                page = tail;
+            }
+            bool wasDup = false;
+            uint32_t id = store_->Put(page, &wasDup);
+            ids_[a.first + (addr - a.base) / kPage] = id;
+            if (id == PageStore::kZero) ++z;
+            else if (wasDup) ++d;
+            else ++n;
+        }
+        zero += z; dup += d; fresh += n;
+    });
+
+    if (stats) {
+        stats->pages += pages;
+        stats->zeroPages += zero;
+        stats->dupPages += dup;
+        stats->newPages += fresh;
+        stats->missingPages += (uint64_t)std::count(ids_.begin(), ids_.end(), PageStore::kMissing);
+        stats->storedBytes += store_->StoredBytes() - storedBefore;
+        stats->ns += ScanStats::NowNs() - t0;
+    }
+    if (cancel) { areas_.clear(); ids_.clear(); return false; }
+    progress = 1.f;
+    return true;
+}
+
+size_t PageSnapshot::Find(uintptr_t addr) const {
+    auto it = std::upper_bound(areas_.begin(), areas_.end(), addr, [](uintptr_t a, const Area& r) { return a < r.base; });
+    if (it == areas_.begin()) return areas_.size();
+    --it;
+    return addr - it->base < it->size ? (size_t)(it - areas_.begin()) : areas_.size();
+}
+
+size_t PageSnapshot::Read(uintptr_t addr, void* dst, size_t n) const {
+    const size_t kPage = PageStore::kPage;
+    // last partially read page per thread, so small reads of one page decompress it once
+    thread_local struct { uint64_t serial = 0; uint32_t id = PageStore::kMissing; uint8_t data[PageStore::kPage]; } cache;
+    uint8_t* out = (uint8_t*)dst;
+    size_t i = Find(addr);
+    size_t done = 0;
+    while (done < n && i < areas_.size()) {
+        const Area& a = areas_[i];
+        const uintptr_t at = addr + done;
+        if (at < a.base) break;
+        if (at - a.base >= a.size) {
+            if (++i < areas_.size() && areas_[i].base == at) continue;     // adjacent region
+            break;
+        }
+        const size_t po = (size_t)((at - a.base) % kPage);
+        const size_t k = (std::min)({ n - done, kPage - po, (size_t)(a.base + a.size - at) });
+        const uint32_t id = ids_[a.first + (at - a.base) / kPage];
+        if (id == PageStore::kMissing) break;
+        if (id == PageStore::kZero) memset(out + done, 0, k);
+        else if (k == kPage) {
+            if (!store_->Get(id, out + done)) break;
+        }
+        else {
+            if (cache.serial != store_->Serial() || cache.id != id) {
+                if (!store_->Get(id, cache.data)) { cache.id = PageStore::kMissing; break; }
+                cache.serial = store_->Serial();
+                cache.id = id;
+            }
+            memcpy(out + done, cache.data + po, k);
+        }
+        done += k;
+    }
+    return done;
+}
+
+// runs of captured pages; pages that could not be read are left out
+void PageSnapshot::EnumReadableRegions(std::vector<Region>& out, uintptr_t clipBase, uintptr_t clipEnd) const {
+    const size_t kPage = PageStore::kPage;
+    out.clear();
+    for (auto& a : areas_) {
+        const size_t count = (a.size + kPage - 1) / kPage;
+        size_t p = 0;
+        while (p < count) {
+            while (p < count && ids_[a.first + p] == PageStore::kMissing) ++p;
+            size_t q = p;
+            while (q < count && ids_[a.first + q] != PageStore::kMissing) ++q;
+            if (q == p) break;
+            uintptr_t b = a.base + p * kPage, e = (std::min)(a.base + q * kPage, a.base + a.size);
+            p = q;
+            if (clipEnd > clipBase) {
+                if (e <= clipBase || b >= clipEnd) continue;
+                b = (std::max)(b, clipBase); e = (std::min)(e, clipEnd);
+            }
+            if (e > b) out.push_back({ b, (size_t)(e - b) });
+        }
+    }
+}
+
+bool PageSnapshot::QueryRegion(uintptr_t addr, RegionInfo& out) const {
+    auto it = std::upper_bound(areas_.begin(), areas_.end(), addr, [](uintptr_t a, const Area& r) { return a < r.base; });
+    if (it != areas_.begin() && addr - (it - 1)->base < (it - 1)->size) {
+        out = { (it - 1)->base, (it - 1)->size, true };
+        return true;
+    }
+    if (it == areas_.end()) return false;
+    uintptr_t lo = it == areas_.begin() ? 0 : (it - 1)->base + (it - 1)->size;
+    out = { lo, (size_t)(it->base - lo), false };
+    return true;
+}
+
+uint32_t PageSnapshot::PageAt(uintptr_t addr, uintptr_t* pageBase) const {
+    size_t i = Find(addr);
+    if (i == areas_.size()) return PageStore::kMissing;
+    const size_t page = (addr - areas_[i].base) / PageStore::kPage;
+    if (pageBase) *pageBase = areas_[i].base + page * PageStore::kPage;
+    return ids_[areas_[i].first + page];
+}
+
+uint64_t PageSnapshot::MemoryBytes() const {
+    return ids_.capacity() * sizeof(uint32_t) + areas_.capacity() * sizeof(Area);
+}
+
+// store, then magic, areas and the page id table
+bool PageSnapshot::Save(const std::string& path) const {
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) return false;
+    bool ok = store_->Save(f) && fwrite(kSnapMagic, 1, 8, f) == 8 && WriteVal(f, (uint64_t)areas_.size());
+    for (size_t i = 0; ok && i < areas_.size(); ++i)
+        ok = WriteVal(f, (uint64_t)areas_[i].base) && WriteVal(f, (uint64_t)areas_[i].size);
+    ok = ok && WriteVal(f, (uint64_t)ids_.size()) && fwrite(ids_.data(), sizeof(uint32_t), ids_.size(), f) == ids_.size();
+    return fclose(f) == 0 && ok;
+}
+
+bool PageSnapshot::Load(const std::string& path) {
+    areas_.clear();
+    ids_.clear();
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return false;
+    auto store = std::make_shared<PageStore>();
+    char magic[8];
+    uint64_t count = 0, idCount = 0;
+    bool ok = store->Load(f) && fread(magic, 1, 8, f) == 8 && memcmp(magic, kSnapMagic, 8) == 0 && ReadVal(f, count);
+    std::vector<Area> areas;
+    size_t pages = 0;
+    for (uint64_t i = 0; ok && i < count; ++i) {
+        uint64_t base, size;
+        ok = ReadVal(f, base) && ReadVal(f, size) && size && (areas.empty() || base >= areas.back().base + areas.back().size);
+        if (ok) { areas.push_back({ (uintptr_t)base, (size_t)size, pages }); pages += (size_t)((size + PageStore::kPage - 1) / PageStore::kPage); }
+    }
+    ok = ok && ReadVal(f, idCount) && idCount == pages;
+    std::vector<uint32_t> ids;
+    if (ok) {
+        ids.resize(pages);
+        ok = fread(ids.data(), sizeof(uint32_t), pages, f) == pages;
+    }
+    fclose(f);
+    const size_t stored = store->Pages();
+    for (size_t i = 0; ok && i < ids.size(); ++i) ok = ids[i] == PageStore::kMissing || ids[i] <= stored;
+    if (!ok) return false;
+    store_ = std::move(store);
+    areas_.swap(areas);
+    ids_.swap(ids);
+    return true;
+}
+
+}} // namespace
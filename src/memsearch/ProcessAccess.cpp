@@ -0,0 +1,219 @@
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
+#include "include/REKit/memsearch/ProcessAccess.h"
+#include "include/REKit/memsearch/ProcessMemory.h"
+#include "include/REKit/memsearch/ScanStats.h"
+
+namespace REKit { namespace MemSearch {
+
+namespace {
+
+const uint64_t kIdleNs = 30ull * 1000000000ull;     // unused entries are closed after this long
+const uint64_t kSweepNs = 1000000000ull;
+
+} // namespace
+
+#ifdef _WIN32
+
+ProcessHandle::~ProcessHandle() {
+    if (handle_) CloseHandle((HANDLE)handle_);
+}
+
+// STILL_ACTIVE is also a valid exit code; such a process looks alive until its handle is dropped.
+bool ProcessHandle::Alive() const {
+    DWORD code = 0;
+    return handle_ && GetExitCodeProcess((HANDLE)handle_, &code) && code == STILL_ACTIVE;
+}
+
+std::shared_ptr<const ProcessHandle> ProcessAccess::OpenHandle(unsigned int pid, unsigned rights) {
+    DWORD access = PROCESS_QUERY_INFORMATION | PROCESS_VM_READ;
+    if (rights & kWrite)  access |= PROCESS_VM_WRITE | PROCESS_VM_OPERATION;
+    if (rights & kInject) access |= PROCESS_VM_WRITE | PROCESS_VM_OPERATION | PROCESS_CREATE_THREAD;
+    HANDLE h = OpenProcess(access, FALSE, (DWORD)pid);
+    if (!h) return nullptr;
+    std::shared_ptr<ProcessHandle> p(new ProcessHandle());
+    p->pid_ = pid;
+    p->rights_ = rights;
+    p->handle_ = h;
+    FILETIME created{}, exited{}, kernel{}, user{};
+    if (GetProcessTimes(h, &created, &exited, &kernel, &user))
+        p->startTime_ = ((uint64_t)created.dwHighDateTime << 32) | created.dwLowDateTime;
+    return p;
+}
+
+#else
+
+ProcessHandle::~ProcessHandle() {
+    if (pidFd_ >= 0) close(pidFd_);
+    if (procFd_ >= 0) close(procFd_);
+}
+
+// Field 22 of /proc/<pid>/stat; the command name before it may hold spaces and parentheses.
+static uint64_t ReadStartTime(int procFd) {
+    int fd = openat(procFd, "stat", O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return 0;
+    char buf[1024];
+    ssize_t n = read(fd, buf, sizeof(buf) - 1);
+    close(fd);
+    if (n <= 0) return 0;
+    buf[n] = 0;
+    const char* p = strrchr(buf, ')');
+    if (!p) return 0;
+    for (int field = 2; field < 22 && p; ++field) p = strchr(p + 1, ' ');
+    return p ? strtoull(p + 1, nullptr, 10) : 0;
+}
+
+// A pidfd turns readable when its process exits; without one, a stale
+// /proc/<pid> fd stops resolving once the process is reaped.
+bool ProcessHandle::Alive() const {
+    if (pidFd_ >= 0) {
+        struct pollfd pfd{ pidFd_, POLLIN, 0 };
+        return poll(&pfd, 1, 0) == 0;
+    }
+    return procFd_ >= 0 && faccessat(procFd_, "stat", F_OK, 0) == 0;
+}
+
+std::shared_ptr<const ProcessHandle> ProcessAccess::OpenHandle(unsigned int pid, unsigned rights) {
+    if (pid == 0) return nullptr;
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%u", pid);
+    int dir = open(path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dir < 0) return nullptr;
+    std::shared_ptr<ProcessHandle> p(new ProcessHandle());
+    p->pid_ = pid;
+    p->rights_ = rights;
+    p->procFd_ = dir;
+#if defined(SYS_pidfd_open)
+    p->pidFd_ = (int)syscall(SYS_pidfd_open, (pid_t)pid, 0);
+#endif
+    p->startTime_ = ReadStartTime(dir);
+    // the pid may have been reused between opening the directory and the pidfd
+    if (p->startTime_ == 0 || ReadStartTime(dir) != p->startTime_) return nullptr;
+    return p;
+}
+
+#endif
+
+ProcessAccess& ProcessAccess::Shared() {
+    static ProcessAccess access;
+    return access;
+}
+
+void ProcessAccess::Sweep(uint64_t now) {
+    if (now - lastSweepNs_ < kSweepNs) return;
+    lastSweepNs_ = now;
+    readers_.erase(std::remove_if(readers_.begin(), readers_.end(), [&](const MemoryEntry& e) {
+        return (e.mem.use_count() == 1 && now - e.usedNs >= kIdleNs) || !e.mem->Handle()->Alive();
+    }), readers_.end());
+    handles_.erase(std::remove_if(handles_.begin(), handles_.end(), [&](const HandleEntry& e) {
+        return (e.h.use_count() == 1 && now - e.usedNs >= kIdleNs) || !e.h->Alive();
+    }), handles_.end());
+}
+
+std::shared_ptr<const ProcessHandle> ProcessAccess::Open(unsigned int pid, unsigned rights) {
+    if (rights == 0) rights = kRead;
+    const uint64_t now = ScanStats::NowNs();
+    std::lock_guard<std::mutex> lk(mu_);
+    Sweep(now);
+    return OpenLocked(pid, rights, now);
+}
+
+std::shared_ptr<const ProcessHandle> ProcessAccess::OpenLocked(unsigned int pid, unsigned rights, uint64_t now) {
+    for (size_t i = 0; i < handles_.size(); ++i) {
+        HandleEntry& e = handles_[i];
+        if (e.h->Pid() != pid || (e.h->Rights() & rights) != rights) continue;
+        if (!e.h->Alive()) { handles_.erase(handles_.begin() + i); break; }
+        e.usedNs = now;
+        return e.h;
+    }
+    std::shared_ptr<const ProcessHandle> h = OpenHandle(pid, rights);
+    if (h) handles_.push_back({ h, now });
+    return h;
+}
+
+// Lookup, open and insert under one lock, so callers racing for a pid share one reader.
+std::shared_ptr<const ProcessMemory> ProcessAccess::Memory(unsigned int pid, bool writable) {
+    const uint64_t now = ScanStats::NowNs();
+    std::lock_guard<std::mutex> lk(mu_);
+    Sweep(now);
+    for (size_t i = 0; i < readers_.size(); ++i) {
+        MemoryEntry& e = readers_[i];
+        if (e.mem->Pid() != pid || (writable && !e.writable)) continue;
+        if (!e.mem->Handle()->Alive()) { readers_.erase(readers_.begin() + i); break; }
+        e.usedNs = now;
+        return e.mem;
+    }
+    std::shared_ptr<const ProcessHandle> h = OpenLocked(pid, writable ? kRead | kWrite : kRead, now);
+    auto mem = std::make_shared<const ProcessMemory>(h, writable);
+    if (h) readers_.push_back({ mem, writable, now });     // not open: callers see IsOpen() == false
+    return mem;
+}
+
+void ProcessAccess::Forget(unsigned int pid) {
+    std::lock_guard<std::mutex> lk(mu_);
+    readers_.erase(std::remove_if(readers_.begin(), readers_.end(),
+        [&](const MemoryEntry& e) { return e.mem->Pid() == pid; }), readers_.end());
+    handles_.erase(std::remove_if(handles_.begin(), handles_.end(),
+        [&](const HandleEntry& e) { return e.h->Pid() == pid; }), handles_.end());
+}
+
+size_t ProcessAccess::Cached() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return handles_.size();
+}
+
+void BatchReader::Clear() {
+    items_.clear();
+    spans_.clear();
+    spanOff_.clear();
+    buf_.clear();
+}
+
+size_t BatchReader::Add(uintptr_t addr, size_t size) {
+    Item it{ addr, size, 0, 0, false };
+    if (!spans_.empty()) {
+        ReadSpan& s = spans_.back();
+        if (addr >= s.addr && addr <= s.addr + s.size + gap_) {
+            const size_t end = (size_t)(addr + size - s.addr);
+            if (end > s.size) { buf_.resize(buf_.size() + (end - s.size)); s.size = end; }
+            it.off = spanOff_.back() + (size_t)(addr - s.addr);
+            it.span = spans_.size() - 1;
+            items_.push_back(it);
+            return items_.size() - 1;
+        }
+    }
+    spans_.push_back({ addr, nullptr, size });
+    spanOff_.push_back(buf_.size());
+    it.off = buf_.size();
+    it.span = spans_.size() - 1;
+    buf_.resize(buf_.size() + size);
+    items_.push_back(it);
+    return items_.size() - 1;
+}
+
+size_t BatchReader::Run(const IMemorySource& mem) {
+    for (size_t i = 0; i < spans_.size(); ++i) spans_[i].data = buf_.data() + spanOff_[i];
+    mem.ReadBatch(spans_.data(), spans_.size(), &failed_);
+    // a failed coalesced span may only be missing the gap between two items
+    size_t bad = 0;
+    for (Item& it : items_) {
+        it.ok = !failed_[it.span];
+        if (!it.ok) it.ok = mem.Read(it.addr, buf_.data() + it.off, it.size) == it.size;
+        if (!it.ok) ++bad;
+    }
+    return bad;
+}
+
+}} // namespace
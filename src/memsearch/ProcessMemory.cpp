@@ -0,0 +1,272 @@
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#ifdef _WIN32
+#include <windows.h>
+#include <tlhelp32.h>
+#else
+#include <sys/uio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <limits.h>
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+#endif
+
+#include "include/REKit/memsearch/ProcessMemory.h"
+#include "include/REKit/memsearch/ScanStats.h"
+
+namespace REKit { namespace MemSearch {
+
+static void PushClipped(std::vector<Region>& out, uintptr_t b, uintptr_t e, uintptr_t clipBase, uintptr_t clipEnd) {
+    if (clipEnd > clipBase) {
+        if (e <= clipBase || b >= clipEnd) return;
+        b = (std::max)(b, clipBase); e = (std::min)(e, clipEnd);
+    }
+    if (e > b) out.push_back({ b, (size_t)(e - b) });
+}
+
+size_t IMemorySource::ReadBatch(const ReadSpan* spans, size_t n, std::vector<char>* failed) const {
+    if (failed) failed->assign(n, 0);
+    size_t bad = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (Read(spans[i].addr, spans[i].data, spans[i].size) != spans[i].size) { ++bad; if (failed) (*failed)[i] = 1; }
+    }
+    return bad;
+}
+
+ProcessMemory::ProcessMemory(unsigned int pid, bool writable)
+    : ProcessMemory(ProcessAccess::Shared().Open(pid, writable ? ProcessAccess::kRead | ProcessAccess::kWrite : ProcessAccess::kRead), writable) {
+    pid_ = pid;
+}
+
+// Windows: write access was requested when the handle was opened; Linux: checked per call by process_vm_writev.
+ProcessMemory::ProcessMemory(std::shared_ptr<const ProcessHandle> handle, bool writable) : handle_(std::move(handle)) {
+    open_ = handle_ != nullptr;
+    pid_ = open_ ? handle_->Pid() : 0;
+    writable_ = open_ && writable && (handle_->Rights() & (ProcessAccess::kWrite | ProcessAccess::kInject)) != 0;
+}
+
+ProcessMemory::~ProcessMemory() {}
+
+#ifdef _WIN32
+
+size_t ProcessMemory::Read(uintptr_t addr, void* dst, size_t n) const {
+    SIZE_T br = 0;
+    if (!open_ || !ReadProcessMemory((HANDLE)handle_->Native(), (LPCVOID)addr, dst, n, &br)) return 0;
+    return (size_t)br;
+}
+
+size_t ProcessMemory::ReadBatch(const ReadSpan* spans, size_t n, std::vector<char>* failed) const {
+    return IMemorySource::ReadBatch(spans, n, failed);
+}
+
+size_t ProcessMemory::WriteBatch(const WriteSpan* spans, size_t n, std::vector<char>* failed) const {
+    if (failed) failed->assign(n, 0);
+    size_t bad = 0;
+    for (size_t i = 0; i < n; ++i) {
+        SIZE_T bw = 0;
+        bool ok = writable_ && WriteProcessMemory((HANDLE)handle_->Native(), (LPVOID)spans[i].addr, spans[i].data, spans[i].size, &bw)
+                  && bw == spans[i].size;
+        if (!ok) { ++bad; if (failed) (*failed)[i] = 1; }
+    }
+    return bad;
+}
+
+static bool IsReadable(const MEMORY_BASIC_INFORMATION& mbi) {
+    return mbi.State == MEM_COMMIT
+        && (mbi.Protect & (PAGE_READONLY|PAGE_READWRITE|PAGE_EXECUTE_READ|PAGE_EXECUTE_READWRITE)) != 0
+        && !(mbi.Protect & (PAGE_GUARD));
+}
+
+bool ProcessMemory::QueryRegion(uintptr_t addr, RegionInfo& out) const {
+    MEMORY_BASIC_INFORMATION mbi{};
+    if (!open_ || VirtualQueryEx((HANDLE)handle_->Native(), (LPCVOID)addr, &mbi, sizeof(mbi)) != sizeof(mbi)) return false;
+    out.base = (uintptr_t)mbi.BaseAddress;
+    out.size = (size_t)mbi.RegionSize;
+    out.readable = IsReadable(mbi);
+    return true;
+}
+
+void ProcessMemory::EnumReadableRegions(std::vector<Region>& out, uintptr_t clipBase, uintptr_t clipEnd) const {
+    out.clear();
+    if (!open_) return;
+    MEMORY_BASIC_INFORMATION mbi{};
+    uintptr_t cur = 0;
+    while (VirtualQueryEx((HANDLE)handle_->Native(), (LPCVOID)cur, &mbi, sizeof(mbi)) == sizeof(mbi)) {
+        uintptr_t rb = (uintptr_t)mbi.BaseAddress;
+        uintptr_t re = rb + (size_t)mbi.RegionSize;
+        if (IsReadable(mbi)) PushClipped(out, rb, re, clipBase, clipEnd);
+        cur = re;
+        if (cur < rb) break; // overflow safety
+    }
+}
+
+static std::string Utf8FromWide(const wchar_t* w) {
+    int n = WideCharToMultiByte(CP_UTF8, 0, w, -1, nullptr, 0, nullptr, nullptr);
+    if (n <= 0) return {};
+    std::string s(n - 1, '\0');
+    WideCharToMultiByte(CP_UTF8, 0, w, -1, &s[0], n, nullptr, nullptr);
+    return s;
+}
+
+void ProcessMemory::EnumModules(std::vector<ModuleInfo>& out) const {
+    out.clear();
+    if (!open_) return;
+    HANDLE snap = CreateToolhelp32Snapshot(TH32CS_SNAPMODULE | TH32CS_SNAPMODULE32, (DWORD)pid_);
+    if (snap == INVALID_HANDLE_VALUE) return;
+    MODULEENTRY32W me;
+    me.dwSize = sizeof(me);
+    if (Module32FirstW(snap, &me)) {
+        do {
+            ModuleInfo m;
+            m.base = (uintptr_t)me.modBaseAddr;
+            m.size = (size_t)me.modBaseSize;
+            m.name = Utf8FromWide(me.szModule);
+            m.path = Utf8FromWide(me.szExePath);
+            out.push_back(std::move(m));
+        } while (Module32NextW(snap, &me));
+    }
+    CloseHandle(snap);
+}
+
+#else
+
+// The pid is only ours while the process lives; bytes read after it exited
+// may belong to a process that reused the pid. A pid is handed out again only
+// after the process was reaped and the pid counter wrapped, which takes far
+// longer than kAliveRecheckNs, so full reads share one poll of the handle per
+// interval; a short or failed read polls at once.
+bool ProcessMemory::StillAlive(bool force) const {
+    const uint64_t now = ScanStats::NowNs();
+    if (!force && now - aliveNs_.load(std::memory_order_relaxed) < kAliveRecheckNs) return true;
+    if (!handle_->Alive()) return false;
+    aliveNs_.store(now, std::memory_order_relaxed);
+    return true;
+}
+
+size_t ProcessMemory::Read(uintptr_t addr, void* dst, size_t n) const {
+    if (!open_) return 0;
+    struct iovec local{ dst, n };
+    struct iovec remote{ (void*)addr, n };
+    ssize_t r = process_vm_readv((pid_t)pid_, &local, 1, &remote, 1, 0);
+    return r > 0 && StillAlive((size_t)r < n) ? (size_t)r : 0;
+}
+
+// process_vm_readv/writev take up to IOV_MAX remote spans per call but stop at
+// the first one that fails; the rest of that call is retried from the next span.
+template <typename Span, typename Call>
+static size_t VectoredIo(const Span* spans, size_t n, std::vector<char>* failed, Call call) {
+    size_t bad = 0;
+    std::vector<struct iovec> local, remote;
+    size_t i = 0;
+    while (i < n) {
+        size_t cnt = (std::min)(n - i, (size_t)IOV_MAX);
+        local.resize(cnt); remote.resize(cnt);
+        size_t want = 0;
+        for (size_t k = 0; k < cnt; ++k) {
+            local[k]  = { const_cast<void*>((const void*)spans[i + k].data), spans[i + k].size };
+            remote[k] = { (void*)spans[i + k].addr, spans[i + k].size };
+            want += spans[i + k].size;
+        }
+        ssize_t r = call(local.data(), remote.data(), (unsigned long)cnt);
+        size_t done = r > 0 ? (size_t)r : 0;
+        if (done == want) { i += cnt; continue; }
+        // skip the completed spans, mark the one that stopped the call
+        size_t k = 0;
+        while (k < cnt && done >= spans[i + k].size) done -= spans[i + k].size, ++k;
+        ++bad;
+        if (failed) (*failed)[i + k] = 1;
+        i += k + 1;
+    }
+    return bad;
+}
+
+size_t ProcessMemory::ReadBatch(const ReadSpan* spans, size_t n, std::vector<char>* failed) const {
+    if (failed) failed->assign(n, open_ ? 0 : 1);
+    if (!open_) return n;
+    size_t bad = VectoredIo(spans, n, failed, [&](const struct iovec* l, const struct iovec* r, unsigned long cnt) {
+        return process_vm_readv((pid_t)pid_, l, cnt, r, cnt, 0);
+    });
+    if (bad < n && !StillAlive(bad > 0)) {
+        if (failed) failed->assign(n, 1);
+        bad = n;
+    }
+    return bad;
+}
+
+size_t ProcessMemory::WriteBatch(const WriteSpan* spans, size_t n, std::vector<char>* failed) const {
+    if (failed) failed->assign(n, writable_ ? 0 : 1);
+    if (!writable_ || !handle_->Alive()) {
+        if (failed) failed->assign(n, 1);
+        return n;
+    }
+    return VectoredIo(spans, n, failed, [&](const struct iovec* l, const struct iovec* r, unsigned long cnt) {
+        return process_vm_writev((pid_t)pid_, l, cnt, r, cnt, 0);
+    });
+}
+
+static FILE* OpenMaps(const ProcessHandle& h) {
+    int fd = openat(h.ProcFd(), "maps", O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return nullptr;
+    FILE* f = fdopen(fd, "r");
+    if (!f) close(fd);
+    return f;
+}
+
+void ProcessMemory::EnumReadableRegions(std::vector<Region>& out, uintptr_t clipBase, uintptr_t clipEnd) const {
+    out.clear();
+    if (!open_) return;
+    FILE* f = OpenMaps(*handle_);
+    if (!f) return;
+    char line[4096];
+    while (fgets(line, sizeof(line), f)) {
+        unsigned long long b = 0, e = 0;
+        char perms[8] = {0};
+        if (sscanf(line, "%llx-%llx %7s", &b, &e, perms) != 3) continue;
+        if (perms[0] != 'r') continue;
+        if (strstr(line, "[vvar")) continue;  // [vvar], [vvar_vclock]: not readable through process_vm_readv
+        PushClipped(out, (uintptr_t)b, (uintptr_t)e, clipBase, clipEnd);
+    }
+    fclose(f);
+}
+
+bool ProcessMemory::QueryRegion(uintptr_t, RegionInfo&) const {
+    return false;   // /proc/<pid>/maps has no point query
+}
+
+// Consecutive mappings of the same file form one module; the executable is mapped first.
+void ProcessMemory::EnumModules(std::vector<ModuleInfo>& out) const {
+    out.clear();
+    if (!open_) return;
+    FILE* f = OpenMaps(*handle_);
+    if (!f) return;
+    char line[4096];
+    while (fgets(line, sizeof(line), f)) {
+        unsigned long long b = 0, e = 0;
+        int off = 0;
+        if (sscanf(line, "%llx-%llx %*s %*s %*s %*s %n", &b, &e, &off) < 2 || off <= 0) continue;
+        char* file = line + off;
+        file[strcspn(file, "\n")] = 0;
+        if (file[0] != '/' || strstr(file, " (deleted)")) continue;
+        if (!out.empty() && out.back().path == file && out.back().base + out.back().size <= (uintptr_t)b) {
+            out.back().size = (size_t)((uintptr_t)e - out.back().base);
+            continue;
+        }
+        ModuleInfo m;
+        m.base = (uintptr_t)b;
+        m.size = (size_t)(e - b);
+        m.path = file;
+        const char* slash = strrchr(file, '/');
+        m.name = slash ? slash + 1 : file;
+        out.push_back(std::move(m));
+    }
+    fclose(f);
+}
+
+#endif
+
+}} // namespace
@@ -0,0 +1,212 @@
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "include/REKit/memsearch/RegionMap.h"
+#include "include/REKit/memsearch/ProcessMemory.h"
+#include "include/REKit/memsearch/ScanStats.h"
+
+namespace REKit { namespace MemSearch {
+
+void RegionMap::Append(std::vector<Span>& out, const Span& s) {
+    if (s.size == 0) return;
+    if (!out.empty() && out.back().readable == s.readable && out.back().base + out.back().size == s.base) {
+        out.back().size += s.size;
+        out.back().parts += s.parts;
+        return;
+    }
+    out.push_back(s);
+}
+
+// Queries [lo, hi) region by region; hi == 0 runs to the end of the address space.
+void RegionMap::Walk(const QueryFn& query, uintptr_t lo, uintptr_t hi, std::vector<Span>& out, uint64_t& queries) {
+    uintptr_t cur = lo;
+    while (hi == 0 || cur < hi) {
+        RegionInfo r;
+        ++queries;
+        if (!query(cur, r)) break;
+        uintptr_t re = r.base + r.size;
+        if (hi && re > hi) re = hi;
+        if (re <= cur) break;   // wrapped at the top of the address space
+        Append(out, { cur, (size_t)(re - cur), r.readable, 1, (size_t)(re - cur) });
+        cur = re;
+    }
+}
+
+void RegionMap::Refresh(const QueryFn& query, bool full, RegionMapStats* stats) {
+    std::lock_guard<std::mutex> lk(mu_);
+    uint64_t t0 = ScanStats::NowNs();
+    uint64_t queries = 0;
+    bool changed = false;
+    if (!valid_ || full || ++sinceFull_ >= kFullEvery) {
+        sinceFull_ = 0;
+        spans_.clear();
+        Walk(query, 0, 0, spans_, queries);
+        valid_ = true;
+        changed = true;
+        if (stats) stats->full = true;
+    }
+    else {
+        std::vector<Span> next;
+        next.reserve(spans_.size() + 16);
+        uintptr_t end = 0;
+        for (const Span& s : spans_) {
+            end = s.base + s.size;
+            if (s.readable) {
+                RegionInfo a{};
+                ++queries;
+                if (query(s.base, a) && a.readable && a.base == s.base && a.size == s.first) { Append(next, s); continue; }
+                changed = true;
+                Walk(query, s.base, end, next, queries);
+            }
+            else {
+                std::vector<Span> w;
+                Walk(query, s.base, end, w, queries);
+                if (w.size() == 1 && !w[0].readable && w[0].size == s.size) { Append(next, w[0]); continue; }
+                changed = true;
+                for (auto& x : w) Append(next, x);
+            }
+        }
+        // anything mapped past the old end
+        size_t before = next.size();
+        Walk(query, end, 0, next, queries);
+        if (next.size() != before) changed = true;
+        spans_.swap(next);
+    }
+    if (stats) {
+        stats->unchanged = !changed;
+        stats->queries += queries;
+        stats->ns += ScanStats::NowNs() - t0;
+        Count(stats);
+    }
+}
+
+void RegionMap::Refresh(const IMemorySource& mem, bool full, RegionMapStats* stats) {
+#ifndef _WIN32
+    if (mem.Pid()) { RefreshMaps(mem, full, stats); return; }
+#endif
+    Refresh([&](uintptr_t addr, RegionInfo& out) { return mem.QueryRegion(addr, out); }, full, stats);
+}
+
+#ifndef _WIN32
+void RegionMap::RefreshMaps(const IMemorySource& mem, bool full, RegionMapStats* stats) {
+    std::lock_guard<std::mutex> lk(mu_);
+    uint64_t t0 = ScanStats::NowNs();
+    std::string text;
+    // through the handle's /proc directory, so a reused pid cannot answer for it
+    int fd = -1;
+    const ProcessMemory* pm = dynamic_cast<const ProcessMemory*>(&mem);
+    if (pm && pm->Handle() && pm->Handle()->ProcFd() >= 0) fd = openat(pm->Handle()->ProcFd(), "maps", O_RDONLY | O_CLOEXEC);
+    else if (mem.IsOpen()) {
+        char path[64];
+        snprintf(path, sizeof(path), "/proc/%u/maps", mem.Pid());
+        fd = open(path, O_RDONLY | O_CLOEXEC);
+    }
+    if (fd >= 0) {
+        char buf[16384];
+        ssize_t n;
+        while ((n = read(fd, buf, sizeof(buf))) > 0) text.append(buf, (size_t)n);
+        close(fd);
+    }
+    uint64_t h = 1469598103934665603ull;
+    for (unsigned char c : text) { h ^= c; h *= 1099511628211ull; }
+    const bool unchanged = valid_ && !full && h == mapsHash_;
+    if (!unchanged) {
+        spans_.clear();
+        size_t pos = 0;
+        while (pos < text.size()) {
+            size_t nl = text.find('\n', pos);
+            if (nl == std::string::npos) nl = text.size();
+            std::string line = text.substr(pos, nl - pos);
+            pos = nl + 1;
+            unsigned long long b = 0, e = 0;
+            char perms[8] = {0};
+            if (sscanf(line.c_str(), "%llx-%llx %7s", &b, &e, perms) != 3 || e <= b) continue;
+            bool readable = perms[0] == 'r' && line.find("[vvar") == std::string::npos;    // [vvar], [vvar_vclock]: not readable through process_vm_readv
+            Append(spans_, { (uintptr_t)b, (size_t)(e - b), readable, 1, (size_t)(e - b) });
+        }
+        mapsHash_ = h;
+        valid_ = true;
+    }
+    if (stats) {
+        stats->full = !unchanged;
+        stats->unchanged = unchanged;
+        stats->ns += ScanStats::NowNs() - t0;
+        Count(stats);
+    }
+}
+#endif
+
+void RegionMap::Count(RegionMapStats* stats) const {
+    stats->runs = 0;
+    stats->rawRegions = 0;
+    for (auto& s : spans_) {
+        if (!s.readable) continue;
+        ++stats->runs;
+        stats->rawRegions += s.parts;
+    }
+}
+
+void RegionMap::Regions(std::vector<Region>& out, uintptr_t clipBase, uintptr_t clipEnd) const {
+    std::lock_guard<std::mutex> lk(mu_);
+    out.clear();
+    for (auto& s : spans_) {
+        if (!s.readable) continue;
+        uintptr_t b = s.base, e = s.base + s.size;
+        if (clipEnd > clipBase) {
+            if (e <= clipBase || b >= clipEnd) continue;
+            b = (std::max)(b, clipBase); e = (std::min)(e, clipEnd);
+        }
+        if (e > b) out.push_back({ b, (size_t)(e - b) });
+    }
+}
+
+bool RegionMap::Valid() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return valid_;
+}
+
+RegionMapCache& RegionMapCache::Shared() {
+    static RegionMapCache cache;
+    return cache;
+}
+
+std::shared_ptr<RegionMap> RegionMapCache::Get(unsigned pid, uint64_t startTime) {
+    std::lock_guard<std::mutex> lk(mu_);
+    for (auto it = lru_.begin(); it != lru_.end(); ++it) {
+        if (it->pid != pid) continue;
+        if (it->startTime != startTime) { lru_.erase(it); break; }    // the pid now names another process
+        lru_.splice(lru_.begin(), lru_, it);
+        return lru_.front().map;
+    }
+    lru_.push_front({ pid, startTime, std::make_shared<RegionMap>() });
+    if (lru_.size() > kMaxTargets) lru_.pop_back();
+    return lru_.front().map;
+}
+
+void RegionMapCache::Regions(const IMemorySource& mem, std::vector<Region>& out, uintptr_t clipBase, uintptr_t clipEnd,
+                             RegionMapStats* stats) {
+    const ProcessMemory* pm = dynamic_cast<const ProcessMemory*>(&mem);
+    const uint64_t startTime = pm && pm->Handle() ? pm->Handle()->StartTime() : 0;
+    std::shared_ptr<RegionMap> map = Get(mem.Pid(), startTime);
+    map->Refresh(mem, false, stats);
+    map->Regions(out, clipBase, clipEnd);
+}
+
+void RegionMapCache::Forget(unsigned pid) {
+    std::lock_guard<std::mutex> lk(mu_);
+    lru_.remove_if([&](const Entry& e) { return e.pid == pid; });
+}
+
+void RegionMapCache::Clear() {
+    std::lock_guard<std::mutex> lk(mu_);
+    lru_.clear();
+}
+
+}} // namespace
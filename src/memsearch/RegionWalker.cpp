@@ -0,0 +1,141 @@
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <cstring>
+
+#include "include/REKit/memsearch/RegionWalker.h"
+
+namespace REKit { namespace MemSearch {
+
+std::vector<Stripe> PlanStripes(const std::vector<Region>& regs, size_t stripeSize) {
+    std::vector<Stripe> out;
+    if (stripeSize == 0) stripeSize = 4 << 20;
+    for (size_t i = 0; i < regs.size(); ++i) {
+        const Region& r = regs[i];
+        uintptr_t end = r.base + r.size;
+        uintptr_t limit = (std::max)(end, r.limit);
+        for (uintptr_t cur = r.base; cur < end; ) {
+            size_t n = (size_t)std::min<uintptr_t>(stripeSize, end - cur);
+            out.push_back({ i, cur, n, limit, r.local ? r.local + (cur - r.base) : nullptr, r.local ? end : 0 });
+            cur += n;
+        }
+    }
+    return out;
+}
+
+unsigned ResolveThreadCount(unsigned requested, size_t workItems) {
+    unsigned n = requested;
+    if (n == 0) n = std::thread::hardware_concurrency();
+    if (n == 0) n = 1;
+    if (workItems < n) n = (unsigned)std::max<size_t>(workItems, 1);
+    return n;
+}
+
+void WalkStripes(const IMemorySource& mem, const std::vector<Stripe>& stripes, const WalkOptions& wo,
+                 std::atomic<bool>& cancel, std::atomic<float>& progress, const ChunkFn& fn) {
+    WalkStripes(mem, stripes, wo, cancel, progress, fn, StripeDoneFn());
+}
+
+void WalkStripe(const IMemorySource& mem, const Stripe& s, size_t si, const WalkOptions& wo, unsigned wid,
+                std::vector<uint8_t>& buf, std::atomic<bool>& cancel, const ChunkFn& fn, WalkProgress& prog) {
+    const size_t small = wo.chunkSize ? wo.chunkSize : (1 << 16);
+    size_t chunk = (wo.largeChunkSize > small && s.size >= wo.stripeSize) ? wo.largeChunkSize : small;
+    if (buf.size() < chunk + wo.overlap) buf.resize(chunk + wo.overlap);
+    ScanThreadStats* st = wo.stats ? &wo.stats->Thread(wid) : nullptr;
+    if (s.local) {
+        if (cancel) return;
+        // One view straight into the mapping. If the overlap runs past the
+        // local bytes, the last few positions go through a small copy that is
+        // completed with a remote read.
+        uint64_t t0 = st ? ScanStats::NowNs() : 0;
+        const size_t need = (size_t)std::min<uintptr_t>(s.size + wo.overlap, s.limit - s.base);
+        const size_t have = (size_t)(s.localEnd - s.base);
+        size_t owned = s.size;
+        // the split falls on a page boundary, like the chunks of remote reads
+        if (need > have) owned = have > wo.overlap ? (std::min)(s.size, (have - wo.overlap) & ~(size_t)0xFFF) : 0;
+        if (owned) fn(ChunkView{ wid, si, s.region, s.base, s.local, (std::min)(need, have), owned });
+        if (owned < s.size) {
+            size_t keep = have - owned;
+            if (buf.size() < keep + wo.overlap) buf.resize(keep + wo.overlap);
+            memcpy(buf.data(), s.local + owned, keep);
+            size_t br = mem.Read(s.localEnd, buf.data() + keep, need - have);
+            if (st) { ScanThreadStats::Add(st->readCalls, 1); ScanThreadStats::Add(st->bytesRequested, need - have); ScanThreadStats::Add(st->bytesRead, br); }
+            fn(ChunkView{ wid, si, s.region, s.base + owned, buf.data(), keep + br, s.size - owned });
+        }
+        if (st) {
+            ScanThreadStats::Add(st->bytesMapped, s.size);
+            ScanThreadStats::Add(st->compareNs, ScanStats::NowNs() - t0);
+        }
+        prog.Add(s.size);
+        return;
+    }
+    uintptr_t cur = s.base;
+    uintptr_t end = s.base + s.size;
+    while (cur < end) {
+        if (cancel) break;
+        size_t owned  = (size_t)std::min<uintptr_t>(chunk, end - cur);
+        size_t toRead = (size_t)std::min<uintptr_t>(owned + wo.overlap, s.limit - cur);
+        uint64_t t0 = st ? ScanStats::NowNs() : 0;
+        size_t br = mem.Read(cur, buf.data(), toRead);
+        if (st) { ScanThreadStats::Add(st->readCalls, 1); ScanThreadStats::Add(st->bytesRequested, toRead); }
+        if (br < owned && chunk > small) {
+            // a coalesced run may hold a page that cannot be read; continue at normal granularity
+            if (st) { ScanThreadStats::Add(st->readFailures, 1); ScanThreadStats::Add(st->readNs, ScanStats::NowNs() - t0); }
+            chunk = small;
+            continue;
+        }
+        if (br == 0 && toRead > owned) {
+            br = mem.Read(cur, buf.data(), owned); // overlap page may be unreadable
+            if (st) { ScanThreadStats::Add(st->readCalls, 1); ScanThreadStats::Add(st->readFailures, 1); ScanThreadStats::Add(st->bytesRequested, owned); }
+        }
+        if (st) {
+            if (br == 0) ScanThreadStats::Add(st->readFailures, 1);
+            ScanThreadStats::Add(st->bytesRead, br);
+        }
+        if (br > 0) {
+            uint64_t t1 = st ? ScanStats::NowNs() : 0;
+            ChunkView v{ wid, si, s.region, cur, buf.data(), br, std::min(owned, br) };
+            fn(v);
+            if (st) {
+                uint64_t t2 = ScanStats::NowNs();
+                ScanThreadStats::Add(st->readNs, t1 - t0);
+                ScanThreadStats::Add(st->compareNs, t2 - t1);
+            }
+        }
+        else if (st) {
+            ScanThreadStats::Add(st->readNs, ScanStats::NowNs() - t0);
+        }
+        cur += owned;
+        prog.Add(owned);
+    }
+}
+
+void WalkStripes(const IMemorySource& mem, const std::vector<Stripe>& stripes, const WalkOptions& wo,
+                 std::atomic<bool>& cancel, std::atomic<float>& progress, const ChunkFn& fn, const StripeDoneFn& stripeDone) {
+    WalkProgress prog;
+    for (auto& s : stripes) prog.total += s.size;
+    if (prog.total == 0) { progress = 1.f; return; }
+    prog.out = &progress;
+
+    std::atomic<size_t> next{0};
+    auto worker = [&](unsigned wid) {
+        std::vector<uint8_t> buf;
+        for (;;) {
+            if (cancel) break;
+            size_t si = next.fetch_add(1);
+            if (si >= stripes.size()) break;
+            WalkStripe(mem, stripes[si], si, wo, wid, buf, cancel, fn, prog);
+            if (stripeDone) stripeDone(si);
+        }
+    };
+
+    unsigned n = ResolveThreadCount(wo.threads, stripes.size());
+    if (wo.stats && n > ScanStats::kMaxThreads) n = ScanStats::kMaxThreads;    // one stats slot per worker
+    if (n == 1) { worker(0); return; }
+    std::vector<std::thread> pool;
+    pool.reserve(n);
+    for (unsigned i = 0; i < n; ++i) pool.emplace_back(worker, i);
+    for (auto& t : pool) t.join();
+}
+
+}} // namespace
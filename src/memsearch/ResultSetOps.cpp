@@ -0,0 +1,229 @@
+#include <vector>
+#include <algorithm>
+
+#include "include/REKit/memsearch/ResultSetOps.h"
+
+namespace REKit { namespace MemSearch {
+
+namespace {
+
+// First index >= from with p[i] >= x: exponential steps, then binary search.
+size_t Gallop(const uintptr_t* p, size_t n, size_t from, uintptr_t x) {
+    if (from >= n || p[from] >= x) return from;
+    size_t lo = from, step = 1;
+    while (lo + step < n && p[lo + step] < x) { lo += step; step <<= 1; }
+    size_t hi = (std::min)(lo + step, n);
+    return (size_t)(std::lower_bound(p + lo + 1, p + hi, x) - p);
+}
+
+// Lists this many times apart in size are galloped instead of merged.
+const size_t kSkew = 16;
+
+// Small buffer the branch-free merges write into unconditionally; only the
+// entries counted in k are kept.
+struct Staging {
+    std::vector<uintptr_t>& out;
+    uintptr_t buf[1024];
+    size_t k = 0;
+    explicit Staging(std::vector<uintptr_t>& o) : out(o) {}
+    void Flush() { out.insert(out.end(), buf, buf + k); k = 0; }
+    void Check() { if (k == 1024) Flush(); }
+};
+
+void Union(const uintptr_t* a, size_t na, const uintptr_t* b, size_t nb, std::vector<uintptr_t>& out) {
+    if (na < nb) { std::swap(a, b); std::swap(na, nb); }
+    if (nb * kSkew < na) {
+        size_t i = 0;
+        for (size_t j = 0; j < nb; ++j) {
+            size_t k = Gallop(a, na, i, b[j]);
+            out.insert(out.end(), a + i, a + k);
+            if (k == na || a[k] != b[j]) out.push_back(b[j]);
+            i = k;
+        }
+        out.insert(out.end(), a + i, a + na);
+        return;
+    }
+    Staging st(out);
+    size_t i = 0, j = 0;
+    while (i < na && j < nb) {
+        const uintptr_t x = a[i], y = b[j];
+        st.buf[st.k++] = x < y ? x : y;
+        i += x <= y;
+        j += y <= x;
+        st.Check();
+    }
+    st.Flush();
+    out.insert(out.end(), a + i, a + na);
+    out.insert(out.end(), b + j, b + nb);
+}
+
+void Intersect(const uintptr_t* a, size_t na, const uintptr_t* b, size_t nb, std::vector<uintptr_t>& out) {
+    if (na > nb) { std::swap(a, b); std::swap(na, nb); }
+    if (na * kSkew < nb) {
+        size_t j = 0;
+        for (size_t i = 0; i < na && j < nb; ++i) {
+            j = Gallop(b, nb, j, a[i]);
+            if (j < nb && b[j] == a[i]) out.push_back(a[i]);
+        }
+        return;
+    }
+    Staging st(out);
+    size_t i = 0, j = 0;
+    while (i < na && j < nb) {
+        const uintptr_t x = a[i], y = b[j];
+        st.buf[st.k] = x;
+        st.k += x == y;
+        i += x <= y;
+        j += y <= x;
+        st.Check();
+    }
+    st.Flush();
+}
+
+void Difference(const uintptr_t* a, size_t na, const uintptr_t* b, size_t nb, std::vector<uintptr_t>& out) {
+    if (nb * kSkew < na) {
+        // few removals: copy the runs of a between them
+        size_t i = 0;
+        for (size_t j = 0; j < nb && i < na; ++j) {
+            size_t k = Gallop(a, na, i, b[j]);
+            out.insert(out.end(), a + i, a + k);
+            i = (k < na && a[k] == b[j]) ? k + 1 : k;
+        }
+        out.insert(out.end(), a + i, a + na);
+        return;
+    }
+    if (na * kSkew < nb) {
+        size_t j = 0;
+        for (size_t i = 0; i < na; ++i) {
+            j = Gallop(b, nb, j, a[i]);
+            if (j == nb || b[j] != a[i]) out.push_back(a[i]);
+        }
+        return;
+    }
+    Staging st(out);
+    size_t i = 0, j = 0;
+    while (i < na && j < nb) {
+        const uintptr_t x = a[i], y = b[j];
+        st.buf[st.k] = x;
+        st.k += x < y;
+        i += x <= y;
+        j += y <= x;
+        st.Check();
+    }
+    st.Flush();
+    out.insert(out.end(), a + i, a + na);
+}
+
+void Near(const uintptr_t* a, size_t na, const uintptr_t* b, size_t nb, size_t window, std::vector<uintptr_t>& out) {
+    size_t j = 0;
+    for (size_t i = 0; i < na && j < nb; ++i) {
+        const uintptr_t lo = a[i] > window ? a[i] - window : 0;
+        j = Gallop(b, nb, j, lo);
+        if (j < nb && b[j] - lo <= (a[i] - lo) + window) out.push_back(a[i]);
+    }
+}
+
+} // namespace
+
+void CombineSorted(SetOp op, const uintptr_t* a, size_t na, const uintptr_t* b, size_t nb,
+                   std::vector<uintptr_t>& out, size_t window) {
+    out.clear();
+    out.reserve(op == SetOp::Union ? na + nb : op == SetOp::Intersect ? (std::min)(na, nb) : na);
+    if (op == SetOp::Near) { Near(a, na, b, nb, window, out); return; }
+    switch (op) {
+    case SetOp::Union:      Union(a, na, b, nb, out); break;
+    case SetOp::Intersect:  Intersect(a, na, b, nb, out); break;
+    case SetOp::Difference: Difference(a, na, b, nb, out); break;
+    case SetOp::Near:       break;
+    }
+}
+
+namespace {
+
+// Reads a store one block at a time; entries before pos are consumed.
+struct BlockCursor {
+    const ResultStore& store;
+    std::vector<uintptr_t> buf;
+    size_t block = 0, pos = 0;
+    bool failed = false;
+
+    explicit BlockCursor(const ResultStore& s) : store(s) {}
+
+    // Loads the next block once the current one is consumed; false at the end.
+    bool Fill() {
+        while (pos == buf.size()) {
+            if (failed || block >= store.BlockCount()) return false;
+            if (!store.ReadBlock(block++, buf)) { failed = true; buf.clear(); pos = 0; return false; }
+            pos = 0;
+        }
+        return true;
+    }
+    const uintptr_t* Data() const { return buf.data() + pos; }
+    size_t Left() const { return buf.size() - pos; }
+    // Entries of the current block up to and including hi.
+    size_t CountUpTo(uintptr_t hi) const { return (size_t)(std::upper_bound(Data(), Data() + Left(), hi) - Data()); }
+};
+
+// Copies what is left of c, block by block.
+void CopyRest(BlockCursor& c, ResultStore& out) {
+    while (c.Fill()) {
+        out.Append(c.Data(), c.Left());
+        c.pos = c.buf.size();
+    }
+}
+
+} // namespace
+
+bool CombineResults(SetOp op, const ResultStore& a, const ResultStore& b, ResultStore& out,
+                    std::atomic<bool>& cancel, std::atomic<float>& progress, size_t window) {
+    out.Clear();
+    BlockCursor ca(a), cb(b);
+    std::vector<uintptr_t> chunk;
+    const float total = (float)(std::max)(a.BlockCount() + b.BlockCount(), (size_t)1);
+    auto report = [&]() { progress = (float)(ca.block + cb.block) / total; };
+
+    if (op == SetOp::Near) {
+        // b's cursor only moves forward: the low end of the window grows with a.
+        while (!cancel && ca.Fill()) {
+            chunk.clear();
+            const uintptr_t* p = ca.Data();
+            const size_t n = ca.Left();
+            size_t i = 0;
+            for (; i < n; ++i) {
+                const uintptr_t lo = p[i] > window ? p[i] - window : 0;
+                while (cb.Fill()) {
+                    cb.pos += Gallop(cb.Data(), cb.Left(), 0, lo);
+                    if (cb.Left()) break;
+                }
+                if (!cb.Left()) break;
+                if (cb.Data()[0] - lo <= (p[i] - lo) + window) chunk.push_back(p[i]);
+            }
+            out.Append(chunk.data(), chunk.size());
+            ca.pos += n;
+            report();
+            if (i < n) break;   // b is used up
+        }
+        if (cancel) return false;
+        progress = 1.f;
+        return !ca.failed && !cb.failed;
+    }
+
+    // Both lists are combined up to the smaller of their current blocks' last
+    // entries, which uses up at least one of the blocks.
+    while (!cancel && ca.Fill() && cb.Fill()) {
+        const uintptr_t hi = (std::min)(ca.buf.back(), cb.buf.back());
+        const size_t na = ca.CountUpTo(hi), nb = cb.CountUpTo(hi);
+        CombineSorted(op, ca.Data(), na, cb.Data(), nb, chunk, window);
+        out.Append(chunk.data(), chunk.size());
+        ca.pos += na;
+        cb.pos += nb;
+        report();
+    }
+    if (cancel) return false;
+    if (op == SetOp::Union || op == SetOp::Difference) CopyRest(ca, out);
+    if (op == SetOp::Union) CopyRest(cb, out);
+    progress = 1.f;
+    return !ca.failed && !cb.failed;
+}
+
+}} // namespace
@@ -0,0 +1,237 @@
+#include <vector>
+#include <mutex>
+#include <new>
+#include <cstdio>
+#include <algorithm>
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#include <fcntl.h>
+#endif
+
+#include "include/REKit/memsearch/ResultStore.h"
+
+namespace REKit { namespace MemSearch {
+
+// Anonymous temp file, removed by the OS when closed.
+static FILE* OpenSpillFile() {
+#ifdef _WIN32
+    // tmpfile() wants the root of the current drive, which usually is not writable.
+    wchar_t dir[MAX_PATH], path[MAX_PATH];
+    if (!GetTempPathW(MAX_PATH, dir) || !GetTempFileNameW(dir, L"rks", 0, path)) return nullptr;
+    HANDLE h = CreateFileW(path, GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+                           FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE, nullptr);
+    if (h == INVALID_HANDLE_VALUE) return nullptr;
+    int fd = _open_osfhandle((intptr_t)h, _O_RDWR | _O_BINARY);
+    if (fd < 0) { CloseHandle(h); return nullptr; }
+    FILE* f = _fdopen(fd, "w+b");
+    if (!f) _close(fd);
+    return f;
+#else
+    return tmpfile();
+#endif
+}
+
+static bool SeekTo(FILE* f, uint64_t off) {
+#ifdef _WIN32
+    return _fseeki64(f, (long long)off, SEEK_SET) == 0;
+#else
+    return fseeko(f, (off_t)off, SEEK_SET) == 0;
+#endif
+}
+
+struct ResultStore::Impl {
+    struct Block {
+        std::vector<uintptr_t> mem;
+        uint64_t fileOff = 0;
+        bool     onDisk = false;
+    };
+
+    size_t budget = 0;
+    size_t count = 0;
+    size_t memBytes = 0;        // sealed blocks still in memory
+    size_t spilledBytes = 0;
+    size_t spillCursor = 0;     // sealed blocks before this index are on disk
+    bool   spillFailed = false;
+    bool   truncated = false;
+    std::vector<Block> sealed;
+    std::vector<uintptr_t> open;
+
+    FILE*    file = nullptr;
+    uint64_t fileEnd = 0;
+    mutable std::mutex io;
+    mutable std::vector<uintptr_t> cache;   // last block loaded by Get()
+    mutable size_t cachedBlock = (size_t)-1;
+
+    ~Impl() { if (file) fclose(file); }
+
+    bool SpillOne() {
+        if (spillCursor >= sealed.size() || spillFailed) return false;
+        Block& b = sealed[spillCursor];
+        std::lock_guard<std::mutex> lk(io);
+        if (!file) file = OpenSpillFile();
+        if (!file || !SeekTo(file, fileEnd)
+            || fwrite(b.mem.data(), sizeof(uintptr_t), b.mem.size(), file) != b.mem.size()) {
+            spillFailed = true;
+            return false;
+        }
+        size_t bytes = b.mem.size() * sizeof(uintptr_t);
+        b.fileOff = fileEnd;
+        b.onDisk = true;
+        fileEnd += bytes;
+        memBytes -= bytes;
+        spilledBytes += bytes;
+        std::vector<uintptr_t>().swap(b.mem);
+        ++spillCursor;
+        return true;
+    }
+
+    void Enforce() {
+        if (budget == 0) return;
+        while (memBytes + open.capacity() * sizeof(uintptr_t) > budget && SpillOne()) {}
+    }
+
+    // Moves the full open block to sealed; false if sealed cannot grow even
+    // after spilling, and the block stays open.
+    bool Seal() {
+        while (sealed.size() == sealed.capacity()) {
+            try { sealed.reserve(sealed.size() * 2 + 16); }
+            catch (const std::bad_alloc&) {
+                if (!SpillOne()) return false;
+            }
+        }
+        Block b;
+        b.mem.swap(open);
+        memBytes += b.mem.size() * sizeof(uintptr_t);
+        sealed.push_back(std::move(b));     // within capacity, cannot throw
+        Enforce();
+        return true;
+    }
+
+    bool ReserveOpen() {
+        if (open.capacity() >= kBlockEntries) return true;
+        for (;;) {
+            try { open.reserve(kBlockEntries); return true; }
+            catch (const std::bad_alloc&) {
+                if (!SpillOne()) return false;
+            }
+        }
+    }
+
+    // Loads a spilled block into out. Caller holds io.
+    bool LoadBlock(size_t bi, std::vector<uintptr_t>& out) const {
+        const Block& b = sealed[bi];
+        out.resize(kBlockEntries);
+        if (!SeekTo(file, b.fileOff)) return false;
+        return fread(out.data(), sizeof(uintptr_t), kBlockEntries, file) == kBlockEntries;
+    }
+};
+
+ResultStore::ResultStore(size_t memoryBudget) : impl_(new Impl) { impl_->budget = memoryBudget; }
+ResultStore::~ResultStore() = default;
+ResultStore::ResultStore(ResultStore&&) noexcept = default;
+ResultStore& ResultStore::operator=(ResultStore&&) noexcept = default;
+
+void ResultStore::SetMemoryBudget(size_t bytes) { impl_->budget = bytes; impl_->Enforce(); }
+size_t ResultStore::MemoryBudget() const { return impl_->budget; }
+
+void ResultStore::Swap(ResultStore& o) noexcept { impl_.swap(o.impl_); }
+
+void ResultStore::Clear() {
+    size_t budget = impl_ ? impl_->budget : 0;
+    impl_.reset(new Impl);
+    impl_->budget = budget;
+}
+
+void ResultStore::Append(const uintptr_t* p, size_t n) {
+    Impl& s = *impl_;
+    while (n > 0) {
+        // a block left full by a failed Seal is sealed again before anything is added
+        if ((s.open.size() == kBlockEntries && !s.Seal()) || !s.ReserveOpen()) { s.truncated = true; return; }
+        size_t take = (std::min)(n, kBlockEntries - s.open.size());
+        s.open.insert(s.open.end(), p, p + take);
+        s.count += take;
+        p += take; n -= take;
+        if (s.open.size() == kBlockEntries) s.Seal();
+    }
+}
+
+size_t ResultStore::Size() const { return impl_->count; }
+size_t ResultStore::BytesInMemory() const { return impl_->memBytes + impl_->open.capacity() * sizeof(uintptr_t); }
+size_t ResultStore::BytesSpilled() const { return impl_->spilledBytes; }
+bool   ResultStore::SpillFailed() const { return impl_->spillFailed; }
+bool   ResultStore::Truncated() const { return impl_->truncated; }
+
+uintptr_t ResultStore::Get(size_t i) const {
+    const Impl& s = *impl_;
+    size_t bi = i / kBlockEntries, off = i % kBlockEntries;
+    if (bi >= s.sealed.size()) return s.open[i - s.sealed.size() * kBlockEntries];
+    const Impl::Block& b = s.sealed[bi];
+    if (!b.onDisk) return b.mem[off];
+    std::lock_guard<std::mutex> lk(s.io);
+    if (s.cachedBlock != bi) {
+        if (!s.LoadBlock(bi, s.cache)) { s.cachedBlock = (size_t)-1; return 0; }
+        s.cachedBlock = bi;
+    }
+    return s.cache[off];
+}
+
+// Reading back a spilled block needs a block-sized buffer; running out of
+// memory for it fails the read like an unreadable spill file.
+bool ResultStore::ForEachBlock(const BlockFn& fn) const {
+    const Impl& s = *impl_;
+    std::vector<uintptr_t> tmp;
+    if (s.spillCursor > 0) {
+        try { tmp.reserve(kBlockEntries); }
+        catch (const std::bad_alloc&) { return false; }
+    }
+    for (size_t bi = 0; bi < s.sealed.size(); ++bi) {
+        const Impl::Block& b = s.sealed[bi];
+        if (!b.onDisk) {
+            if (!fn(b.mem.data(), b.mem.size())) return false;
+            continue;
+        }
+        {
+            std::lock_guard<std::mutex> lk(s.io);
+            if (!s.LoadBlock(bi, tmp)) return false;
+        }
+        if (!fn(tmp.data(), tmp.size())) return false;
+    }
+    if (!s.open.empty()) return fn(s.open.data(), s.open.size());
+    return true;
+}
+
+size_t ResultStore::BlockCount() const {
+    const Impl& s = *impl_;
+    return s.sealed.size() + (s.open.empty() ? 0 : 1);
+}
+
+bool ResultStore::ReadBlock(size_t bi, std::vector<uintptr_t>& out) const {
+    const Impl& s = *impl_;
+    try {
+        if (bi >= s.sealed.size()) {
+            if (bi > s.sealed.size()) return false;
+            out.assign(s.open.begin(), s.open.end());
+            return true;
+        }
+        const Impl::Block& b = s.sealed[bi];
+        if (!b.onDisk) { out.assign(b.mem.begin(), b.mem.end()); return true; }
+        std::lock_guard<std::mutex> lk(s.io);
+        return s.LoadBlock(bi, out);
+    }
+    catch (const std::bad_alloc&) {
+        out.clear();
+        return false;
+    }
+}
+
+bool ResultStore::ToVector(std::vector<uintptr_t>& out) const {
+    out.clear();
+    try { out.reserve(Size()); }
+    catch (const std::bad_alloc&) { return false; }
+    if (ForEachBlock([&](const uintptr_t* p, size_t n) { out.insert(out.end(), p, p + n); return true; })) return true;
+    out.clear();
+    return false;
+}
+
+}} // namespace
@@ -0,0 +1,612 @@
+#include <vector>
+#include <string>
+#include <map>
+#include <new>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <setjmp.h>
+#include <errno.h>
+#endif
+
+#include "include/REKit/memsearch/ScanAgent.h"
+#include "include/REKit/memsearch/ProcessMemory.h"
+
+namespace REKit { namespace MemSearch {
+
+namespace {
+
+const uint32_t kMagic = 0x54474152;     // "RAGT"
+const uint32_t kVersion = 1;
+const size_t   kRingSlots = 1 << 16;
+const size_t   kDataSize = 4 << 20;
+const uint64_t kStaleNs = 2000000000ull;    // no heartbeat for this long: the agent is gone
+
+enum : uint32_t { OpRead = 1, OpRegions = 2, OpFirstScan = 3 };
+
+// First-scan request at the start of the data window, followed by hexExpr and strExpr.
+struct ScanParams {
+    uint64_t base, length, alignment;
+    uint32_t type, autoPages;
+    int32_t  int32Val;
+    float    floatVal;
+    double   doubleVal;
+    uint32_t hexLen, strLen;
+};
+
+} // namespace
+
+// Fixed-width layout, so the two ends agree whatever they were built with.
+struct AgentShared {
+    uint32_t magic;                         // written last by the agent
+    uint32_t version;
+    uint32_t pid;                           // agent process
+    std::atomic<uint32_t> owner;            // client process attached, 0 = none
+    std::atomic<uint64_t> heartbeat;        // bumped by the serving thread every few ms at most
+    std::atomic<uint32_t> request;          // client: sequence of the request in the slot
+    std::atomic<uint32_t> reply;            // agent: sequence of the last request served
+    std::atomic<uint32_t> cancel;
+    std::atomic<uint32_t> progress;         // scan progress, parts per million
+    uint32_t op;
+    uint32_t ok;
+    uint64_t arg0, arg1;
+    uint64_t result;                        // bytes read, regions listed, hits sent
+    uint64_t scanned;                       // bytes a finished scan covered
+    uint64_t faults;                        // stripes cut short by a fault
+    char     status[128];
+    alignas(64) std::atomic<uint64_t> head; // hits written by the agent
+    alignas(64) std::atomic<uint64_t> tail; // hits taken by the client
+    alignas(64) uint64_t ring[kRingSlots];
+    uint8_t  data[kDataSize];
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+              "the shared block needs address-free atomics");
+
+namespace {
+
+std::string BlockName(unsigned pid) {
+    char name[64];
+#ifdef _WIN32
+    snprintf(name, sizeof(name), "Local\\REKitAgent%u", pid);
+#else
+    snprintf(name, sizeof(name), "/rekit-agent-%u", pid);
+#endif
+    return name;
+}
+
+#ifdef _WIN32
+unsigned CurrentPid() { return (unsigned)GetCurrentProcessId(); }
+
+bool ProcessAlive(unsigned pid) {
+    HANDLE h = OpenProcess(SYNCHRONIZE, FALSE, (DWORD)pid);
+    if (!h) return GetLastError() == ERROR_ACCESS_DENIED;
+    bool alive = WaitForSingleObject(h, 0) == WAIT_TIMEOUT;
+    CloseHandle(h);
+    return alive;
+}
+
+int FaultFilter(DWORD code) {
+    return code == EXCEPTION_ACCESS_VIOLATION || code == EXCEPTION_IN_PAGE_ERROR ? EXCEPTION_EXECUTE_HANDLER : EXCEPTION_CONTINUE_SEARCH;
+}
+
+bool TryCopy(void* dst, const void* src, size_t n) {
+    __try { memcpy(dst, src, n); return true; }
+    __except (FaultFilter(GetExceptionCode())) { return false; }
+}
+
+bool TryMatch(const FirstScanPlan& plan, const ChunkView& v, std::vector<uintptr_t>& out) {
+    __try { plan.Match(v, out); return true; }
+    __except (FaultFilter(GetExceptionCode())) { return false; }
+}
+#else
+unsigned CurrentPid() { return (unsigned)getpid(); }
+
+bool ProcessAlive(unsigned pid) { return kill((pid_t)pid, 0) == 0 || errno == EPERM; }
+
+// A fault inside a guarded call jumps back to it; any other goes to the
+// handler the target had installed.
+thread_local sigjmp_buf* tFaultJump = nullptr;
+struct sigaction gOldSegv, gOldBus;
+
+void OnFault(int sig, siginfo_t* info, void* ctx) {
+    if (tFaultJump) siglongjmp(*tFaultJump, 1);
+    struct sigaction& old = sig == SIGBUS ? gOldBus : gOldSegv;
+    if (old.sa_flags & SA_SIGINFO) { old.sa_sigaction(sig, info, ctx); return; }
+    if (old.sa_handler != SIG_DFL && old.sa_handler != SIG_IGN) { old.sa_handler(sig); return; }
+    sigaction(sig, &old, nullptr);  // the faulting instruction runs again under the old disposition
+}
+
+bool TryCopy(void* dst, const void* src, size_t n) {
+    sigjmp_buf jb;
+    if (sigsetjmp(jb, 1)) { tFaultJump = nullptr; return false; }
+    tFaultJump = &jb;
+    memcpy(dst, src, n);
+    tFaultJump = nullptr;
+    return true;
+}
+
+bool TryMatch(const FirstScanPlan& plan, const ChunkView& v, std::vector<uintptr_t>& out) {
+    sigjmp_buf jb;
+    if (sigsetjmp(jb, 1)) { tFaultJump = nullptr; return false; }
+    tFaultJump = &jb;
+    plan.Match(v, out);
+    tFaultJump = nullptr;
+    return true;
+}
+#endif
+
+// Copies what can be read from the front of [src, src + n).
+size_t GuardedCopy(void* dst, uintptr_t src, size_t n) {
+    if (TryCopy(dst, (const void*)src, n)) return n;
+    size_t done = 0;
+    while (done < n) {
+        size_t k = (size_t)(std::min<uintptr_t>)(n - done, ((src + done) | 0xFFF) + 1 - (src + done));
+        if (!TryCopy((uint8_t*)dst + done, (const void*)(src + done), k)) break;
+        done += k;
+    }
+    return done;
+}
+
+// The agent's own address space, scanned in place.
+class SelfMemory : public IMemorySource {
+public:
+    SelfMemory(uintptr_t skip, size_t skipSize) : self_(CurrentPid()), skip_(skip), skipEnd_(skip + skipSize) {}
+
+    bool IsOpen() const override { return self_.IsOpen(); }
+    unsigned int Pid() const override { return 0; }
+    size_t Read(uintptr_t addr, void* dst, size_t n) const override { return GuardedCopy(dst, addr, n); }
+
+    // Readable regions with Region::local pointing at themselves, minus the shared block.
+    void EnumReadableRegions(std::vector<Region>& out, uintptr_t clipBase = 0, uintptr_t clipEnd = 0) const override {
+        std::vector<Region> regs;
+        self_.EnumReadableRegions(regs, clipBase, clipEnd);
+        out.clear();
+        for (auto& r : regs) {
+            uintptr_t b = r.base, e = r.base + r.size;
+            if (b < skipEnd_ && skip_ < e) {
+                if (b < skip_) out.push_back({ b, (size_t)(skip_ - b), (const uint8_t*)b });
+                if (skipEnd_ < e) out.push_back({ skipEnd_, (size_t)(e - skipEnd_), (const uint8_t*)skipEnd_ });
+                continue;
+            }
+            out.push_back({ b, r.size, (const uint8_t*)b });
+        }
+    }
+
+private:
+    ProcessMemory self_;
+    uintptr_t skip_, skipEnd_;
+};
+
+void SetStatus(AgentShared* sh, const std::string& s) {
+    size_t n = (std::min)(s.size(), sizeof(sh->status) - 1);
+    memcpy(sh->status, s.data(), n);
+    sh->status[n] = 0;
+}
+
+void ServeRead(AgentShared* sh) {
+    size_t n = (size_t)(std::min<uint64_t>)(sh->arg1, kDataSize);
+    sh->result = GuardedCopy(sh->data, (uintptr_t)sh->arg0, n);
+    sh->ok = 1;
+}
+
+void ServeRegions(AgentShared* sh, const SelfMemory& self) {
+    std::vector<Region> regs;
+    self.EnumReadableRegions(regs, (uintptr_t)sh->arg0, (uintptr_t)sh->arg1);
+    size_t n = (std::min)(regs.size(), kDataSize / 16);
+    uint64_t* d = (uint64_t*)sh->data;
+    for (size_t i = 0; i < n; ++i) { d[i * 2] = regs[i].base; d[i * 2 + 1] = regs[i].size; }
+    sh->result = n;
+    sh->ok = 1;
+}
+
+void ServeFirstScan(AgentShared* sh, const SelfMemory& self) {
+    ScanParams p;
+    memcpy(&p, sh->data, sizeof(p));
+    if (sizeof(p) + (uint64_t)p.hexLen + p.strLen > kDataSize) { SetStatus(sh, "Bad scan request"); return; }
+    ScanOptions opt;
+    opt.base = (uintptr_t)p.base;
+    opt.length = (size_t)p.length;
+    opt.alignment = (size_t)p.alignment;
+    opt.type = (ScanType)p.type;
+    opt.autoPages = p.autoPages != 0;
+    opt.cachedRegions = false;
+    opt.moduleFiles = false;
+    opt.int32Val = p.int32Val;
+    opt.floatVal = p.floatVal;
+    opt.doubleVal = p.doubleVal;
+    opt.hexExpr.assign((const char*)sh->data + sizeof(p), p.hexLen);
+    opt.strExpr.assign((const char*)sh->data + sizeof(p) + p.hexLen, p.strLen);
+
+    std::string status;
+    FirstScanPlan plan;
+    if (!plan.Prepare(self, opt, status, nullptr)) { SetStatus(sh, status); return; }
+
+    std::atomic<bool> cancel{false};
+    std::atomic<float> progress{0.f};
+    std::atomic<uint64_t> faults{0};
+    uint64_t head = sh->head.load(std::memory_order_relaxed), sent = 0;
+    // Runs under the committer lock, so there is one producer at a time.
+    HitSink sink = [&](const uintptr_t* a, size_t n) {
+        size_t i = 0;
+        while (i < n) {
+            uint64_t space = kRingSlots - (head - sh->tail.load(std::memory_order_acquire));
+            if (space == 0) {
+                if (cancel) return;
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+                continue;
+            }
+            size_t k = (size_t)(std::min<uint64_t>)(space, n - i);
+            for (size_t j = 0; j < k; ++j) sh->ring[(head + j) % kRingSlots] = a[i + j];
+            head += k;
+            i += k;
+            sent += k;
+            sh->head.store(head, std::memory_order_release);
+        }
+    };
+
+    OrderedCommitter committer;
+    committer.Reset(plan.Stripes().size());
+    std::atomic<bool> finished{false};
+    std::thread worker([&] {
+        WalkStripes(self, plan.Stripes(), plan.Walk(), cancel, progress,
+            [&](const ChunkView& v) {
+                std::vector<uintptr_t>& out = committer.Slot(v.stripe);
+                size_t before = out.size();
+                if (!TryMatch(plan, v, out)) { out.resize(before); faults.fetch_add(1); }
+            },
+            [&](size_t si) { committer.Finish(si, sink); });
+        committer.FinishAll(sink);
+        finished = true;
+    });
+    // Keep beating, and follow the client's cancel and liveness.
+    for (unsigned tick = 0; !finished; ++tick) {
+        sh->heartbeat.fetch_add(1, std::memory_order_relaxed);
+        sh->progress.store((uint32_t)(progress.load() * 1e6f), std::memory_order_relaxed);
+        if (sh->cancel.load()) cancel = true;
+        if (tick % 256 == 0) {
+            uint32_t owner = sh->owner.load();
+            if (owner && !ProcessAlive(owner)) cancel = true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    worker.join();
+    sh->result = sent;
+    sh->scanned = cancel ? (uint64_t)(progress.load() * plan.TotalBytes()) : plan.TotalBytes();
+    sh->faults = faults;
+    sh->ok = 1;
+    SetStatus(sh, cancel ? "Canceled" : "Done");
+}
+
+void Serve(AgentShared* sh, const std::atomic<bool>& stop) {
+    SelfMemory self((uintptr_t)sh, sizeof(AgentShared));
+    uint32_t seen = sh->request.load();
+    unsigned idle = 0;
+    while (!stop) {
+        sh->heartbeat.fetch_add(1, std::memory_order_relaxed);
+        uint32_t r = sh->request.load(std::memory_order_acquire);
+        if (r == seen) {
+            // stay responsive for a burst of reads, then poll gently
+            if (++idle < 20000) std::this_thread::yield();
+            else std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+        seen = r;
+        idle = 0;
+        sh->ok = 0;
+        sh->result = 0;
+        sh->status[0] = 0;
+        if (sh->op == OpRead) ServeRead(sh);
+        else if (sh->op == OpRegions) ServeRegions(sh, self);
+        else if (sh->op == OpFirstScan) ServeFirstScan(sh, self);
+        else SetStatus(sh, "Unknown request");
+        sh->reply.store(r, std::memory_order_release);
+    }
+}
+
+struct AgentState {
+    AgentShared* sh = nullptr;
+    void* mapping = nullptr;    // HANDLE on Windows
+    std::thread thread;
+    std::atomic<bool> stop{false};
+    unsigned owner = 0;         // pid that published sh; a forked child inherits sh but not the thread
+};
+
+// Never destroyed: static destructors may run before the library's unload hook.
+AgentState& Agent() {
+    static AgentState* s = new AgentState();
+    return *s;
+}
+
+// Clients of this process attached to each agent pid.
+struct Attachment { int refs = 0; std::shared_ptr<std::mutex> mu; };
+std::mutex gAttachMu;
+std::map<unsigned, Attachment> gAttached;
+
+} // namespace
+
+bool StartScanAgent() {
+    AgentState& a = Agent();
+    if (a.sh) return a.owner == CurrentPid();
+    const std::string name = BlockName(CurrentPid());
+#ifdef _WIN32
+    const uint64_t size = sizeof(AgentShared);
+    HANDLE m = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, (DWORD)(size >> 32), (DWORD)size, name.c_str());
+    if (!m) return false;
+    void* v = MapViewOfFile(m, FILE_MAP_READ | FILE_MAP_WRITE, 0, 0, sizeof(AgentShared));
+    if (!v) { CloseHandle(m); return false; }
+    a.mapping = m;
+#else
+    int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0) return false;
+    void* v = MAP_FAILED;
+    if (ftruncate(fd, sizeof(AgentShared)) == 0) v = mmap(nullptr, sizeof(AgentShared), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (v == MAP_FAILED) { shm_unlink(name.c_str()); return false; }
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_sigaction = OnFault;
+    sa.sa_flags = SA_SIGINFO;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGSEGV, &sa, &gOldSegv);
+    sigaction(SIGBUS, &sa, &gOldBus);
+#endif
+    AgentShared* sh = new (v) AgentShared();
+    sh->version = kVersion;
+    sh->pid = CurrentPid();
+    std::atomic_thread_fence(std::memory_order_release);
+    sh->magic = kMagic;
+    a.sh = sh;
+    a.owner = CurrentPid();
+    a.stop = false;
+    a.thread = std::thread(Serve, sh, std::cref(a.stop));
+    return true;
+}
+
+void StopScanAgent() {
+    AgentState& a = Agent();
+    if (!a.sh) return;
+    if (a.owner != CurrentPid()) {
+        // Forked child exiting: the block and its name still belong to the parent's agent.
+        a.sh = nullptr;
+        return;
+    }
+    a.stop = true;
+    if (a.thread.joinable()) a.thread.join();
+    a.sh->magic = 0;
+#ifdef _WIN32
+    UnmapViewOfFile(a.sh);
+    CloseHandle((HANDLE)a.mapping);
+    a.mapping = nullptr;
+#else
+    munmap(a.sh, sizeof(AgentShared));
+    shm_unlink(BlockName(CurrentPid()).c_str());
+    sigaction(SIGSEGV, &gOldSegv, nullptr);
+    sigaction(SIGBUS, &gOldBus, nullptr);
+#endif
+    a.sh = nullptr;
+}
+
+ScanAgentClient::~ScanAgentClient() { Disconnect(); }
+
+bool ScanAgentClient::Connect(unsigned int pid) {
+    Disconnect();
+    const std::string name = BlockName(pid);
+#ifdef _WIN32
+    HANDLE m = OpenFileMappingA(FILE_MAP_READ | FILE_MAP_WRITE, FALSE, name.c_str());
+    if (!m) return false;
+    void* v = MapViewOfFile(m, FILE_MAP_READ | FILE_MAP_WRITE, 0, 0, sizeof(AgentShared));
+    if (!v) { CloseHandle(m); return false; }
+#else
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) return false;
+    struct stat st;
+    void* v = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && (uint64_t)st.st_size >= sizeof(AgentShared))
+        v = mmap(nullptr, sizeof(AgentShared), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (v == MAP_FAILED) return false;
+#endif
+    AgentShared* sh = (AgentShared*)v;
+    bool ok = sh->magic == kMagic && sh->version == kVersion && sh->pid == pid;
+    if (ok) {
+        // a block left behind by a dead process does not beat
+        ok = false;
+        const uint64_t beat = sh->heartbeat.load(), t0 = ScanStats::NowNs();
+        while (ScanStats::NowNs() - t0 < 250000000ull) {
+            if (sh->heartbeat.load() != beat) { ok = true; break; }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    std::shared_ptr<std::mutex> mu;
+    if (ok) {
+        std::lock_guard<std::mutex> lk(gAttachMu);
+        const uint32_t me = CurrentPid();
+        uint32_t cur = sh->owner.load();
+        while (ok && cur != me) {
+            if (cur && ProcessAlive(cur)) ok = false;      // another tool is attached
+            else if (sh->owner.compare_exchange_weak(cur, me)) break;
+        }
+        if (ok) {
+            Attachment& at = gAttached[pid];
+            if (!at.mu) at.mu = std::make_shared<std::mutex>();
+            ++at.refs;
+            mu = at.mu;
+        }
+    }
+    if (!ok) {
+#ifdef _WIN32
+        UnmapViewOfFile(v);
+        CloseHandle(m);
+#else
+        munmap(v, sizeof(AgentShared));
+#endif
+        return false;
+    }
+    sh_ = sh;
+#ifdef _WIN32
+    mapping_ = m;
+#endif
+    pid_ = pid;
+    mu_ = mu;
+    return true;
+}
+
+void ScanAgentClient::Disconnect() {
+    if (!sh_) return;
+    {
+        std::lock_guard<std::mutex> lk(gAttachMu);
+        auto it = gAttached.find(pid_);
+        if (it != gAttached.end() && --it->second.refs == 0) {
+            gAttached.erase(it);
+            uint32_t me = CurrentPid();
+            sh_->owner.compare_exchange_strong(me, 0);
+        }
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(sh_);
+    CloseHandle((HANDLE)mapping_);
+#else
+    munmap(sh_, sizeof(AgentShared));
+#endif
+    sh_ = nullptr;
+    mapping_ = nullptr;
+    pid_ = 0;
+    mu_.reset();
+}
+
+bool ScanAgentClient::Alive(uint64_t& beat, uint64_t& since) const {
+    uint64_t b = sh_->heartbeat.load(std::memory_order_relaxed), now = ScanStats::NowNs();
+    if (b != beat) { beat = b; since = now; return true; }
+    return now - since < kStaleNs;
+}
+
+bool ScanAgentClient::Wait(uint32_t seq) const {
+    uint64_t beat = sh_->heartbeat.load(), since = ScanStats::NowNs();
+    for (unsigned spins = 0; sh_->reply.load(std::memory_order_acquire) != seq; ++spins) {
+        if (!Alive(beat, since)) return false;
+        if (spins < 1000) std::this_thread::yield();
+        else std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    return true;
+}
+
+bool ScanAgentClient::Call(uint32_t op, uint64_t arg0, uint64_t arg1) const {
+    // a request of a client that went away may still be running
+    if (!Wait(sh_->request.load())) return false;
+    sh_->op = op;
+    sh_->arg0 = arg0;
+    sh_->arg1 = arg1;
+    sh_->cancel = 0;
+    const uint32_t seq = sh_->request.load() + 1;
+    sh_->request.store(seq, std::memory_order_release);
+    return Wait(seq) && sh_->ok != 0;
+}
+
+size_t ScanAgentClient::Read(uintptr_t addr, void* dst, size_t n) const {
+    if (!sh_) return 0;
+    std::lock_guard<std::mutex> lk(*mu_);
+    size_t done = 0;
+    while (done < n) {
+        size_t k = (std::min)(n - done, kDataSize);
+        if (!Call(OpRead, addr + done, k)) break;
+        size_t got = (size_t)(std::min<uint64_t>)(sh_->result, k);
+        memcpy((uint8_t*)dst + done, sh_->data, got);
+        done += got;
+        if (got < k) break;
+    }
+    return done;
+}
+
+void ScanAgentClient::EnumReadableRegions(std::vector<Region>& out, uintptr_t clipBase, uintptr_t clipEnd) const {
+    out.clear();
+    if (!sh_) return;
+    std::lock_guard<std::mutex> lk(*mu_);
+    if (!Call(OpRegions, clipBase, clipEnd)) return;
+    const uint64_t* d = (const uint64_t*)sh_->data;
+    out.reserve((size_t)sh_->result);
+    for (uint64_t i = 0; i < sh_->result; ++i) out.push_back({ (uintptr_t)d[i * 2], (size_t)d[i * 2 + 1] });
+}
+
+bool ScanAgentClient::Supports(const ScanOptions& opt) {
+    return opt.type != ScanType::Group;
+}
+
+bool ScanAgentClient::FirstScan(const ScanOptions& opt, const HitSink& sink, std::atomic<bool>& cancel,
+                                std::atomic<float>& progress, std::string& status, ScanStats* stats) const {
+    if (!sh_) { status = "Scan agent not connected"; return false; }
+    if (!Supports(opt)) { status = "Scan agent does not run group scans"; return false; }
+    ScanParams p;
+    memset(&p, 0, sizeof(p));
+    p.base = opt.base;
+    p.length = opt.length;
+    p.alignment = opt.alignment;
+    p.type = (uint32_t)opt.type;
+    p.autoPages = opt.autoPages;
+    p.int32Val = opt.int32Val;
+    p.floatVal = opt.floatVal;
+    p.doubleVal = opt.doubleVal;
+    p.hexLen = (uint32_t)opt.hexExpr.size();
+    p.strLen = (uint32_t)opt.strExpr.size();
+    if (sizeof(p) + opt.hexExpr.size() + opt.strExpr.size() > kDataSize) { status = "Pattern too long for the scan agent"; return false; }
+
+    std::lock_guard<std::mutex> lk(*mu_);
+    if (!Wait(sh_->request.load())) { status = "Scan agent stopped responding"; return false; }
+    // hits a client that went away left in the ring are dropped
+    uint64_t tail = sh_->head.load();
+    sh_->tail.store(tail);
+    memcpy(sh_->data, &p, sizeof(p));
+    memcpy(sh_->data + sizeof(p), opt.hexExpr.data(), p.hexLen);
+    memcpy(sh_->data + sizeof(p) + p.hexLen, opt.strExpr.data(), p.strLen);
+    sh_->op = OpFirstScan;
+    sh_->cancel = 0;
+    sh_->progress = 0;
+    const uint32_t seq = sh_->request.load() + 1;
+    sh_->request.store(seq, std::memory_order_release);
+
+    // Drain the ring until the agent has replied and everything it sent is taken.
+    std::vector<uintptr_t> batch;
+    uint64_t beat = sh_->heartbeat.load(), since = ScanStats::NowNs();
+    for (unsigned idle = 0;;) {
+        const bool served = sh_->reply.load(std::memory_order_acquire) == seq;
+        const uint64_t head = sh_->head.load(std::memory_order_acquire);
+        if (head != tail) {
+            batch.clear();
+            for (uint64_t i = tail; i != head; ++i) batch.push_back((uintptr_t)sh_->ring[i % kRingSlots]);
+            tail = head;
+            sh_->tail.store(tail, std::memory_order_release);
+            sink(batch.data(), batch.size());
+            idle = 0;
+            continue;
+        }
+        if (served) break;
+        if (cancel) sh_->cancel = 1;
+        progress = (float)sh_->progress.load(std::memory_order_relaxed) / 1e6f;
+        if (!Alive(beat, since)) { status = "Scan agent stopped responding"; return false; }
+        if (++idle < 100) std::this_thread::yield();
+        else std::this_thread::sleep_for(std::chrono::microseconds(500));
+    }
+    status = sh_->status;
+    if (!sh_->ok) return false;
+    if (stats) {
+        ScanThreadStats& st = stats->Thread(0);
+        ScanThreadStats::Add(st.bytesRequested, sh_->scanned);
+        ScanThreadStats::Add(st.bytesRead, sh_->scanned);
+        ScanThreadStats::Add(st.readFailures, sh_->faults);
+        ScanThreadStats::Add(st.hits, sh_->result);
+    }
+    if (!cancel) progress = 1.f;
+    return true;
+}
+
+}} // namespace
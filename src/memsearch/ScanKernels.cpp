@@ -0,0 +1,110 @@
+#include <vector>
+#include <string>
+#include <cctype>
+#include <cstring>
+#include <algorithm>
+
+#include "include/REKit/memsearch/ScanKernels.h"
+
+namespace REKit { namespace MemSearch {
+
+// Utility: parse hex with optional spaces and '?' wildcards into pattern+mask.
+bool ParseHexWithMask(const std::string& src, std::vector<uint8_t>& pat, std::vector<uint8_t>& mask) {
+    pat.clear(); mask.clear();
+    std::string s;
+    s.reserve(src.size());
+    for (char c : src) { if (!isspace((unsigned char)c)) s.push_back(c); }
+    if (s.size() == 0) return false;
+    if (s.size() % 2 != 0) return false;
+    for (size_t i = 0; i < s.size(); i += 2) {
+        auto cvt = [](char c)->int {
+            if (c >= '0' && c <= '9') return c - '0';
+            if (c >= 'a' && c <= 'f') return 10 + (c - 'a');
+            if (c >= 'A' && c <= 'F') return 10 + (c - 'A');
+            if (c == '?') return -1;
+            return -2;
+        };
+        int hi = cvt(s[i]);
+        int lo = cvt(s[i+1]);
+        if (hi == -2 || lo == -2) return false;
+        uint8_t m = 0xFF, v = 0;
+        if (hi >= 0) { v = (uint8_t)(hi << 4); } else { m &= 0x0F; }
+        if (lo >= 0) { v |= (uint8_t)lo; }      else { m &= 0xF0; }
+        pat.push_back(v);
+        mask.push_back(m);
+    }
+    return true;
+}
+
+// Offset of the first address at or after baseAddr that is a multiple of step.
+// Alignment is of addresses, like in SigProgram and GroupMatcher, so chunks
+// may start anywhere.
+static size_t FirstAligned(uintptr_t baseAddr, size_t step) {
+    return step > 1 ? (size_t)((step - baseAddr % step) % step) : 0;
+}
+
+// BMH for bytes with mask and alignment
+void SearchBufferMasked(const uint8_t* buf, size_t n, size_t owned, const uint8_t* pat, const uint8_t* mask, size_t m, size_t alignment, uintptr_t baseAddr, std::vector<uintptr_t>& out) {
+    if (m == 0 || n < m) return;
+    const size_t step = (alignment > 0 ? alignment : 1);
+    size_t i = FirstAligned(baseAddr, step);
+    const size_t last = (std::min)(n - m + 1, owned);
+    // naive masked compare; can be optimized with skip table if needed
+    for (; i < last; i += step) {
+        size_t k = 0;
+        for (; k < m; ++k) {
+            if ((buf[i+k] & mask[k]) != (pat[k] & mask[k])) break;
+        }
+        if (k == m) out.push_back(baseAddr + i);
+    }
+}
+
+size_t ValueMatchSize(ScanType t, const ScanOptions& opt) {
+    switch (t) {
+    case ScanType::Int32:  return sizeof(int32_t);
+    case ScanType::Float:  return sizeof(float);
+    case ScanType::Double: return sizeof(double);
+    case ScanType::Ascii:  return opt.strExpr.size();
+    case ScanType::Utf16:  return opt.strExpr.size() * 2;
+    default:               return 0;
+    }
+}
+
+void SearchBufferValue(const uint8_t* buf, size_t n, size_t owned, ScanType t, const ScanOptions& opt, uintptr_t baseAddr, std::vector<uintptr_t>& out) {
+    size_t step = (opt.alignment > 0 ? opt.alignment : 1);
+    const size_t m = ValueMatchSize(t, opt);
+    if (m == 0 || n < m) return;
+    // match starts: i + m <= n, and only the owned part of the chunk
+    const size_t last = (std::min)(n - m + 1, owned);
+    const size_t first = FirstAligned(baseAddr, step);
+    if (t == ScanType::Int32) {
+        for (size_t i = first; i < last; i += step) {
+            int32_t v; memcpy(&v, buf + i, sizeof(v));
+            if (v == opt.int32Val) out.push_back(baseAddr + i);
+        }
+    } else if (t == ScanType::Float) {
+        for (size_t i = first; i < last; i += step) {
+            float v; memcpy(&v, buf + i, sizeof(v));
+            if (v == opt.floatVal) out.push_back(baseAddr + i);
+        }
+    } else if (t == ScanType::Double) {
+        for (size_t i = first; i < last; i += step) {
+            double v; memcpy(&v, buf + i, sizeof(v));
+            if (v == opt.doubleVal) out.push_back(baseAddr + i);
+        }
+    } else if (t == ScanType::Ascii) {
+        const std::string& s = opt.strExpr;
+        for (size_t i = first; i < last; i += step) {
+            if (memcmp(buf + i, s.data(), m) == 0) out.push_back(baseAddr + i);
+        }
+    } else if (t == ScanType::Utf16) {
+        // naive UTF-16LE match, widened the same way as the next-scan filter
+        std::vector<uint8_t> pat(m, 0);
+        for (size_t k = 0; k < opt.strExpr.size(); ++k) pat[k * 2] = (uint8_t)opt.strExpr[k];
+        for (size_t i = first; i < last; i += step) {
+            if (memcmp(buf + i, pat.data(), m) == 0) out.push_back(baseAddr + i);
+        }
+    }
+}
+
+}} // namespace
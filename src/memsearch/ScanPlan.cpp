@@ -0,0 +1,207 @@
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cstring>
+
+#include "include/REKit/memsearch/ScanPlan.h"
+#include "include/REKit/memsearch/ScanKernels.h"
+
+namespace REKit { namespace MemSearch {
+
+std::shared_ptr<const IMemorySource> OpenScanSource(const ScanOptions& opt) {
+    if (opt.source) return opt.source;
+    return ProcessAccess::Shared().Memory(opt.pid);
+}
+
+bool FirstScanPlan::Prepare(const IMemorySource& mem, const ScanOptions& opt, std::string& status, ScanStats* stats) {
+    opt_ = opt;
+    std::vector<Region> regs;
+    // the region cache tracks live processes by pid
+    const bool cached = opt.cachedRegions && dynamic_cast<const ProcessMemory*>(&mem) != nullptr;
+    if (opt.autoPages) {
+        uintptr_t end = 0;
+        if (opt.length > 0) end = opt.base + opt.length;
+        uint64_t t0 = ScanStats::NowNs();
+        if (cached) RegionMapCache::Shared().Regions(mem, regs, opt.length > 0 ? opt.base : 0, end);
+        else mem.EnumReadableRegions(regs, opt.length > 0 ? opt.base : 0, end);
+        images_.Clear();
+        if (opt.moduleFiles && images_.Open(mem)) images_.Overlay(regs);
+        if (stats) stats->AddEnumerate(ScanStats::NowNs() - t0);
+    }
+    else {
+        if (opt.length == 0) { status = "Length is zero"; return false; }
+        regs.push_back({ opt.base, opt.length });
+    }
+    if (regs.empty()) { status = "No readable regions"; return false; }
+
+    useSig_ = opt.type == ScanType::Bytes && SigProgram::IsExtended(opt.hexExpr);
+    if (useSig_) {
+        std::string err;
+        if (!sig_.Compile(opt.hexExpr, &err)) { status = "Invalid signature: " + err; return false; }
+    }
+    else if (opt.type == ScanType::Bytes) {
+        if (!ParseHexWithMask(opt.hexExpr, pat_, mask_)) { status = "Invalid hex pattern"; return false; }
+    }
+    if (opt.type == ScanType::Group) {
+        if (!group_.Compile(opt.group, opt.alignment)) { status = "Invalid group (empty, or terms do not fit the window)"; return false; }
+    }
+
+    // Overlap chunks by the longest match so hits spanning a chunk boundary are not lost.
+    size_t valueSize = 1;
+    if (useSig_) valueSize = sig_.MaxLength();
+    else if (opt.type == ScanType::Bytes) valueSize = pat_.size();
+    else if (opt.type == ScanType::Group) valueSize = group_.Window() + 1;
+    else valueSize = (std::max<size_t>)(ValueMatchSize(opt.type, opt), 1);
+
+    wo_ = WalkOptions();
+    wo_.overlap = valueSize - 1;
+    if (cached) wo_.largeChunkSize = 1 << 20;   // coalesced runs: fewer, bigger reads
+    wo_.stats = stats;
+    stripes_ = PlanStripes(regs, wo_.stripeSize);
+    totalBytes_ = 0;
+    for (auto& s : stripes_) totalBytes_ += s.size;
+    return true;
+}
+
+void FirstScanPlan::Match(const ChunkView& v, std::vector<uintptr_t>& out) const {
+    size_t before = out.size();
+    if (useSig_) {
+        sig_.Search(v.data, v.size, v.ownedSize, v.addr, out, opt_.alignment);
+    }
+    else if (opt_.type == ScanType::Bytes) {
+        SearchBufferMasked(v.data, v.size, v.ownedSize, pat_.data(), mask_.data(), pat_.size(), opt_.alignment, v.addr, out);
+    }
+    else if (opt_.type == ScanType::Group) {
+        group_.Search(v.data, v.size, v.ownedSize, v.addr, out);
+    }
+    else {
+        SearchBufferValue(v.data, v.size, v.ownedSize, opt_.type, opt_, v.addr, out);
+    }
+    if (wo_.stats) ScanThreadStats::Add(wo_.stats->Thread(v.worker).hits, out.size() - before);
+}
+
+bool NextScanFilter::Prepare(const ScanOptions& opt) {
+    opt_ = opt;
+    valueSize_ = 1;
+    if (opt.type == ScanType::Int32) valueSize_ = sizeof(int32_t);
+    else if (opt.type == ScanType::Float) valueSize_ = sizeof(float);
+    else if (opt.type == ScanType::Double) valueSize_ = sizeof(double);
+    else if (opt.type == ScanType::Ascii) valueSize_ = opt.strExpr.size();
+    else if (opt.type == ScanType::Utf16) {
+        // naive widen check
+        valueSize_ = opt.strExpr.size() * 2;
+        pat_.assign(valueSize_, 0);
+        for (size_t i = 0; i < opt.strExpr.size(); ++i) pat_[i * 2] = (uint8_t)opt.strExpr[i];
+    }
+    else if (opt.type == ScanType::Bytes && SigProgram::IsExtended(opt.hexExpr)) {
+        if (!sig_.Compile(opt.hexExpr)) return false;
+        useSig_ = true;
+        valueSize_ = sig_.MaxLength();
+    }
+    else if (opt.type == ScanType::Bytes) {
+        if (!ParseHexWithMask(opt.hexExpr, pat_, mask_)) return false;
+        valueSize_ = pat_.size();
+    }
+    else if (opt.type == ScanType::Group) {
+        if (!group_.Compile(opt.group, opt.alignment)) return false;
+        valueSize_ = group_.Window();
+    }
+    return valueSize_ > 0;
+}
+
+void NextScanFilter::Filter(const IMemorySource& mem, const uintptr_t* addrs, size_t n, std::vector<uintptr_t>& kept,
+                            std::atomic<bool>& cancel, WalkProgress& prog, ScanThreadStats* st) const {
+    // For Increased/Decreased/Changed/Unchanged, we need a previous snapshot of values.
+    // Here we keep it simple and do Exact re-check; extend as you wish.
+    uint8_t buf[256];
+    std::vector<uint8_t> big;
+    uint8_t* p = buf;
+    if (valueSize_ > sizeof(buf)) { big.resize(valueSize_); p = big.data(); }
+
+    size_t pending = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (cancel) break;
+        uintptr_t addr = addrs[i];
+        if (++pending == 1024) { prog.Add(pending); pending = 0; }
+        uint64_t t0 = st ? ScanStats::NowNs() : 0;
+        size_t want = valueSize_;
+        size_t br = mem.Read(addr, p, want);
+        if (br < want && (opt_.type == ScanType::Group || useSig_)) {
+            // the window may run into an unmapped page; the match itself can still fit before it
+            want = (std::min)(want, (size_t)(((addr | 0xFFF) + 1) - addr));
+            br = mem.Read(addr, p, want);
+        }
+        uint64_t t1 = st ? ScanStats::NowNs() : 0;
+        if (st) {
+            ScanThreadStats::Add(st->readCalls, 1);
+            ScanThreadStats::Add(st->bytesRequested, want);
+            ScanThreadStats::Add(st->bytesRead, br);
+            ScanThreadStats::Add(st->readNs, t1 - t0);
+        }
+        if (br < want) {
+            if (st) ScanThreadStats::Add(st->readFailures, 1);
+            continue;
+        }
+        bool keep = false;
+        if (useSig_) {
+            keep = sig_.MatchAt(p, br);
+        } else if (opt_.type == ScanType::Bytes) {
+            keep = true;
+            for (size_t k = 0; k < pat_.size(); ++k) {
+                if ((p[k] & mask_[k]) != (pat_[k] & mask_[k])) { keep = false; break; }
+            }
+        } else if (opt_.type == ScanType::Ascii) {
+            keep = (memcmp(p, opt_.strExpr.data(), valueSize_) == 0);
+        } else if (opt_.type == ScanType::Utf16) {
+            keep = (memcmp(p, pat_.data(), valueSize_) == 0);
+        } else if (opt_.type == ScanType::Int32) {
+            int32_t v; memcpy(&v, p, sizeof(v));
+            keep = (opt_.cmp == CompareMode::Exact) ? (v == opt_.int32Val) : true;
+        } else if (opt_.type == ScanType::Float) {
+            float v; memcpy(&v, p, sizeof(v));
+            keep = (opt_.cmp == CompareMode::Exact) ? (v == opt_.floatVal) : true;
+        } else if (opt_.type == ScanType::Double) {
+            double v; memcpy(&v, p, sizeof(v));
+            keep = (opt_.cmp == CompareMode::Exact) ? (v == opt_.doubleVal) : true;
+        } else if (opt_.type == ScanType::Group) {
+            keep = group_.MatchAt(p, br, addr);
+        }
+        if (keep) kept.push_back(addr);
+        if (st) {
+            if (keep) ScanThreadStats::Add(st->hits, 1);
+            ScanThreadStats::Add(st->compareNs, ScanStats::NowNs() - t1);
+        }
+    }
+    if (pending) prog.Add(pending);
+}
+
+void OrderedCommitter::Reset(size_t items) {
+    std::lock_guard<std::mutex> lk(mu_);
+    hits_.clear();
+    hits_.resize(items);
+    finished_.assign(items, 0);
+    commit_ = 0;
+}
+
+void OrderedCommitter::FlushLocked(const HitSink& sink) {
+    while (commit_ < hits_.size() && finished_[commit_]) {
+        std::vector<uintptr_t>& h = hits_[commit_];
+        if (!h.empty()) sink(h.data(), h.size());
+        std::vector<uintptr_t>().swap(h);
+        ++commit_;
+    }
+}
+
+void OrderedCommitter::Finish(size_t i, const HitSink& sink) {
+    std::lock_guard<std::mutex> lk(mu_);
+    finished_[i] = 1;
+    FlushLocked(sink);
+}
+
+void OrderedCommitter::FinishAll(const HitSink& sink) {
+    std::lock_guard<std::mutex> lk(mu_);
+    for (size_t i = commit_; i < hits_.size(); ++i) finished_[i] = 1;
+    FlushLocked(sink);
+}
+
+}} // namespace
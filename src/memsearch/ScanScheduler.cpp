@@ -0,0 +1,279 @@
+#include <vector>
+#include <string>
+#include <algorithm>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#endif
+
+#include "include/REKit/memsearch/ScanScheduler.h"
+#include "include/REKit/memsearch/ProcessMemory.h"
+
+namespace REKit { namespace MemSearch {
+
+static constexpr uint64_t kStrideBase = 1 << 20;
+
+std::string ScanJob::Status() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return status_;
+}
+
+void ScanJob::Cancel() {
+    cancel_ = true;
+    if (owner_) owner_->Wake();
+}
+
+void ScanJob::Wait() {
+    std::unique_lock<std::mutex> lk(mu_);
+    doneCv_.wait(lk, [&] { return done_.load(); });
+}
+
+ScanScheduler::ScanScheduler() : ScanScheduler(Config()) {}
+
+ScanScheduler::ScanScheduler(const Config& cfg) : cfg_(cfg) {
+    unsigned n = cfg_.workers;
+    if (n == 0) {
+        unsigned hw = std::thread::hardware_concurrency();
+        n = hw > 1 ? hw - 1 : 1;
+    }
+    if (n > ScanStats::kMaxThreads) n = ScanStats::kMaxThreads;    // one stats slot per worker
+    if (cfg_.ioPerTarget == 0 || cfg_.ioPerTarget > n) cfg_.ioPerTarget = n;
+    workers_.reserve(n);
+    for (unsigned i = 0; i < n; ++i) workers_.emplace_back(&ScanScheduler::WorkerLoop, this, i);
+}
+
+ScanScheduler::~ScanScheduler() {
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        stop_ = true;
+        for (auto& j : jobs_) j->cancel_ = true;
+    }
+    cv_.notify_all();
+    for (auto& t : workers_) t.join();
+}
+
+ScanScheduler& ScanScheduler::Shared() {
+    static ScanScheduler s;
+    return s;
+}
+
+size_t ScanScheduler::ActiveJobs() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return jobs_.size();
+}
+
+void ScanScheduler::Wake() {
+    { std::lock_guard<std::mutex> lk(mu_); }
+    cv_.notify_all();
+}
+
+std::shared_ptr<ScanJob> ScanScheduler::SubmitFirstScan(const ScanOptions& opt, int priority) {
+    auto job = std::make_shared<ScanJob>();
+    job->kind_ = ScanJob::Kind::First;
+    job->opt_ = opt;
+    return Submit(job, priority);
+}
+
+std::shared_ptr<ScanJob> ScanScheduler::SubmitNextScan(const ScanOptions& opt, ResultStore&& prev, int priority) {
+    auto job = std::make_shared<ScanJob>();
+    job->kind_ = ScanJob::Kind::Next;
+    job->opt_ = opt;
+    job->prev_ = std::move(prev);
+    return Submit(job, priority);
+}
+
+std::shared_ptr<ScanJob> ScanScheduler::Submit(std::shared_ptr<ScanJob> job, int priority) {
+    priority = (std::max)(1, (std::min)(priority, 100));
+    job->owner_ = this;
+    job->priority_ = priority;
+    job->stride_ = kStrideBase / (uint64_t)priority;
+    job->status_ = "Queued";
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        if (stop_) job->cancel_ = true;
+        job->seq_ = ++seq_;
+        job->pass_ = vtime_;    // joins at the current virtual time, no banked credit
+        jobs_.push_back(job);
+    }
+    cv_.notify_all();
+    return job;
+}
+
+bool ScanScheduler::FinishedLocked(const ScanJob& j) const {
+    if (j.preparing_ || j.inFlight_ > 0) return false;
+    return j.cancel_ || j.failed_ || (j.prepared_ && j.next_ >= j.items_);
+}
+
+// Source the job's next item reads remotely, or null when it does no process
+// reads: preparing, in-target agent scans, local sources and stripes backed
+// entirely by a module file.
+const void* ScanScheduler::TargetLocked(const ScanJob& j) const {
+    if (!j.prepared_ || !j.target_ || j.agent_) return nullptr;
+    if (j.kind_ == ScanJob::Kind::First) {
+        const Stripe& s = j.plan_.Stripes()[j.next_];
+        if (s.local && s.localEnd >= s.base + s.size) return nullptr;
+    }
+    return j.target_;
+}
+
+// Runnable job with the lowest pass whose target still has I/O headroom.
+std::shared_ptr<ScanJob> ScanScheduler::PickLocked() {
+    std::shared_ptr<ScanJob> best;
+    for (auto& j : jobs_) {
+        if (j->finalizing_ || j->cancel_ || j->failed_ || j->preparing_) continue;
+        if (j->prepared_ && j->next_ >= j->items_) continue;
+        auto it = inFlightPerTarget_.find(TargetLocked(*j));
+        if (it != inFlightPerTarget_.end() && it->second >= cfg_.ioPerTarget) continue;
+        if (!best || j->pass_ < best->pass_ || (j->pass_ == best->pass_ && j->seq_ < best->seq_)) best = j;
+    }
+    return best;
+}
+
+void ScanScheduler::WorkerLoop(unsigned wid) {
+    // Scans are background work; keep the UI thread responsive.
+#ifdef _WIN32
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+#else
+    setpriority(PRIO_PROCESS, (id_t)syscall(SYS_gettid), 5);
+#endif
+    std::vector<uint8_t> buf;
+    std::vector<uintptr_t> tmp;
+    std::unique_lock<std::mutex> lk(mu_);
+    for (;;) {
+        auto fin = std::find_if(jobs_.begin(), jobs_.end(),
+            [&](const std::shared_ptr<ScanJob>& j) { return !j->finalizing_ && FinishedLocked(*j); });
+        if (fin != jobs_.end()) {
+            std::shared_ptr<ScanJob> job = *fin;
+            job->finalizing_ = true;
+            jobs_.erase(fin);
+            lk.unlock();
+            Finalize(*job);
+            lk.lock();
+            continue;
+        }
+        if (stop_) break;
+
+        std::shared_ptr<ScanJob> job = PickLocked();
+        if (!job) { cv_.wait(lk); continue; }
+        vtime_ = job->pass_;
+        job->pass_ += job->stride_;
+        const void* target = TargetLocked(*job);
+        if (target) ++inFlightPerTarget_[target];
+        const bool prep = !job->prepared_;
+        size_t item = 0;
+        if (prep) job->preparing_ = true;
+        else { item = job->next_++; ++job->inFlight_; }
+        lk.unlock();
+
+        if (prep) Prepare(*job);
+        else RunItem(*job, item, wid, buf, tmp);
+
+        lk.lock();
+        if (prep) { job->preparing_ = false; job->prepared_ = true; }
+        else --job->inFlight_;
+        if (target) {
+            auto it = inFlightPerTarget_.find(target);
+            if (--it->second == 0) inFlightPerTarget_.erase(it);
+        }
+        cv_.notify_all();
+    }
+}
+
+// Opens the target and splits the job into work items; runs on a worker.
+void ScanScheduler::Prepare(ScanJob& j) {
+    std::string status;
+    bool ok = false;
+    j.stats_.Begin();
+    if (j.kind_ == ScanJob::Kind::First && j.opt_.useAgent && !j.opt_.source && ScanAgentClient::Supports(j.opt_)) {
+        j.agent_.reset(new ScanAgentClient());
+        if (!j.agent_->Connect(j.opt_.pid)) j.agent_.reset();
+    }
+    if (!j.agent_) j.mem_ = OpenScanSource(j.opt_);
+    if (j.agent_) {
+        ok = true;
+        j.items_ = 1;
+        status = "Scanning in target...";
+    }
+    else if (!j.mem_->IsOpen()) status = "OpenProcess failed";
+    else if (j.kind_ == ScanJob::Kind::First) {
+        ok = j.plan_.Prepare(*j.mem_, j.opt_, status, &j.stats_);
+        if (ok) {
+            j.items_ = j.plan_.Stripes().size();
+            j.walk_.total = j.plan_.TotalBytes();
+            status = "Scanning...";
+        }
+    }
+    else {
+        ok = j.filter_.Prepare(j.opt_);
+        if (ok) {
+            j.items_ = j.prev_.BlockCount();
+            j.walk_.total = j.prev_.Size();
+            status = "Filtering...";
+        }
+        else status = "Invalid value";
+    }
+    if (ok) {
+        j.walk_.out = &j.progress_;
+        j.committer_.Reset(j.items_);
+        j.results_.SetMemoryBudget(j.opt_.resultMemoryBudget);
+        ScanJob* jp = &j;
+        j.sink_ = [jp](const uintptr_t* p, size_t n) { jp->results_.Append(p, n); };
+    }
+    std::lock_guard<std::mutex> lk(mu_);
+    j.failed_ = !ok;
+    // only live processes are throttled; ProcessAccess hands every job on a pid the same source
+    if (ok && j.mem_ && dynamic_cast<const ProcessMemory*>(j.mem_.get())) j.target_ = j.mem_.get();
+    std::lock_guard<std::mutex> jl(j.mu_);
+    j.status_ = status;
+}
+
+void ScanScheduler::RunItem(ScanJob& j, size_t item, unsigned wid, std::vector<uint8_t>& buf, std::vector<uintptr_t>& tmp) {
+    std::vector<uintptr_t>& out = j.committer_.Slot(item);
+    if (j.agent_) {
+        // hits go straight to the results; the agent sends them in order
+        std::string status;
+        bool ok = j.agent_->FirstScan(j.opt_, j.sink_, j.cancel_, j.progress_, status, &j.stats_);
+        if (!ok) {
+            std::lock_guard<std::mutex> lk(mu_);
+            j.failed_ = true;
+        }
+        std::lock_guard<std::mutex> lk(j.mu_);
+        j.status_ = status;
+    }
+    else if (j.kind_ == ScanJob::Kind::First) {
+        const FirstScanPlan& plan = j.plan_;
+        WalkStripe(*j.mem_, plan.Stripes()[item], item, plan.Walk(), wid, buf, j.cancel_,
+                   [&](const ChunkView& v) { plan.Match(v, out); }, j.walk_);
+    }
+    else {
+        ScanThreadStats* st = &j.stats_.Thread(wid);
+        if (j.prev_.ReadBlock(item, tmp)) j.filter_.Filter(*j.mem_, tmp.data(), tmp.size(), out, j.cancel_, j.walk_, st);
+        else ScanThreadStats::Add(st->readFailures, 1);
+    }
+    j.committer_.Finish(item, j.sink_);
+}
+
+void ScanScheduler::Finalize(ScanJob& j) {
+    if (j.sink_) j.committer_.FinishAll(j.sink_);
+    j.mem_.reset();
+    j.agent_.reset();
+    j.prev_.Clear();
+    j.stats_.End();
+    std::lock_guard<std::mutex> lk(j.mu_);
+    if (!j.failed_ || j.cancel_) {
+        if (j.cancel_) j.status_ = "Canceled";
+        else {
+            j.status_ = j.kind_ == ScanJob::Kind::First ? "Done" : "Filtered";
+            j.progress_ = 1.f;
+        }
+        if (j.results_.Truncated()) j.status_ += " (results truncated: out of memory and spill failed)";
+        else if (j.results_.SpillFailed()) j.status_ += " (spill failed, results kept in memory)";
+    }
+    j.done_ = true;
+    j.doneCv_.notify_all();
+}
+
+}} // namespace
@@ -0,0 +1,60 @@
+#include "include/REKit/memsearch/ScanStats.h"
+
+namespace REKit { namespace MemSearch {
+
+void ScanStats::Reset() {
+    for (auto& t : threads_) {
+        t.bytesRequested = 0; t.bytesRead = 0;
+        t.readCalls = 0; t.readFailures = 0;
+        t.bytesMapped = 0;
+        t.hits = 0;
+        t.readNs = 0; t.compareNs = 0;
+    }
+    enumerateNs_ = 0;
+    beginNs_ = 0;
+    endNs_ = 0;
+}
+
+void ScanStats::Begin() {
+    Reset();
+    beginNs_ = NowNs();
+}
+
+void ScanStats::End() {
+    endNs_ = NowNs();
+}
+
+ScanStatsSnapshot ScanStats::Snapshot() const {
+    const auto r = std::memory_order_relaxed;
+    ScanStatsSnapshot s;
+    for (unsigned i = 0; i < kMaxThreads; ++i) {
+        const ScanThreadStats& t = threads_[i];
+        ScanThreadTotals x;
+        x.thread = i;
+        x.bytesRequested = t.bytesRequested.load(r);
+        x.bytesRead      = t.bytesRead.load(r);
+        x.readCalls      = t.readCalls.load(r);
+        x.readFailures   = t.readFailures.load(r);
+        x.bytesMapped    = t.bytesMapped.load(r);
+        x.hits           = t.hits.load(r);
+        x.readNs         = t.readNs.load(r);
+        x.compareNs      = t.compareNs.load(r);
+        if (!x.readCalls && !x.bytesMapped && !x.hits && !x.compareNs) continue;
+        s.total.bytesRequested += x.bytesRequested;
+        s.total.bytesRead      += x.bytesRead;
+        s.total.readCalls      += x.readCalls;
+        s.total.readFailures   += x.readFailures;
+        s.total.bytesMapped    += x.bytesMapped;
+        s.total.hits           += x.hits;
+        s.total.readNs         += x.readNs;
+        s.total.compareNs      += x.compareNs;
+        s.perThread.push_back(x);
+    }
+    s.enumerateNs = enumerateNs_.load(r);
+    uint64_t b = beginNs_.load(r), e = endNs_.load(r);
+    s.running = (b != 0 && e == 0);
+    if (b) s.wallNs = (e ? e : NowNs()) - b;
+    return s;
+}
+
+}} // namespace
@@ -0,0 +1,375 @@
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <cctype>
+#include <cinttypes>
+#ifdef _WIN32
+#include <windows.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#else
+#include <sys/stat.h>
+#endif
+
+#include "include/REKit/memsearch/SigDatabase.h"
+#include "include/REKit/memsearch/RegionWalker.h"
+#include "include/REKit/memsearch/ModuleImage.h"
+#include "include/REKit/memsearch/ScanStats.h"
+
+namespace REKit { namespace MemSearch {
+
+namespace {
+
+uint64_t Fnv1a(const std::string& s, uint64_t h = 1469598103934665603ull) {
+    for (unsigned char c : s) { h ^= c; h *= 1099511628211ull; }
+    return h;
+}
+
+std::string Trim(const std::string& s) {
+    size_t b = 0, e = s.size();
+    while (b < e && isspace((unsigned char)s[b])) ++b;
+    while (e > b && isspace((unsigned char)s[e - 1])) --e;
+    return s.substr(b, e - b);
+}
+
+std::string Lower(std::string s) {
+    for (char& c : s) c = (char)tolower((unsigned char)c);
+    return s;
+}
+
+FILE* OpenUtf8(const std::string& path, const char* mode) {
+#ifdef _WIN32
+    int n = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0);
+    if (n <= 0) return nullptr;
+    std::wstring w(n - 1, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, &w[0], n);
+    std::wstring m(mode, mode + strlen(mode));
+    return _wfopen(w.c_str(), m.c_str());
+#else
+    return fopen(path.c_str(), mode);
+#endif
+}
+
+bool StatUtf8(const std::string& path, uint64_t& size, uint64_t& mtime) {
+#ifdef _WIN32
+    int n = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0);
+    if (n <= 0) return false;
+    std::wstring w(n - 1, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, &w[0], n);
+    WIN32_FILE_ATTRIBUTE_DATA fa;
+    if (!GetFileAttributesExW(w.c_str(), GetFileExInfoStandard, &fa)) return false;
+    size = ((uint64_t)fa.nFileSizeHigh << 32) | fa.nFileSizeLow;
+    mtime = ((uint64_t)fa.ftLastWriteTime.dwHighDateTime << 32) | fa.ftLastWriteTime.dwLowDateTime;
+    return true;
+#else
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) return false;
+    size = (uint64_t)st.st_size;
+    mtime = (uint64_t)st.st_mtim.tv_sec * 1000000000ull + (uint64_t)st.st_mtim.tv_nsec;
+    return true;
+#endif
+}
+
+// Fast non-cryptographic hash over 8-byte words; only needs to tell builds apart.
+struct ContentHash {
+    uint64_t h = 0x243F6A8885A308D3ull, len = 0;
+    void Add(const uint8_t* p, size_t n) {
+        len += n;
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            uint64_t w; memcpy(&w, p + i, 8);
+            h = (h ^ w) * 0x9E3779B97F4A7C15ull;
+            h ^= h >> 29;
+        }
+        uint64_t t = 0;
+        for (size_t k = 0; i + k < n; ++k) t |= (uint64_t)p[i + k] << (8 * k);
+        h = (h ^ t ^ (n - i)) * 0xC2B2AE3D27D4EB4Full;
+    }
+    uint64_t Final() const { uint64_t x = h ^ len; x ^= x >> 33; x *= 0xFF51AFD7ED558CCDull; return x ^ (x >> 33); }
+};
+
+} // namespace
+
+int SigDatabase::Find(const std::string& name) const {
+    for (size_t i = 0; i < entries_.size(); ++i) if (entries_[i].name == name) return (int)i;
+    return -1;
+}
+
+bool SigDatabase::Add(const std::string& name, const std::string& module, const std::string& pattern, std::string* error) {
+    SigEntry e;
+    e.name = name;
+    e.module = module.empty() ? "*" : module;
+    e.pattern = pattern;
+    if (!e.prog.Compile(pattern, error)) return false;
+    e.id = Fnv1a(pattern, Fnv1a(Lower(e.module) + '\0'));
+    entries_.push_back(std::move(e));
+    return true;
+}
+
+bool SigDatabase::Parse(const std::string& text, std::string* error) {
+    std::string module = "*";
+    size_t pos = 0, lineNo = 0;
+    while (pos <= text.size()) {
+        size_t nl = text.find('\n', pos);
+        std::string line = Trim(text.substr(pos, nl == std::string::npos ? std::string::npos : nl - pos));
+        pos = nl == std::string::npos ? text.size() + 1 : nl + 1;
+        ++lineNo;
+        if (line.empty() || line[0] == '#' || line[0] == ';') continue;
+        auto fail = [&](const std::string& why) {
+            if (error) *error = "line " + std::to_string(lineNo) + ": " + why;
+            return false;
+        };
+        if (line[0] == '[') {
+            if (line.back() != ']') return fail("Unclosed module section");
+            module = Trim(line.substr(1, line.size() - 2));
+            if (module.empty()) return fail("Empty module name");
+            continue;
+        }
+        size_t eq = line.find('=');
+        if (eq == std::string::npos) return fail("Expected name = pattern");
+        std::string name = Trim(line.substr(0, eq));
+        if (name.empty()) return fail("Missing signature name");
+        if (Find(name) >= 0) return fail("Duplicate signature " + name);
+        std::string why;
+        if (!Add(name, module, Trim(line.substr(eq + 1)), &why)) return fail(name + ": " + why);
+    }
+    if (error) error->clear();
+    return true;
+}
+
+bool SigDatabase::Load(const std::string& path, std::string* error) {
+    FILE* f = OpenUtf8(path, "rb");
+    if (!f) { if (error) *error = "Cannot open " + path; return false; }
+    std::string text;
+    char buf[16384];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) text.append(buf, n);
+    fclose(f);
+    entries_.clear();
+    return Parse(text, error);
+}
+
+bool SigCache::Lookup(uint64_t moduleHash, uint64_t sigId, SigHits& rel) const {
+    auto it = hits_.find({ moduleHash, sigId });
+    if (it == hits_.end()) return false;
+    rel = it->second;
+    return true;
+}
+
+void SigCache::Store(uint64_t moduleHash, uint64_t sigId, const SigHits& rel) {
+    hits_[{ moduleHash, sigId }] = rel;
+    dirty_ = true;
+}
+
+bool SigCache::FileHash(const std::string& path, uint64_t& hash) {
+    uint64_t size = 0, mtime = 0;
+    if (!StatUtf8(path, size, mtime)) return false;
+    auto it = files_.find(path);
+    if (it != files_.end() && it->second.size == size && it->second.mtime == mtime) { hash = it->second.hash; return true; }
+    FILE* f = OpenUtf8(path, "rb");
+    if (!f) return false;
+    ContentHash ch;
+    std::vector<uint8_t> buf(1 << 20);
+    size_t n;
+    while ((n = fread(buf.data(), 1, buf.size(), f)) > 0) ch.Add(buf.data(), n);
+    bool ok = !ferror(f);
+    fclose(f);
+    if (!ok) return false;
+    hash = ch.Final();
+    files_[path] = { size, mtime, hash };
+    dirty_ = true;
+    return true;
+}
+
+// Text format, one record per line:
+//   REKitSigCache 1
+//   F <size> <mtime> <hash> <path>
+//   H <moduleHash> <sigId> <captureCount> <hits>
+//   <offset> <length> [<captureOffset> <captureValue>]...     one line per hit
+bool SigCache::Load(const std::string& path) {
+    Clear();
+    FILE* f = OpenUtf8(path, "rb");
+    if (!f) return false;
+    std::vector<char> line(1 << 16);
+    bool ok = fgets(line.data(), (int)line.size(), f) && strncmp(line.data(), "REKitSigCache 1", 15) == 0;
+    while (ok && fgets(line.data(), (int)line.size(), f)) {
+        const char* p = line.data();
+        int used = 0;
+        if (p[0] == 'F') {
+            FileMemo m;
+            if (sscanf(p, "F %" SCNu64 " %" SCNu64 " %" SCNx64 " %n", &m.size, &m.mtime, &m.hash, &used) < 3) { ok = false; break; }
+            std::string file = p + used;
+            while (!file.empty() && (file.back() == '\n' || file.back() == '\r')) file.pop_back();
+            files_[file] = m;
+        }
+        else if (p[0] == 'H') {
+            uint64_t mh = 0, id = 0;
+            size_t caps = 0, count = 0;
+            if (sscanf(p, "H %" SCNx64 " %" SCNx64 " %zu %zu", &mh, &id, &caps, &count) != 4 || caps > 255) { ok = false; break; }
+            SigHits h;
+            h.captureCount = caps;
+            for (size_t i = 0; ok && i < count; ++i) {
+                if (!fgets(line.data(), (int)line.size(), f)) { ok = false; break; }
+                p = line.data();
+                unsigned long long off = 0;
+                unsigned len = 0;
+                if (sscanf(p, "%llx %u%n", &off, &len, &used) != 2) { ok = false; break; }
+                h.addrs.push_back((uintptr_t)off);
+                h.lengths.push_back(len);
+                for (size_t c = 0; c < caps; ++c) {
+                    p += used;
+                    SigCaptureValue v{};
+                    if (sscanf(p, "%u %" SCNx64 "%n", &v.offset, &v.value, &used) != 2) { ok = false; break; }
+                    h.captures.push_back(v);
+                }
+            }
+            if (ok) hits_[{ mh, id }] = std::move(h);
+        }
+    }
+    fclose(f);
+    if (!ok) Clear();
+    return ok;
+}
+
+bool SigCache::Save(const std::string& path) const {
+    FILE* f = OpenUtf8(path, "wb");
+    if (!f) return false;
+    fprintf(f, "REKitSigCache 1\n");
+    for (auto& kv : files_)
+        fprintf(f, "F %" PRIu64 " %" PRIu64 " %" PRIx64 " %s\n", kv.second.size, kv.second.mtime, kv.second.hash, kv.first.c_str());
+    for (auto& kv : hits_) {
+        const SigHits& h = kv.second;
+        fprintf(f, "H %" PRIx64 " %" PRIx64 " %zu %zu\n", kv.first.first, kv.first.second, h.captureCount, h.Size());
+        for (size_t i = 0; i < h.Size(); ++i) {
+            fprintf(f, "%llx %u", (unsigned long long)h.addrs[i], h.lengths[i]);
+            const SigCaptureValue* c = h.Captures(i);
+            for (size_t k = 0; k < h.captureCount; ++k) fprintf(f, " %u %" PRIx64, c[k].offset, c[k].value);
+            fputc('\n', f);
+        }
+    }
+    bool ok = !ferror(f);
+    return fclose(f) == 0 && ok;
+}
+
+namespace {
+
+struct SetHit { uint32_t index; uint32_t length; uintptr_t addr; size_t caps; };
+
+// One SigProgramSet pass over [base, base + size); hits are appended per entry in address order.
+void ScanModule(const IMemorySource& mem, const std::vector<Region>& regs, const std::vector<const SigEntry*>& entries,
+                std::vector<SigHits>& hits, unsigned threads, SigResolveStats* stats) {
+    SigProgramSet set;
+    for (auto* e : entries) set.Add(&e->prog);
+    set.Build();
+    WalkOptions wo;
+    wo.overlap = set.MaxLength() ? set.MaxLength() - 1 : 0;
+    wo.threads = threads;
+    std::vector<Stripe> stripes = PlanStripes(regs, wo.stripeSize);
+    std::vector<std::vector<SetHit>> found(stripes.size());
+    std::vector<std::vector<SigCaptureValue>> caps(stripes.size());
+    std::atomic<bool> cancel{false};
+    std::atomic<float> progress{0.f};
+    WalkStripes(mem, stripes, wo, cancel, progress, [&](const ChunkView& v) {
+        auto& out = found[v.stripe];
+        auto& cv = caps[v.stripe];
+        set.Search(v.data, v.size, v.ownedSize, v.addr, [&](size_t i, uintptr_t addr, uint32_t len, const SigCaptureValue* c) {
+            out.push_back({ (uint32_t)i, len, addr, cv.size() });
+            cv.insert(cv.end(), c, c + entries[i]->prog.CaptureCount());
+        });
+    });
+    hits.assign(entries.size(), SigHits());
+    for (size_t i = 0; i < entries.size(); ++i) hits[i].captureCount = entries[i]->prog.CaptureCount();
+    for (size_t s = 0; s < stripes.size(); ++s) {
+        // a chunk reports its multi-literal hits before its single-byte ones; order per entry
+        std::stable_sort(found[s].begin(), found[s].end(), [](const SetHit& a, const SetHit& b) { return a.addr < b.addr; });
+        for (auto& h : found[s]) {
+            SigHits& dst = hits[h.index];
+            dst.addrs.push_back(h.addr);
+            dst.lengths.push_back(h.length);
+            dst.captures.insert(dst.captures.end(), caps[s].begin() + h.caps, caps[s].begin() + h.caps + dst.captureCount);
+        }
+    }
+    if (stats) {
+        ++stats->modulesScanned;
+        for (auto& s : stripes) stats->bytesScanned += s.size;
+    }
+}
+
+} // namespace
+
+void ResolveSignatures(const IMemorySource& mem, const SigDatabase& db, SigCache* cache,
+                       std::vector<SigResolved>& out, SigResolveStats* stats, unsigned threads) {
+    out.assign(db.Size(), SigResolved());
+    for (size_t i = 0; i < db.Size(); ++i) out[i].entry = &db.At(i);
+    std::vector<ModuleInfo> mods;
+    mem.EnumModules(mods);
+    if (mods.empty()) return;
+
+    // entries grouped by the module they resolve to
+    std::map<size_t, std::vector<size_t>> byModule;
+    for (size_t i = 0; i < db.Size(); ++i) {
+        const std::string& scope = db.At(i).module;
+        if (scope == "*") { byModule[0].push_back(i); continue; }
+        std::string want = Lower(scope);
+        for (size_t m = 0; m < mods.size(); ++m)
+            if (Lower(mods[m].name) == want) { byModule[m].push_back(i); break; }
+    }
+
+    for (auto& kv : byModule) {
+        const ModuleInfo& mod = mods[kv.first];
+        if (stats) ++stats->modules;
+        // Only the base independent file-backed sections are cached: their
+        // bytes, and so the hits and captures in them, are the same in every
+        // process the file is loaded in. Without the file the live image is
+        // scanned and nothing is cached.
+        ModuleImage img;
+        bool mapped = img.Open(mem, mod, true);
+        uint64_t modHash = 0;
+        bool cacheable = false;
+        if (cache && mapped) {
+            uint64_t t0 = ScanStats::NowNs();
+            cacheable = cache->FileHash(mod.path, modHash);
+            if (stats) stats->hashNs += ScanStats::NowNs() - t0;
+        }
+
+        std::vector<size_t> misses;
+        for (size_t i : kv.second) {
+            SigResolved& r = out[i];
+            r.moduleFound = true;
+            r.moduleBase = mod.base;
+            if (cacheable && cache->Lookup(modHash, r.entry->id, r.hits)) {
+                r.fromCache = true;
+                for (auto& a : r.hits.addrs) a += mod.base;
+                if (stats) ++stats->cacheHits;
+            }
+            else {
+                misses.push_back(i);
+                if (stats) ++stats->cacheMisses;
+            }
+        }
+        if (misses.empty()) continue;
+
+        std::vector<const SigEntry*> entries;
+        for (size_t i : misses) entries.push_back(out[i].entry);
+        std::vector<Region> regs;
+        if (mapped) regs = img.Spans();
+        else mem.EnumReadableRegions(regs, mod.base, mod.base + mod.size);
+        std::vector<SigHits> hits;
+        uint64_t t0 = ScanStats::NowNs();
+        ScanModule(mem, regs, entries, hits, threads, stats);
+        if (stats) stats->scanNs += ScanStats::NowNs() - t0;
+        for (size_t k = 0; k < misses.size(); ++k) {
+            SigResolved& r = out[misses[k]];
+            r.hits = std::move(hits[k]);
+            if (!cacheable) continue;
+            SigHits rel = r.hits;
+            for (auto& a : rel.addrs) a -= mod.base;
+            cache->Store(modHash, r.entry->id, rel);
+        }
+    }
+}
+
+}} // namespace
@@ -0,0 +1,452 @@
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cstring>
+#include <cctype>
+#include <cstdlib>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define REKIT_SIG_SSE2 1
+#include <emmintrin.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#include "include/REKit/memsearch/SigProgram.h"
+#include "include/REKit/memsearch/RegionWalker.h"
+
+namespace REKit { namespace MemSearch {
+
+void SigHits::Append(const SigHits& o) {
+    addrs.insert(addrs.end(), o.addrs.begin(), o.addrs.end());
+    lengths.insert(lengths.end(), o.lengths.begin(), o.lengths.end());
+    captures.insert(captures.end(), o.captures.begin(), o.captures.end());
+}
+
+namespace {
+
+struct Element {
+    enum Kind { Byte, Set, Gap, Cap } kind;
+    uint8_t  v = 0, m = 0;      // Byte
+    size_t   set = 0;           // Set: index into the bitmap table
+    size_t   lo = 0, hi = 0;    // Gap: min/max; Cap: slot/size
+};
+
+int HexNibble(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return 10 + (c - 'a');
+    if (c >= 'A' && c <= 'F') return 10 + (c - 'A');
+    if (c == '?') return -1;
+    return -2;
+}
+
+bool ParseByte(const std::string& s, uint8_t& v, uint8_t& m) {
+    if (s == "?") { v = 0; m = 0; return true; }
+    if (s.size() != 2) return false;
+    int hi = HexNibble(s[0]), lo = HexNibble(s[1]);
+    if (hi == -2 || lo == -2) return false;
+    v = 0; m = 0xFF;
+    if (hi >= 0) v = (uint8_t)(hi << 4); else m &= 0x0F;
+    if (lo >= 0) v |= (uint8_t)lo;       else m &= 0xF0;
+    return true;
+}
+
+bool ParseSize(const std::string& s, size_t& out) {
+    if (s.empty() || s.size() > 6) return false;
+    for (char c : s) if (!isdigit((unsigned char)c)) return false;
+    out = (size_t)strtoul(s.c_str(), nullptr, 10);
+    return true;
+}
+
+void Put16(std::vector<uint8_t>& c, size_t v) { c.push_back((uint8_t)v); c.push_back((uint8_t)(v >> 8)); }
+size_t Get16(const uint8_t* p) { return (size_t)p[0] | ((size_t)p[1] << 8); }
+
+inline unsigned Ctz(unsigned v) {
+#ifdef _MSC_VER
+    unsigned long i; _BitScanForward(&i, v); return (unsigned)i;
+#else
+    return (unsigned)__builtin_ctz(v);
+#endif
+}
+
+} // namespace
+
+bool SigProgram::IsExtended(const std::string& src) {
+    return src.find_first_of("[({$") != std::string::npos;
+}
+
+int SigProgram::CaptureIndex(const std::string& name) const {
+    for (size_t i = 0; i < capNames_.size(); ++i) if (capNames_[i] == name) return (int)i;
+    return -1;
+}
+
+bool SigProgram::Compile(const std::string& src, std::string* error) {
+    code_.clear(); sets_.clear(); capNames_.clear(); lit_.clear();
+    minLen_ = maxLen_ = litOff_ = 0;
+    auto fail = [&](const std::string& why) { if (error) *error = why; code_.clear(); return false; };
+
+    // tokens -> elements
+    std::vector<Element> els;
+    size_t i = 0;
+    auto closing = [&](char close, std::string& body) {
+        size_t e = src.find(close, i + 1);
+        if (e == std::string::npos) return false;
+        body = src.substr(i + 1, e - i - 1);
+        body.erase(std::remove_if(body.begin(), body.end(), [](char c) { return isspace((unsigned char)c); }), body.end());
+        i = e + 1;
+        return true;
+    };
+    auto addSet = [&]() { sets_.resize(sets_.size() + 32, 0); return sets_.size() / 32 - 1; };
+    auto setBit = [&](size_t set, unsigned b) { sets_[set * 32 + b / 8] |= (uint8_t)(1u << (b % 8)); };
+
+    while (i < src.size()) {
+        char c = src[i];
+        if (isspace((unsigned char)c)) { ++i; continue; }
+        std::string body;
+        if (c == '[') {
+            if (!closing(']', body)) return fail("Unclosed '['");
+            size_t dash = body.find('-');
+            Element e{ Element::Gap };
+            bool ok = dash == std::string::npos ? ParseSize(body, e.lo) && (e.hi = e.lo, true)
+                                                : ParseSize(body.substr(0, dash), e.lo) && ParseSize(body.substr(dash + 1), e.hi);
+            if (!ok || e.lo > e.hi || e.hi > kMaxGap) return fail("Bad gap [" + body + "]");
+            els.push_back(e);
+        }
+        else if (c == '(') {
+            if (!closing(')', body)) return fail("Unclosed '('");
+            Element e{ Element::Set };
+            e.set = addSet();
+            size_t s = 0;
+            for (;;) {
+                size_t bar = body.find('|', s);
+                std::string alt = body.substr(s, bar == std::string::npos ? std::string::npos : bar - s);
+                uint8_t v, m;
+                if (!ParseByte(alt, v, m)) return fail("Bad alternative '" + alt + "'");
+                for (unsigned b = 0; b < 256; ++b) if ((b & m) == v) setBit(e.set, b);
+                if (bar == std::string::npos) break;
+                s = bar + 1;
+            }
+            els.push_back(e);
+        }
+        else if (c == '{') {
+            if (!closing('}', body)) return fail("Unclosed '{'");
+            size_t dash = body.find('-');
+            uint8_t lo, hi, ml, mh;
+            if (dash == std::string::npos || !ParseByte(body.substr(0, dash), lo, ml) || !ParseByte(body.substr(dash + 1), hi, mh)
+                || ml != 0xFF || mh != 0xFF || lo > hi)
+                return fail("Bad range {" + body + "}");
+            Element e{ Element::Set };
+            e.set = addSet();
+            for (unsigned b = lo; b <= hi; ++b) setBit(e.set, b);
+            els.push_back(e);
+        }
+        else if (c == '$') {
+            size_t s = ++i;
+            while (i < src.size() && (isalnum((unsigned char)src[i]) || src[i] == '_')) ++i;
+            std::string name = src.substr(s, i - s);
+            if (name.empty() || isdigit((unsigned char)name[0])) return fail("Bad capture name");
+            if (std::find(capNames_.begin(), capNames_.end(), name) != capNames_.end()) return fail("Duplicate capture $" + name);
+            Element e{ Element::Cap };
+            e.lo = capNames_.size();
+            e.hi = 0;
+            if (i < src.size() && src[i] == ':') {
+                size_t d = ++i;
+                while (i < src.size() && isdigit((unsigned char)src[i])) ++i;
+                if (!ParseSize(src.substr(d, i - d), e.hi) || e.hi < 1 || e.hi > 8) return fail("Capture size must be 1..8");
+            }
+            capNames_.push_back(name);
+            els.push_back(e);
+        }
+        else {
+            size_t s = i;
+            while (i < src.size() && HexNibble(src[i]) != -2) ++i;
+            std::string run = src.substr(s, i - s);
+            if (run.empty()) return fail(std::string("Unexpected '") + c + "'");
+            if (run == "?") { els.push_back({ Element::Byte }); continue; }
+            if (run.size() % 2) return fail("Odd number of nibbles in '" + run + "'");
+            for (size_t k = 0; k < run.size(); k += 2) {
+                Element e{ Element::Byte };
+                ParseByte(run.substr(k, 2), e.v, e.m);
+                els.push_back(e);
+            }
+        }
+    }
+    if (els.empty()) return fail("Empty signature");
+    if (els.front().kind == Element::Gap || els.back().kind == Element::Gap) return fail("Signature cannot start or end with a gap");
+    bool anyFixed = false;
+    for (auto& e : els) anyFixed |= (e.kind == Element::Byte && e.m != 0) || e.kind == Element::Set;
+    if (!anyFixed) return fail("Signature has no fixed bytes");
+
+    // elements -> bytecode; runs of the same byte kind share one op
+    bool fixedOffset = true;
+    for (size_t k = 0; k < els.size(); ) {
+        const Element& e = els[k];
+        if (e.kind == Element::Byte) {
+            const int kind = e.m == 0xFF ? OpLit : e.m == 0 ? OpSkip : OpMask;
+            size_t end = k;
+            while (end < els.size() && els[end].kind == Element::Byte && end - k < 0xFFFF) {
+                const Element& x = els[end];
+                int xk = x.m == 0xFF ? OpLit : x.m == 0 ? OpSkip : OpMask;
+                if (xk != kind) break;
+                ++end;
+            }
+            const size_t cnt = end - k;
+            code_.push_back((uint8_t)kind);
+            Put16(code_, cnt);
+            if (kind == OpLit) {
+                if (fixedOffset && cnt > lit_.size()) {
+                    lit_.clear();
+                    for (size_t j = k; j < end; ++j) lit_.push_back(els[j].v);
+                    litOff_ = minLen_;
+                }
+                for (size_t j = k; j < end; ++j) code_.push_back(els[j].v);
+            }
+            else if (kind == OpMask) {
+                for (size_t j = k; j < end; ++j) { code_.push_back(els[j].v); code_.push_back(els[j].m); }
+            }
+            minLen_ += cnt; maxLen_ += cnt;
+            k = end;
+            continue;
+        }
+        if (e.kind == Element::Set) {
+            code_.push_back(OpSet); Put16(code_, e.set);
+            minLen_ += 1; maxLen_ += 1;
+        }
+        else if (e.kind == Element::Gap) {
+            code_.push_back(OpGap); Put16(code_, e.lo); Put16(code_, e.hi);
+            minLen_ += e.lo; maxLen_ += e.hi;
+            if (e.lo != e.hi) fixedOffset = false;
+        }
+        else {
+            code_.push_back(OpCap); code_.push_back((uint8_t)e.lo); code_.push_back((uint8_t)e.hi);
+            minLen_ += e.hi; maxLen_ += e.hi;
+        }
+        ++k;
+    }
+    code_.push_back(OpEnd);
+    if (maxLen_ > kMaxLength) return fail("Signature can span more than 4096 bytes");
+    if (error) error->clear();
+    return true;
+}
+
+// Backtracking only happens at variable gaps; each one tries the shortest gap first.
+bool SigProgram::Exec(size_t pc, const uint8_t* p, size_t pos, size_t n, uint32_t& len, SigCaptureValue* caps) const {
+    const uint8_t* c = code_.data();
+    for (;;) {
+        switch (c[pc]) {
+        case OpEnd:
+            len = (uint32_t)pos;
+            return true;
+        case OpLit: {
+            size_t k = Get16(c + pc + 1);
+            if (pos + k > n || memcmp(p + pos, c + pc + 3, k) != 0) return false;
+            pos += k; pc += 3 + k;
+            break;
+        }
+        case OpMask: {
+            size_t k = Get16(c + pc + 1);
+            if (pos + k > n) return false;
+            const uint8_t* vm = c + pc + 3;
+            for (size_t j = 0; j < k; ++j) if ((p[pos + j] & vm[2 * j + 1]) != vm[2 * j]) return false;
+            pos += k; pc += 3 + 2 * k;
+            break;
+        }
+        case OpSkip: {
+            size_t k = Get16(c + pc + 1);
+            if (pos + k > n) return false;
+            pos += k; pc += 3;
+            break;
+        }
+        case OpSet: {
+            if (pos >= n) return false;
+            const uint8_t* bits = sets_.data() + Get16(c + pc + 1) * 32;
+            uint8_t b = p[pos];
+            if (!(bits[b >> 3] & (1u << (b & 7)))) return false;
+            pos += 1; pc += 3;
+            break;
+        }
+        case OpGap: {
+            size_t lo = Get16(c + pc + 1), hi = Get16(c + pc + 3);
+            for (size_t g = lo; g <= hi && pos + g <= n; ++g)
+                if (Exec(pc + 5, p, pos + g, n, len, caps)) return true;
+            return false;
+        }
+        case OpCap: {
+            size_t slot = c[pc + 1], size = c[pc + 2];
+            if (pos + size > n) return false;
+            uint64_t v = 0;
+            for (size_t j = size; j-- > 0; ) v = (v << 8) | p[pos + j];
+            if (caps) caps[slot] = { (uint32_t)pos, v };
+            pos += size; pc += 3;
+            break;
+        }
+        default:
+            return false;
+        }
+    }
+}
+
+bool SigProgram::MatchAt(const uint8_t* p, size_t n, uint32_t* length, SigCaptureValue* caps) const {
+    if (code_.empty() || n < minLen_) return false;
+    uint32_t len = 0;
+    std::vector<SigCaptureValue> scratch;
+    if (!caps && !capNames_.empty()) { scratch.resize(capNames_.size()); caps = scratch.data(); }
+    if (!Exec(0, p, 0, n, len, caps)) return false;
+    if (length) *length = len;
+    return true;
+}
+
+// Calls fn(start) in ascending order for every start in [0, owned) the prefilter lets through.
+template <class Fn>
+void SigProgram::Candidates(const uint8_t* buf, size_t n, size_t owned, Fn&& fn) const {
+    if (n < minLen_) return;
+    const size_t lastStart = (std::min)(owned, n - minLen_ + 1);     // exclusive
+    const size_t m = lit_.size();
+    if (m == 0) {
+        for (size_t s = 0; s < lastStart; ++s) fn(s);
+        return;
+    }
+    // literal positions q = s + litOff_
+    const size_t qEnd = lastStart + litOff_;
+    if (m == 1) {
+        const uint8_t* p = buf + litOff_;
+        const uint8_t* end = buf + qEnd;
+        while (p < end) {
+            const uint8_t* q = (const uint8_t*)memchr(p, lit_[0], (size_t)(end - p));
+            if (!q) break;
+            fn((size_t)(q - buf) - litOff_);
+            p = q + 1;
+        }
+        return;
+    }
+    size_t q = litOff_;
+#ifdef REKIT_SIG_SSE2
+    // first/last byte filter, 16 positions per step
+    const __m128i first = _mm_set1_epi8((char)lit_[0]);
+    const __m128i last  = _mm_set1_epi8((char)lit_[m - 1]);
+    for (; q + 16 <= qEnd && q + m - 1 + 16 <= n; q += 16) {
+        __m128i a = _mm_loadu_si128((const __m128i*)(buf + q));
+        __m128i b = _mm_loadu_si128((const __m128i*)(buf + q + m - 1));
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, last)));
+        while (mask) {
+            size_t at = q + Ctz(mask);
+            if (memcmp(buf + at + 1, lit_.data() + 1, m - 2) == 0) fn(at - litOff_);
+            mask &= mask - 1;
+        }
+    }
+#endif
+    for (; q < qEnd; ++q) {
+        if (q + m > n) break;
+        if (buf[q] == lit_[0] && buf[q + m - 1] == lit_[m - 1] && memcmp(buf + q + 1, lit_.data() + 1, m - 2) == 0)
+            fn(q - litOff_);
+    }
+}
+
+void SigProgram::Search(const uint8_t* buf, size_t n, size_t owned, uintptr_t baseAddr, SigHits& out, size_t alignment) const {
+    if (code_.empty()) return;
+    out.captureCount = capNames_.size();
+    std::vector<SigCaptureValue> caps(capNames_.size());
+    Candidates(buf, n, owned, [&](size_t s) {
+        if (alignment > 1 && (baseAddr + s) % alignment) return;
+        uint32_t len = 0;
+        if (!Exec(0, buf + s, 0, n - s, len, caps.data())) return;
+        out.addrs.push_back(baseAddr + s);
+        out.lengths.push_back(len);
+        out.captures.insert(out.captures.end(), caps.begin(), caps.end());
+    });
+}
+
+void SigProgram::Search(const uint8_t* buf, size_t n, size_t owned, uintptr_t baseAddr, std::vector<uintptr_t>& out, size_t alignment) const {
+    if (code_.empty()) return;
+    std::vector<SigCaptureValue> caps(capNames_.size());
+    Candidates(buf, n, owned, [&](size_t s) {
+        if (alignment > 1 && (baseAddr + s) % alignment) return;
+        uint32_t len = 0;
+        if (Exec(0, buf + s, 0, n - s, len, caps.data())) out.push_back(baseAddr + s);
+    });
+}
+
+void SigProgramSet::Clear() {
+    progs_.clear(); bits_.clear(); start_.clear(); bucket_.clear(); alone_.clear();
+    maxLen_ = maxLitOff_ = maxCaps_ = 0;
+}
+
+size_t SigProgramSet::Add(const SigProgram* prog) {
+    progs_.push_back(prog);
+    return progs_.size() - 1;
+}
+
+void SigProgramSet::Build() {
+    bits_.assign(65536 / 64, 0);
+    start_.assign(65537, 0);
+    bucket_.clear(); alone_.clear();
+    maxLen_ = maxLitOff_ = maxCaps_ = 0;
+    auto key = [](const SigProgram* p) { return (uint32_t)p->Literal()[0] | ((uint32_t)p->Literal()[1] << 8); };
+    for (size_t i = 0; i < progs_.size(); ++i) {
+        const SigProgram* p = progs_[i];
+        maxLen_ = (std::max)(maxLen_, p->MaxLength());
+        maxCaps_ = (std::max)(maxCaps_, p->CaptureCount());
+        if (p->Literal().size() < 2) { alone_.push_back((uint32_t)i); continue; }
+        maxLitOff_ = (std::max)(maxLitOff_, p->LiteralOffset());
+        ++start_[key(p) + 1];
+    }
+    for (size_t k = 0; k < 65536; ++k) start_[k + 1] += start_[k];
+    bucket_.resize(start_[65536]);
+    std::vector<uint32_t> fill(start_.begin(), start_.end() - 1);
+    for (size_t i = 0; i < progs_.size(); ++i) {
+        const SigProgram* p = progs_[i];
+        if (p->Literal().size() < 2) continue;
+        uint32_t k = key(p);
+        bucket_[fill[k]++] = (uint32_t)i;
+        bits_[k >> 6] |= 1ull << (k & 63);
+    }
+}
+
+void SigProgramSet::Search(const uint8_t* buf, size_t n, size_t owned, uintptr_t baseAddr, const HitFn& fn) const {
+    std::vector<SigCaptureValue> caps(maxCaps_ ? maxCaps_ : 1);
+    if (!bucket_.empty() && n >= 2) {
+        // literal positions of starts in [0, owned)
+        const size_t qEnd = (std::min)(n - 1, owned + maxLitOff_);
+        const uint64_t* bits = bits_.data();
+        for (size_t q = 0; q < qEnd; ++q) {
+            uint32_t k = (uint32_t)buf[q] | ((uint32_t)buf[q + 1] << 8);
+            if (!(bits[k >> 6] & (1ull << (k & 63)))) continue;
+            for (uint32_t b = start_[k]; b < start_[k + 1]; ++b) {
+                const SigProgram* p = progs_[bucket_[b]];
+                const std::vector<uint8_t>& lit = p->Literal();
+                const size_t off = p->LiteralOffset();
+                if (q < off || q - off >= owned || q + lit.size() > n) continue;
+                if (memcmp(buf + q + 2, lit.data() + 2, lit.size() - 2) != 0) continue;
+                const size_t s = q - off;
+                uint32_t len = 0;
+                if (p->MatchAt(buf + s, n - s, &len, caps.data())) fn(bucket_[b], baseAddr + s, len, caps.data());
+            }
+        }
+    }
+    for (uint32_t i : alone_) {
+        SigHits h;
+        progs_[i]->Search(buf, n, owned, baseAddr, h);
+        for (size_t k = 0; k < h.Size(); ++k) fn(i, h.addrs[k], h.lengths[k], h.Captures(k));
+    }
+}
+
+void ScanSigProgram(const IMemorySource& mem, const SigProgram& prog, uintptr_t base, size_t length,
+                    SigHits& out, size_t alignment, unsigned threads) {
+    out.Clear();
+    out.captureCount = prog.CaptureCount();
+    std::vector<Region> regs;
+    mem.EnumReadableRegions(regs, length ? base : 0, length ? base + length : 0);
+    WalkOptions wo;
+    wo.overlap = prog.MaxLength() ? prog.MaxLength() - 1 : 0;
+    wo.threads = threads;
+    std::vector<Stripe> stripes = PlanStripes(regs, wo.stripeSize);
+    std::vector<SigHits> hits(stripes.size());
+    std::atomic<bool> cancel{false};
+    std::atomic<float> progress{0.f};
+    WalkStripes(mem, stripes, wo, cancel, progress, [&](const ChunkView& v) {
+        prog.Search(v.data, v.size, v.ownedSize, v.addr, hits[v.stripe], alignment);
+    });
+    for (auto& h : hits) out.Append(h);
+}
+
+}} // namespace
@@ -0,0 +1,288 @@
+#include <vector>
+#include <string>
+#include <thread>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+#include <cstdio>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define REKIT_DIFF_SSE2 1
+#include <emmintrin.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#include "include/REKit/memsearch/SnapshotDiff.h"
+#include "include/REKit/memsearch/PageSnapshot.h"
+#include "include/REKit/memsearch/RegionWalker.h"
+#include "include/REKit/memsearch/ScanStats.h"
+
+namespace REKit { namespace MemSearch {
+
+namespace {
+
+const size_t kItem  = 4 << 20;
+const size_t kChunk = 1 << 16;
+
+inline unsigned Ctz64(uint64_t v) {
+#ifdef _MSC_VER
+    unsigned long i;
+    if ((uint32_t)v) { _BitScanForward(&i, (uint32_t)v); return (unsigned)i; }
+    _BitScanForward(&i, (uint32_t)(v >> 32)); return (unsigned)i + 32;
+#else
+    return (unsigned)__builtin_ctzll(v);
+#endif
+}
+
+// Bit i set when a[i] != b[i], for one 64-byte block.
+inline uint64_t DiffMask64(const uint8_t* a, const uint8_t* b) {
+#ifdef REKIT_DIFF_SSE2
+    uint64_t eq = 0;
+    for (int k = 0; k < 4; ++k) {
+        __m128i x = _mm_loadu_si128((const __m128i*)(a + k * 16));
+        __m128i y = _mm_loadu_si128((const __m128i*)(b + k * 16));
+        eq |= (uint64_t)(unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) << (k * 16);
+    }
+    return ~eq;
+#else
+    uint64_t x[8], y[8], any = 0;
+    memcpy(x, a, 64); memcpy(y, b, 64);
+    for (int k = 0; k < 8; ++k) any |= x[k] ^ y[k];
+    if (!any) return 0;
+    uint64_t m = 0;
+    for (int i = 0; i < 64; ++i) m |= (uint64_t)(a[i] != b[i]) << i;
+    return m;
+#endif
+}
+
+struct Emitter {
+    std::vector<DiffRange>& out;
+    size_t gap;
+    void Add(uintptr_t addr, size_t n) {
+        if (!out.empty()) {
+            DiffRange& l = out.back();
+            if (addr - (l.addr + l.size) <= gap) {
+                l.size = (size_t)(addr + n - l.addr);
+                return;
+            }
+        }
+        out.push_back({ addr, n });
+    }
+};
+
+void CompareBytes(const uint8_t* a, const uint8_t* b, size_t n, uintptr_t base, Emitter& em) {
+    size_t i = 0;
+    for (; i + 64 <= n; i += 64) {
+        uint64_t m = DiffMask64(a + i, b + i);
+        while (m) {
+            unsigned s = Ctz64(m);
+            uint64_t rest = ~(m >> s);
+            unsigned run = rest ? Ctz64(rest) : 64 - s;
+            em.Add(base + i + s, run);
+            if (s + run >= 64) break;
+            m &= ~0ull << (s + run);
+        }
+    }
+    for (; i < n; ++i)
+        if (a[i] != b[i]) em.Add(base + i, 1);
+}
+
+// Common readable ranges of two sources; local pointers kept per side.
+struct Piece { uintptr_t base; size_t size; const uint8_t* la; const uint8_t* lb; };
+
+void Intersect(std::vector<Region> ra, std::vector<Region> rb, std::vector<Piece>& out) {
+    auto byBase = [](const Region& x, const Region& y) { return x.base < y.base; };
+    std::sort(ra.begin(), ra.end(), byBase);
+    std::sort(rb.begin(), rb.end(), byBase);
+    size_t i = 0, j = 0;
+    while (i < ra.size() && j < rb.size()) {
+        const Region& x = ra[i];
+        const Region& y = rb[j];
+        uintptr_t b = (std::max)(x.base, y.base);
+        uintptr_t e = (std::min)(x.base + x.size, y.base + y.size);
+        if (b < e) out.push_back({ b, (size_t)(e - b), x.local ? x.local + (b - x.base) : nullptr, y.local ? y.local + (b - y.base) : nullptr });
+        if (x.base + x.size < y.base + y.size) ++i; else ++j;
+    }
+}
+
+struct Worker {
+    const IMemorySource& a;
+    const IMemorySource& b;
+    const PageSnapshot* sa;     // both set when the snapshots share a store
+    const PageSnapshot* sb;
+    std::vector<uint8_t> bufA, bufB;
+    uint64_t sameId = 0, compared = 0, unread = 0;
+
+    void Span(const Piece& p, uintptr_t at, size_t n, Emitter& em) {
+        const uint8_t* x = p.la ? p.la + (at - p.base) : nullptr;
+        const uint8_t* y = p.lb ? p.lb + (at - p.base) : nullptr;
+        size_t nx = n, ny = n;
+        if (!x) { nx = a.Read(at, bufA.data(), n); x = bufA.data(); }
+        if (!y) { ny = b.Read(at, bufB.data(), n); y = bufB.data(); }
+        size_t k = (std::min)(nx, ny);
+        CompareBytes(x, y, k, at, em);
+        compared += k;
+        unread += n - k;
+    }
+
+    void Chunk(const Piece& p, uintptr_t at, size_t n, Emitter& em) {
+        if (!sa) { Span(p, at, n, em); return; }
+        // equal page ids at the same page start hold equal bytes; compare the rest
+        const uintptr_t end = at + n;
+        uintptr_t run = at;
+        for (uintptr_t cur = at; cur < end; ) {
+            uintptr_t pa = 0, pb = 0;
+            uint32_t ia = sa->PageAt(cur, &pa), ib = sb->PageAt(cur, &pb);
+            uintptr_t next = (std::min)(end, pa + PageStore::kPage);
+            if (ia == ib && ia != PageStore::kMissing && pa == pb) {
+                if (run < cur) Span(p, run, (size_t)(cur - run), em);
+                sameId += next - cur;
+                run = next;
+            }
+            else if (ia == PageStore::kMissing || ib == PageStore::kMissing) {
+                next = (std::min)(end, cur + PageStore::kPage - (cur - p.base) % PageStore::kPage);
+            }
+            else next = (std::min)(next, pb + PageStore::kPage);
+            cur = next;
+        }
+        if (run < end) Span(p, run, (size_t)(end - run), em);
+    }
+};
+
+} // namespace
+
+bool DiffMemory(const IMemorySource& before, const IMemorySource& after, std::vector<DiffRange>& out,
+                std::atomic<bool>& cancel, std::atomic<float>& progress, const DiffOptions& opt, DiffStats* stats) {
+    uint64_t t0 = ScanStats::NowNs();
+    out.clear();
+    progress = 0.f;
+
+    std::vector<Region> ra, rb;
+    before.EnumReadableRegions(ra);
+    after.EnumReadableRegions(rb);
+    std::vector<Piece> pieces;
+    Intersect(std::move(ra), std::move(rb), pieces);
+
+    struct Item { size_t piece; uintptr_t base; size_t size; };
+    std::vector<Item> items;
+    WalkProgress prog;
+    for (size_t i = 0; i < pieces.size(); ++i) {
+        for (size_t off = 0; off < pieces[i].size; off += kItem)
+            items.push_back({ i, pieces[i].base + off, (std::min)(kItem, pieces[i].size - off) });
+        prog.total += pieces[i].size;
+    }
+    prog.out = &progress;
+
+    const PageSnapshot* sa = dynamic_cast<const PageSnapshot*>(&before);
+    const PageSnapshot* sb = dynamic_cast<const PageSnapshot*>(&after);
+    if (!sa || !sb || sa->Store() != sb->Store()) sa = sb = nullptr;
+
+    // per-item outputs, concatenated in address order afterwards
+    std::vector<std::vector<DiffRange>> parts(items.size());
+    std::atomic<size_t> next{0};
+    std::atomic<uint64_t> sameId{0}, compared{0}, unread{0};
+    auto work = [&]() {
+        Worker w{ before, after, sa, sb, std::vector<uint8_t>(kChunk), std::vector<uint8_t>(kChunk) };
+        for (;;) {
+            if (cancel) break;
+            size_t ii = next.fetch_add(1);
+            if (ii >= items.size()) break;
+            const Item& it = items[ii];
+            Emitter em{ parts[ii], opt.mergeGap };
+            for (size_t off = 0; off < it.size && !cancel; off += kChunk) {
+                size_t n = (std::min)(kChunk, it.size - off);
+                w.Chunk(pieces[it.piece], it.base + off, n, em);
+                prog.Add(n);
+            }
+        }
+        sameId += w.sameId; compared += w.compared; unread += w.unread;
+    };
+    unsigned n = ResolveThreadCount(opt.threads, items.size());
+    if (n == 1) work();
+    else {
+        std::vector<std::thread> pool;
+        for (unsigned i = 0; i < n; ++i) pool.emplace_back(work);
+        for (auto& t : pool) t.join();
+    }
+
+    size_t total = 0;
+    for (auto& p : parts) total += p.size();
+    out.reserve(total);
+    Emitter em{ out, opt.mergeGap };
+    for (auto& p : parts)
+        for (auto& r : p) em.Add(r.addr, r.size);
+
+    if (stats) {
+        stats->bytes += prog.total;
+        stats->sameIdBytes += sameId;
+        stats->comparedBytes += compared;
+        stats->unreadBytes += unread;
+        for (auto& r : out) stats->changedBytes += r.size;
+        stats->ranges += out.size();
+        stats->ns += ScanStats::NowNs() - t0;
+    }
+    if (cancel) return false;
+    progress = 1.f;
+    return true;
+}
+
+namespace {
+
+// finite, normal and of a magnitude game and UI values tend to have
+bool PlausibleFloat(double v) {
+    if (v == 0.0) return true;
+    if (!std::isfinite(v)) return false;
+    double m = std::fabs(v);
+    return m >= 1e-6 && m <= 1e9;
+}
+
+std::string Format(DiffType t, const uint8_t* p, size_t n) {
+    char s[80];
+    switch (t) {
+    case DiffType::Int32:  { int32_t v; memcpy(&v, p, 4); snprintf(s, sizeof(s), "%d", v); return s; }
+    case DiffType::Float:  { float v;   memcpy(&v, p, 4); snprintf(s, sizeof(s), "%g", v); return s; }
+    case DiffType::Double: { double v;  memcpy(&v, p, 8); snprintf(s, sizeof(s), "%g", v); return s; }
+    case DiffType::Int64: {
+        int64_t v; memcpy(&v, p, 8);
+        if (v > -(1LL << 32) && v < (1LL << 32)) snprintf(s, sizeof(s), "%lld", (long long)v);
+        else snprintf(s, sizeof(s), "0x%llX", (unsigned long long)v);     // likely a pointer
+        return s;
+    }
+    case DiffType::Bytes: break;
+    }
+    std::string out;
+    for (size_t i = 0; i < n; ++i) { snprintf(s, sizeof(s), i ? " %02X" : "%02X", p[i]); out += s; }
+    return out;
+}
+
+} // namespace
+
+DiffValue DecodeDiff(const IMemorySource& before, const IMemorySource& after, const DiffRange& r) {
+    DiffValue v{ r.addr, r.size, DiffType::Bytes, std::string(), std::string() };
+    const uintptr_t last = r.addr + (r.size ? r.size - 1 : 0);
+    if ((r.addr & ~(uintptr_t)3) == (last & ~(uintptr_t)3)) { v.addr = r.addr & ~(uintptr_t)3; v.size = 4; }
+    else if ((r.addr & ~(uintptr_t)7) == (last & ~(uintptr_t)7)) { v.addr = r.addr & ~(uintptr_t)7; v.size = 8; }
+    else v.size = (std::min)(r.size, (size_t)16);
+
+    uint8_t x[16] = {0}, y[16] = {0};
+    size_t nx = before.Read(v.addr, x, v.size), ny = after.Read(v.addr, y, v.size);
+    if (nx < v.size || ny < v.size) {
+        v.size = (std::min)({ r.size, (size_t)16 });
+        v.addr = r.addr;
+        nx = before.Read(v.addr, x, v.size); ny = after.Read(v.addr, y, v.size);
+    }
+    else if (v.size == 4) {
+        float fx, fy; memcpy(&fx, x, 4); memcpy(&fy, y, 4);
+        v.type = PlausibleFloat(fx) && PlausibleFloat(fy) && (fx != 0.f || fy != 0.f) ? DiffType::Float : DiffType::Int32;
+    }
+    else if (v.size == 8) {
+        double dx, dy; memcpy(&dx, x, 8); memcpy(&dy, y, 8);
+        v.type = PlausibleFloat(dx) && PlausibleFloat(dy) && (dx != 0.0 || dy != 0.0) ? DiffType::Double : DiffType::Int64;
+    }
+    v.before = nx ? Format(v.type, x, nx) : "??";
+    v.after  = ny ? Format(v.type, y, ny) : "??";
+    return v;
+}
+
+}} // namespace
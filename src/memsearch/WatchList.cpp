@@ -0,0 +1,249 @@
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include "include/REKit/memsearch/WatchList.h"
+
+namespace REKit { namespace MemSearch {
+
+static constexpr uintptr_t kPageSize = 4096;
+static constexpr size_t kMaxReadPages = 16;     // adjacent pages merged into one read, up to this many
+
+WatchList::WatchList() {}
+
+WatchList::~WatchList() { Stop(); }
+
+bool WatchList::Start(unsigned pid, unsigned rateHz) {
+    Stop();
+    std::unique_ptr<ProcessMemory> mem(new ProcessMemory(pid));
+    if (!mem->IsOpen()) return false;
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        mem_ = std::move(mem);
+        pid_ = pid;
+        stop_ = false;
+        dirty_ = true;
+        stats_ = WatchStats();
+        pollSumNs_ = 0;
+    }
+    SetRate(rateHz);
+    running_ = true;
+    thread_ = std::thread(&WatchList::Run, this);
+    return true;
+}
+
+void WatchList::Stop() {
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) thread_.join();
+    running_ = false;
+    mem_.reset();
+}
+
+void WatchList::SetRate(unsigned rateHz) {
+    rateHz_ = (std::max)(1u, (std::min)(rateHz, 1000u));
+    cv_.notify_all();
+}
+
+uint64_t WatchList::Add(uintptr_t addr, ScanType type, size_t size) {
+    if (type == ScanType::Int32 || type == ScanType::Float) size = 4;
+    else if (type == ScanType::Double) size = 8;
+    if (size == 0 || size > sizeof(uint64_t)) return 0;
+    std::unique_ptr<Entry> e(new Entry());
+    e->info.addr = addr;
+    e->info.type = type;
+    e->info.size = size;
+    std::lock_guard<std::mutex> lk(mu_);
+    const uint64_t id = nextId_++;
+    e->info.id = id;
+    auto it = std::upper_bound(entries_.begin(), entries_.end(), addr,
+        [](uintptr_t a, const std::unique_ptr<Entry>& x) { return a < x->info.addr; });
+    entries_.insert(it, std::move(e));
+    dirty_ = true;
+    return id;
+}
+
+bool WatchList::Remove(uint64_t id) {
+    std::lock_guard<std::mutex> lk(mu_);
+    auto it = std::find_if(entries_.begin(), entries_.end(), [&](const std::unique_ptr<Entry>& x) { return x->info.id == id; });
+    if (it == entries_.end()) return false;
+    entries_.erase(it);
+    dirty_ = true;
+    return true;
+}
+
+void WatchList::Clear() {
+    std::lock_guard<std::mutex> lk(mu_);
+    entries_.clear();
+    dirty_ = true;
+}
+
+size_t WatchList::Count() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return entries_.size();
+}
+
+std::vector<WatchInfo> WatchList::Entries() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    std::vector<WatchInfo> out;
+    out.reserve(entries_.size());
+    for (auto& e : entries_) out.push_back(e->info);
+    return out;
+}
+
+bool WatchList::History(uint64_t id, std::vector<double>& values, std::vector<uint64_t>* timesNs) const {
+    std::lock_guard<std::mutex> lk(mu_);
+    auto it = std::find_if(entries_.begin(), entries_.end(), [&](const std::unique_ptr<Entry>& x) { return x->info.id == id; });
+    if (it == entries_.end()) return false;
+    const Entry& e = **it;
+    size_t n = e.info.samples;
+    values.resize(n);
+    if (timesNs) timesNs->resize(n);
+    size_t start = (e.head + kHistory - n) % kHistory;
+    for (size_t i = 0; i < n; ++i) {
+        const WatchSample& s = e.ring[(start + i) % kHistory];
+        values[i] = Decode(e.info.type, e.info.size, s.raw);
+        if (timesNs) (*timesNs)[i] = s.timeNs;
+    }
+    return true;
+}
+
+WatchStats WatchList::Stats() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    WatchStats s = stats_;
+    if (s.polls) s.pollAvgNs = pollSumNs_ / s.polls;
+    return s;
+}
+
+double WatchList::Decode(ScanType type, size_t size, uint64_t raw) {
+    switch (type) {
+    case ScanType::Int32:  { int32_t v; memcpy(&v, &raw, sizeof(v)); return (double)v; }
+    case ScanType::Float:  { float v;   memcpy(&v, &raw, sizeof(v)); return (double)v; }
+    case ScanType::Double: { double v;  memcpy(&v, &raw, sizeof(v)); return v; }
+    default: break;
+    }
+    if (size < sizeof(raw)) raw &= ((uint64_t)1 << (size * 8)) - 1;
+    return (double)raw;
+}
+
+// Distinct pages in address order, adjacent ones merged into one read.
+void WatchList::RebuildLocked() {
+    reads_.clear();
+    entryRead_.assign(entries_.size(), 0);
+    size_t off = 0;
+    uint64_t pages = 0;
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        const WatchInfo& w = entries_[i]->info;
+        uintptr_t first = w.addr & ~(kPageSize - 1);
+        uintptr_t end = ((w.addr + w.size - 1) & ~(kPageSize - 1)) + kPageSize;
+        if (!reads_.empty()) {
+            Read& r = reads_.back();
+            uintptr_t rend = r.addr + r.size;
+            // an entry overlapping the read always joins it; an adjacent page only up to the cap
+            if (first < rend || (first == rend && end - r.addr <= kMaxReadPages * kPageSize)) {
+                if (end > rend) {
+                    pages += (end - rend) / kPageSize;
+                    off += (size_t)(end - rend);
+                    r.size = (size_t)(end - r.addr);
+                }
+                entryRead_[i] = reads_.size() - 1;
+                continue;
+            }
+        }
+        reads_.push_back({ first, (size_t)(end - first), off });
+        pages += (end - first) / kPageSize;
+        off += (size_t)(end - first);
+        entryRead_[i] = reads_.size() - 1;
+    }
+    buf_.resize(off);
+    stats_.pages = pages;
+    dirty_ = false;
+}
+
+void WatchList::Record(Entry& e, uint64_t raw, uint64_t now) {
+    WatchInfo& w = e.info;
+    double v = Decode(w.type, w.size, raw);
+    bool first = (w.samples == 0);
+    if (!first && w.valid && raw == w.raw) return;
+    if (first) { w.min = w.max = v; }
+    else {
+        if (raw != w.raw) { ++w.changes; w.lastChangeNs = now; }
+        w.min = (std::min)(w.min, v);
+        w.max = (std::max)(w.max, v);
+    }
+    w.raw = raw;
+    w.value = v;
+    w.valid = true;
+    e.ring[e.head] = { now, raw };
+    e.head = (e.head + 1) % kHistory;
+    if (w.samples < kHistory) ++w.samples;
+}
+
+void WatchList::Run() {
+    using Clock = std::chrono::steady_clock;
+    std::vector<ReadSpan> batch, pageBatch;
+    std::vector<char> failed, pageFailed, badPage;
+    auto deadline = Clock::now();
+    std::unique_lock<std::mutex> lk(mu_);
+    for (;;) {
+        auto period = std::chrono::microseconds(1000000 / rateHz_.load());
+        deadline += period;
+        cv_.wait_until(lk, deadline, [&] { return stop_; });
+        if (stop_) break;
+        if (dirty_) RebuildLocked();
+        lk.unlock();
+
+        // reads_ and buf_ only change in RebuildLocked, on this thread
+        uint64_t t0 = ScanStats::NowNs();
+        batch.resize(reads_.size());
+        for (size_t i = 0; i < reads_.size(); ++i) batch[i] = { reads_[i].addr, buf_.data() + reads_[i].off, reads_[i].size };
+        size_t bad = batch.empty() ? 0 : mem_->ReadBatch(batch.data(), batch.size(), &failed);
+        // a failed merged read is retried page by page, so one unreadable
+        // page does not invalidate the entries on its neighbours
+        badPage.assign(buf_.size() / kPageSize, 0);
+        pageBatch.clear();
+        for (size_t i = 0; bad && i < reads_.size(); ++i) {
+            if (!failed[i]) continue;
+            for (size_t o = 0; o < reads_[i].size; o += kPageSize) {
+                if (reads_[i].size > kPageSize) pageBatch.push_back({ reads_[i].addr + o, buf_.data() + reads_[i].off + o, kPageSize });
+                else badPage[(reads_[i].off + o) / kPageSize] = 1;
+            }
+        }
+        if (!pageBatch.empty()) {
+            mem_->ReadBatch(pageBatch.data(), pageBatch.size(), &pageFailed);
+            for (size_t k = 0; k < pageBatch.size(); ++k)
+                if (pageFailed[k]) badPage[(size_t)((const uint8_t*)pageBatch[k].data - buf_.data()) / kPageSize] = 1;
+        }
+        uint64_t t1 = ScanStats::NowNs();
+
+        lk.lock();
+        ++stats_.polls;
+        stats_.readCalls += batch.size() + pageBatch.size();
+        stats_.readFailures += (uint64_t)std::count(badPage.begin(), badPage.end(), (char)1);
+        pollSumNs_ += t1 - t0;
+        stats_.pollMaxNs = (std::max)(stats_.pollMaxNs, t1 - t0);
+        if (!dirty_) {
+            // entries_ still matches the layout unless it changed while reading
+            for (size_t i = 0; i < entries_.size(); ++i) {
+                Entry& e = *entries_[i];
+                const Read& r = reads_[entryRead_[i]];
+                const size_t at = r.off + (size_t)(e.info.addr - r.addr);
+                bool ok = true;
+                for (size_t pg = at / kPageSize; pg <= (at + e.info.size - 1) / kPageSize; ++pg) ok = ok && !badPage[pg];
+                if (!ok) { e.info.valid = false; continue; }
+                uint64_t raw = 0;
+                memcpy(&raw, buf_.data() + at, e.info.size);
+                Record(e, raw, t1);
+            }
+        }
+
+        auto now = Clock::now();
+        if (now > deadline + period) deadline = now;    // overran; don't burst to catch up
+    }
+}
+
+}} // namespace
@@ -1,31 +1,32 @@
 #include "include/EnumProcessInfo.h"
+#include "include/ProcessAttrCache.h"
+#include "include/ProcessSnapshot.h"
 #include <imgui/imgui.h>
+#include <cstring>
+#ifndef _WIN32
+#include "include/ProcFsReader.h"
+#endif
+
+// A snapshot comes back here when its last holder drops it, and the next poll
+// refills its columns and arena in place instead of building new ones.
+static std::mutex g_spareMutex;
+static std::unique_ptr<ProcessSnapshot> g_spare;
+
+static void RecycleSnapshot(const ProcessSnapshot* snapshot) {
+    std::lock_guard<std::mutex> lock(g_spareMutex);
+    if (!g_spare) g_spare.reset(const_cast<ProcessSnapshot*>(snapshot));
+    else delete snapshot;
+}
 
-std::vector<ProcessInfo> g_processes;
-std::mutex g_processesMutex;
+// Current snapshot; replaced with std::atomic_store by the monitoring thread.
+static ProcessSnapshotPtr g_snapshot(new ProcessSnapshot(), RecycleSnapshot);
 std::atomic<bool> g_backgroundThreadRunning(false);
 std::thread g_backgroundThread;
 
-static std::wstring GetProcessImagePath(ULONG pid) {
-    if (pid == 0) return L"";
-
-    HANDLE hProcess = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pid);
-    if (!hProcess) return L"";
-
-    WCHAR path[MAX_PATH];
-    DWORD size = MAX_PATH;
-    if (QueryFullProcessImageNameW(hProcess, 0, path, &size)) {
-        CloseHandle(hProcess);
-        return std::wstring(path);
-    }
-
-    CloseHandle(hProcess);
-    return L"";
-}
-
-static bool EnumerateProcesses(std::vector<ProcessInfo>& processes) {
-    processes.clear();
+#ifdef _WIN32
 
+// Elements of processes are overwritten in place; prev is not needed here.
+static bool EnumerateProcesses(const std::vector<ProcessInfo>&, std::vector<ProcessInfo>& processes) {
     HMODULE hNtDll = GetModuleHandle(L"ntdll.dll");
     if (!hNtDll) return FALSE;
 
@@ -63,11 +64,17 @@ static bool EnumerateProcesses(std::vector<ProcessInfo>& processes) {
         return FALSE;
     }
 
+    // path, command line and user are read once per (pid, createTime)
+    static ProcessAttrCache attrCache;
+    attrCache.BeginPoll();
+
+    size_t n = 0;
     PSYSTEM_PROCESS_INFORMATION pInfo = (PSYSTEM_PROCESS_INFORMATION)pBuffer;
     while (pInfo) {
-        ProcessInfo proc;
+        if (n == processes.size()) processes.emplace_back();
+        ProcessInfo& proc = processes[n++];
         if (pInfo->ImageName.Buffer && pInfo->ImageName.Length > 0) {
-            proc.name = std::wstring(pInfo->ImageName.Buffer, pInfo->ImageName.Length / sizeof(WCHAR));
+            proc.name.assign(pInfo->ImageName.Buffer, pInfo->ImageName.Length / sizeof(WCHAR));
         }
         else {
             proc.name = L"(System Idle Process)";
@@ -91,25 +98,54 @@ static bool EnumerateProcesses(std::vector<ProcessInfo>& processes) {
         proc.writeTransferCount = pInfo->WriteTransferCount;
         proc.otherTransferCount = pInfo->OtherTransferCount;
         //thread
-        proc.imagePath = GetProcessImagePath(proc.pid);
-
-        processes.push_back(proc);
+        const ProcessAttrs& attrs = attrCache.Get(proc.pid, proc.createTime.QuadPart);
+        proc.imagePath = attrs.imagePath;
+        proc.commandLine = attrs.commandLine;
+        proc.userName = attrs.userName;
 
         if (pInfo->NextEntryOffset == 0) break;
         pInfo = (PSYSTEM_PROCESS_INFORMATION)((BYTE*)pInfo + pInfo->NextEntryOffset);
     }
 
+    attrCache.EndPoll();
     free(pBuffer);
+    processes.resize(n);
+    std::sort(processes.begin(), processes.end(), [](const ProcessInfo& a, const ProcessInfo& b) { return a.pid < b.pid; });
     return TRUE;
 }
 
+#else
+
+// prev is the list of the previous poll; ProcFsReader copies from it.
+static bool EnumerateProcesses(const std::vector<ProcessInfo>& prev, std::vector<ProcessInfo>& processes) {
+    static ProcFsReader reader;
+    return reader.Poll(prev, processes);
+}
+
+#endif
+
 static void BackgroundProcessUpdateThread() {
     g_backgroundThreadRunning = true;
+    // rows of the last two polls, private to this thread; the older one is
+    // overwritten by the next poll
+    std::vector<ProcessInfo> prevRows, rows;
+    StringInterner interner;
+    uint64_t sequence = 0;
     while (g_backgroundThreadRunning) {
-        std::vector<ProcessInfo> newProcesses;
-        if (EnumerateProcesses(newProcesses)) {
-            std::lock_guard<std::mutex> lock(g_processesMutex);
-            g_processes = std::move(newProcesses);
+        std::unique_ptr<ProcessSnapshot> next;
+        {
+            std::lock_guard<std::mutex> lock(g_spareMutex);
+            next = std::move(g_spare);
+        }
+        if (!next) next.reset(new ProcessSnapshot());
+        if (EnumerateProcesses(prevRows, rows)) {
+            next->Assign(rows, interner);
+            next->sequence = ++sequence;
+            std::atomic_store(&g_snapshot, ProcessSnapshotPtr(next.release(), RecycleSnapshot));
+            prevRows.swap(rows);
+        }
+        else {
+            RecycleSnapshot(next.release());
         }
         std::this_thread::sleep_for(std::chrono::seconds(1));
     }
@@ -128,99 +164,79 @@ void StopProcessMonitoring() {
     }
 }
 
-std::vector<ProcessInfo> GetProcessList() {
-    std::lock_guard<std::mutex> lock(g_processesMutex);
-    return g_processes;
+ProcessSnapshotPtr GetProcessSnapshot() {
+    return std::atomic_load(&g_snapshot);
 }
 
 size_t GetProcessCount() {
-    std::lock_guard<std::mutex> lock(g_processesMutex);
-    return g_processes.size();
-}
-
-ProcessInfo* FindProcessByPID(ULONG pid) {
-    std::lock_guard<std::mutex> lock(g_processesMutex);
-    for (auto& proc : g_processes) {
-        if (proc.pid == pid) {
-            return &proc;
-        }
-    }
-    return nullptr;
+    return GetProcessSnapshot()->Size();
 }
 
-std::vector<ProcessInfo> FilterProcesses(const std::string& nameFilter,
+std::vector<uint32_t> FilterProcesses(const ProcessSnapshot& snapshot,
+    const std::string& nameFilter,
     const std::string& pidFilter,
     const std::string& pathFilter) {
-    std::vector<ProcessInfo> filtered;
-
-    std::lock_guard<std::mutex> lock(g_processesMutex);
+    std::vector<uint32_t> filtered;
 
-    for (const auto& proc : g_processes) {
-        bool match = TRUE;
-
-        if (!nameFilter.empty()) {
-            std::string procName = WStringToString(proc.name);
-            std::string filter = nameFilter;
-            std::transform(procName.begin(), procName.end(), procName.begin(), ::tolower);
-            std::transform(filter.begin(), filter.end(), filter.begin(), ::tolower);
-            if (procName.find(filter) == std::string::npos) {
-                match = FALSE;
-            }
-        }
+    if (!pidFilter.empty()) {
+        uint32_t row = snapshot.Find(std::stoul(pidFilter));
+        if (row != ProcessSnapshot::kNoRow) filtered.push_back(row);
+    }
+    else {
+        filtered.resize(snapshot.Size());
+        for (uint32_t row = 0; row < (uint32_t)filtered.size(); ++row) filtered[row] = row;
+    }
 
-        if (match && !pidFilter.empty()) {
-            ULONG filterPid = std::stoul(pidFilter);
-            if (proc.pid != filterPid) {
-                match = FALSE;
-            }
-        }
+    const std::string name = LowerAscii(nameFilter);
+    const std::string path = LowerAscii(pathFilter);
+    const StringArena& strings = snapshot.strings;
+    filtered.erase(std::remove_if(filtered.begin(), filtered.end(), [&](uint32_t row) {
+        if (!name.empty() && !std::strstr(strings.Lower(snapshot.name[row]), name.c_str())) return true;
+        if (!path.empty() && !std::strstr(strings.Lower(snapshot.imagePath[row]), path.c_str())) return true;
+        return false;
+    }), filtered.end());
 
-        if (match && !pathFilter.empty()) {
-            std::string procPath = WStringToString(proc.imagePath);
-            std::string filter = pathFilter;
-            std::transform(procPath.begin(), procPath.end(), procPath.begin(), ::tolower);
-            std::transform(filter.begin(), filter.end(), filter.begin(), ::tolower);
-            if (procPath.find(filter) == std::string::npos) {
-                match = FALSE;
-            }
-        }
+    return filtered;
+}
 
-        if (match) {
-            filtered.push_back(proc);
-        }
-    }
+template <typename T>
+static int CompareColumn(const std::vector<T>& column, uint32_t a, uint32_t b) {
+    return (column[a] < column[b]) ? -1 : (column[a] > column[b]) ? 1 : 0;
+}
 
-    return filtered;
+// Interned strings are equal exactly when their ids are.
+static int CompareString(const StringArena& strings, uint32_t a, uint32_t b) {
+    return a == b ? 0 : std::strcmp(strings.Lower(a), strings.Lower(b));
 }
 
-void SortProcessList(std::vector<ProcessInfo>& processes, const ImGuiTableSortSpecs* sort_specs) {
+void SortProcessList(const ProcessSnapshot& snapshot, std::vector<uint32_t>& rows, const ImGuiTableSortSpecs* sort_specs) {
     if (sort_specs->SpecsCount == 0) return;
-    std::sort(processes.begin(), processes.end(),
-        [sort_specs](const ProcessInfo& a, const ProcessInfo& b) -> bool {
+    std::sort(rows.begin(), rows.end(),
+        [&snapshot, sort_specs](uint32_t a, uint32_t b) -> bool {
             for (int n = 0; n < sort_specs->SpecsCount; n++) {
                 const ImGuiTableColumnSortSpecs* sort_spec = &sort_specs->Specs[n];
                 int delta = 0;
                 switch (sort_spec->ColumnIndex) {
                 case 0: // 
-                    delta = _wcsicmp(a.name.c_str(), b.name.c_str());
+                    delta = CompareString(snapshot.strings, snapshot.name[a], snapshot.name[b]);
                     break;
                 case 1: // PID
-                    delta = (a.pid < b.pid) ? -1 : (a.pid > b.pid) ? 1 : 0;
+                    delta = CompareColumn(snapshot.pid, a, b);
                     break;
                 case 2: // 
-                    delta = (a.threads < b.threads) ? -1 : (a.threads > b.threads) ? 1 : 0;
+                    delta = CompareColumn(snapshot.threads, a, b);
                     break;
                 case 3: // 
-                    delta = (a.handles < b.handles) ? -1 : (a.handles > b.handles) ? 1 : 0;
+                    delta = CompareColumn(snapshot.handles, a, b);
                     break;
                 case 4: // 
-                    delta = _wcsicmp(a.imagePath.c_str(), b.imagePath.c_str());
+                    delta = CompareString(snapshot.strings, snapshot.imagePath[a], snapshot.imagePath[b]);
                     break;
                 }
                 if (delta != 0) {
                     return (sort_spec->SortDirection == ImGuiSortDirection_Ascending) ? (delta < 0) : (delta > 0);
                 }
             }
-            return FALSE;
+            return false;
         });
 }
\ No newline at end of file
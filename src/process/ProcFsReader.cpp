@@ -0,0 +1,324 @@
+#ifndef _WIN32
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+#include "include/ProcFsReader.h"
+#include "include/ProcessAttrCache.h"
+
+namespace {
+
+const uint64_t kFileTimeEpoch = 116444736000000000ull;     // 1601 -> 1970 in 100ns units
+const unsigned kDetailPeriod = 8;                           // status / io refreshed every this many polls
+const size_t kMaxCachedFds = 8192;
+
+struct LinuxDirent64 {
+    uint64_t       d_ino;
+    int64_t        d_off;
+    unsigned short d_reclen;
+    unsigned char  d_type;
+    char           d_name[1];
+};
+
+inline const char* SkipSpaces(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t')) ++p;
+    return p;
+}
+
+inline uint64_t ParseU64(const char*& p, const char* end) {
+    p = SkipSpaces(p, end);
+    uint64_t v = 0;
+    while (p < end && *p >= '0' && *p <= '9') v = v * 10 + (uint64_t)(*p++ - '0');
+    return v;
+}
+
+inline int64_t ParseI64(const char*& p, const char* end) {
+    p = SkipSpaces(p, end);
+    bool neg = p < end && *p == '-';
+    if (neg) ++p;
+    int64_t v = (int64_t)ParseU64(p, end);
+    return neg ? -v : v;
+}
+
+inline void SkipField(const char*& p, const char* end) {
+    p = SkipSpaces(p, end);
+    while (p < end && *p != ' ') ++p;
+}
+
+struct StatFields {
+    const char* comm = nullptr;
+    size_t   commLen = 0;
+    int64_t  session = 0, priority = 0, threads = 0;
+    uint64_t utime = 0, stime = 0, start = 0, vsize = 0, rss = 0;
+};
+
+// pid (comm) state ppid pgrp session ... ; comm may hold spaces and ')'
+bool ParseStat(const char* s, size_t n, StatFields& f) {
+    const char* end = s + n;
+    const char* open = (const char*)memchr(s, '(', n);
+    const char* close = nullptr;
+    for (const char* q = end; q > s; --q) if (q[-1] == ')') { close = q - 1; break; }
+    if (!open || !close || close < open) return false;
+    f.comm = open + 1;
+    f.commLen = (size_t)(close - open - 1);
+    const char* p = close + 1;
+    for (int field = 3; field <= 24 && p < end; ++field) {
+        switch (field) {
+        case 6:  f.session = ParseI64(p, end); break;
+        case 14: f.utime = ParseU64(p, end); break;
+        case 15: f.stime = ParseU64(p, end); break;
+        case 18: f.priority = ParseI64(p, end); break;
+        case 20: f.threads = ParseI64(p, end); break;
+        case 22: f.start = ParseU64(p, end); break;
+        case 23: f.vsize = ParseU64(p, end); break;
+        case 24: f.rss = ParseU64(p, end); break;
+        default: SkipField(p, end); break;
+        }
+    }
+    return true;
+}
+
+// Value of "key:" at the start of a line; value is multiplied by 1024 when the line ends in kB.
+bool FindKey(const char* s, size_t n, const char* key, uint64_t& out) {
+    const size_t klen = strlen(key);
+    const char* end = s + n;
+    for (const char* line = s; line < end; ) {
+        const char* nl = (const char*)memchr(line, '\n', (size_t)(end - line));
+        if (!nl) nl = end;
+        if ((size_t)(nl - line) > klen && memcmp(line, key, klen) == 0) {
+            const char* p = line + klen;
+            out = ParseU64(p, nl);
+            p = SkipSpaces(p, nl);
+            if (nl - p >= 2 && p[0] == 'k' && p[1] == 'B') out *= 1024;
+            return true;
+        }
+        line = nl + 1;
+    }
+    return false;
+}
+
+// UTF-8 into a wstring (UTF-32 here), reusing its capacity.
+void AssignUtf8(std::wstring& out, const char* s, size_t n) {
+    out.clear();
+    for (size_t i = 0; i < n; ) {
+        unsigned char c = (unsigned char)s[i];
+        uint32_t cp = c;
+        size_t len = 1;
+        if (c >= 0xF0 && i + 3 < n) { cp = ((c & 0x07u) << 18) | ((s[i + 1] & 0x3Fu) << 12) | ((s[i + 2] & 0x3Fu) << 6) | (s[i + 3] & 0x3Fu); len = 4; }
+        else if (c >= 0xE0 && i + 2 < n) { cp = ((c & 0x0Fu) << 12) | ((s[i + 1] & 0x3Fu) << 6) | (s[i + 2] & 0x3Fu); len = 3; }
+        else if (c >= 0xC0 && i + 1 < n) { cp = ((c & 0x1Fu) << 6) | (s[i + 1] & 0x3Fu); len = 2; }
+        out.push_back((wchar_t)cp);
+        i += len;
+    }
+}
+
+} // namespace
+
+ProcFsReader::ProcFsReader() : dents_(64 * 1024), buf_(16 * 1024) {
+    procFd_ = open("/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    ticks_ = sysconf(_SC_CLK_TCK);
+    if (ticks_ <= 0) ticks_ = 100;
+    pageSize_ = sysconf(_SC_PAGESIZE);
+    if (pageSize_ <= 0) pageSize_ = 4096;
+    // half of the fd limit at most, the rest of the program needs some too
+    struct rlimit rl{};
+    if (getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur != RLIM_INFINITY)
+        fdBudget_ = (std::min)((size_t)rl.rlim_cur / 2, kMaxCachedFds);
+    else
+        fdBudget_ = kMaxCachedFds;
+    if (procFd_ >= 0) {
+        int fd = openat(procFd_, "stat", O_RDONLY | O_CLOEXEC);
+        if (fd >= 0) {
+            ssize_t n = pread(fd, buf_.data(), buf_.size() - 1, 0);
+            close(fd);
+            uint64_t btime = 0;
+            if (n > 0 && FindKey(buf_.data(), (size_t)n, "btime", btime)) bootTime_ = btime;
+        }
+    }
+}
+
+ProcFsReader::~ProcFsReader() {
+    for (Track& t : track_) CloseFd(t.statFd);
+    for (Track& t : nextTrack_) CloseFd(t.statFd);
+    if (procFd_ >= 0) close(procFd_);
+}
+
+void ProcFsReader::CloseFd(int& fd) {
+    if (fd < 0) return;
+    close(fd);
+    fd = -1;
+    --cachedFds_;
+}
+
+void ProcFsReader::StatExe(uint32_t pid, Track& track) {
+    char path[48];
+    snprintf(path, sizeof(path), "%u/exe", pid);
+    struct stat sb;
+    // fails for kernel threads and, without ptrace access, other users' processes
+    if (fstatat(procFd_, path, &sb, 0) == 0) { track.exeDev = (uint64_t)sb.st_dev; track.exeIno = (uint64_t)sb.st_ino; }
+    else { track.exeDev = 0; track.exeIno = 0; }
+}
+
+ssize_t ProcFsReader::ReadAt(const char* name, uint32_t pid) {
+    char path[48];
+    snprintf(path, sizeof(path), "%u/%s", pid, name);
+    int fd = openat(procFd_, path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+    ssize_t n = pread(fd, buf_.data(), buf_.size() - 1, 0);
+    close(fd);
+    return n;
+}
+
+bool ProcFsReader::ReadProcess(uint32_t pid, const ProcessInfo* prev, Track* prevTrack, ProcessInfo& out, Track& track, bool details) {
+    // stat: through the cached fd when there is one; it fails once its process is gone
+    ssize_t n = -1;
+    int fd = -1;
+    if (prevTrack && prevTrack->statFd >= 0) {
+        fd = prevTrack->statFd;
+        prevTrack->statFd = -1;
+        n = pread(fd, buf_.data(), buf_.size() - 1, 0);
+        if (n <= 0) { close(fd); --cachedFds_; fd = -1; }
+    }
+    if (fd < 0) {
+        char path[48];
+        snprintf(path, sizeof(path), "%u/stat", pid);
+        fd = openat(procFd_, path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+        n = pread(fd, buf_.data(), buf_.size() - 1, 0);
+        if (n <= 0 || cachedFds_ >= fdBudget_) { close(fd); fd = -1; }
+        else ++cachedFds_;
+        if (n <= 0) return false;
+    }
+    StatFields st;
+    if (!ParseStat(buf_.data(), (size_t)n, st)) { CloseFd(fd); return false; }
+    track.pid = pid;
+    track.start = st.start;
+    track.statFd = fd;
+    track.commLen = (uint8_t)(std::min)(st.commLen, sizeof(track.comm));
+    memcpy(track.comm, st.comm, track.commLen);
+
+    const int64_t tick100ns = 10000000 / ticks_;
+    out.pid = pid;
+    out.threads = (ULONG)st.threads;
+    out.handles = 0;
+    out.sessionId = (ULONG)st.session;
+    out.basePriority = (KPRIORITY)st.priority;
+    out.workingSet = (SIZE_T)(st.rss * (uint64_t)pageSize_);
+    out.virtualSize = (SIZE_T)st.vsize;
+    out.userTime.QuadPart = (int64_t)st.utime * tick100ns;
+    out.kernelTime.QuadPart = (int64_t)st.stime * tick100ns;
+    out.createTime.QuadPart = (int64_t)(kFileTimeEpoch + bootTime_ * 10000000ull) + (int64_t)st.start * tick100ns;
+
+    // execve keeps pid and starttime; a new comm, or on detail polls a new
+    // exe file, means a new image, command line and possibly user
+    bool same = prev && prevTrack && prev->pid == pid && prevTrack->start == st.start &&
+        prevTrack->commLen == track.commLen && memcmp(prevTrack->comm, track.comm, track.commLen) == 0;
+    if (same && !details) {
+        track.exeDev = prevTrack->exeDev;
+        track.exeIno = prevTrack->exeIno;
+    }
+    else {
+        StatExe(pid, track);
+        if (same && (track.exeDev != prevTrack->exeDev || track.exeIno != prevTrack->exeIno)) same = false;
+    }
+    if (same) {
+        // copied into the slot's own strings; prev is published and stays untouched
+        out.name = prev->name;
+        out.imagePath = prev->imagePath;
+        out.commandLine = prev->commandLine;
+        out.userName = prev->userName;
+    }
+    else {
+        ProcessAttrs attrs;
+        LoadProcessAttrsAt(procFd_, pid, attrs);
+        out.imagePath.swap(attrs.imagePath);
+        out.commandLine.swap(attrs.commandLine);
+        out.userName.swap(attrs.userName);
+        // image name from the exe link; kernel threads have none and keep their comm
+        size_t slash = out.imagePath.rfind(L'/');
+        if (slash != std::wstring::npos) out.name.assign(out.imagePath, slash + 1, std::wstring::npos);
+        else AssignUtf8(out.name, st.comm, st.commLen);
+    }
+
+    if (same && !details) {
+        out.privatePages = prev->privatePages;
+        out.readTransferCount = prev->readTransferCount;
+        out.writeTransferCount = prev->writeTransferCount;
+        out.otherTransferCount = prev->otherTransferCount;
+        return true;
+    }
+    uint64_t anon = 0, swap = 0, rchar = 0, wchar = 0;
+    n = ReadAt("status", pid);
+    if (n > 0) {
+        FindKey(buf_.data(), (size_t)n, "RssAnon:", anon);
+        FindKey(buf_.data(), (size_t)n, "VmSwap:", swap);
+    }
+    // io needs the same access as ptrace; other users' processes read as 0
+    n = ReadAt("io", pid);
+    if (n > 0) {
+        FindKey(buf_.data(), (size_t)n, "rchar:", rchar);
+        FindKey(buf_.data(), (size_t)n, "wchar:", wchar);
+    }
+    out.privatePages = (SIZE_T)(anon + swap);
+    out.readTransferCount.QuadPart = (int64_t)rchar;
+    out.writeTransferCount.QuadPart = (int64_t)wchar;
+    out.otherTransferCount.QuadPart = 0;
+    return true;
+}
+
+bool ProcFsReader::Poll(const std::vector<ProcessInfo>& prevProcs, std::vector<ProcessInfo>& procs) {
+    if (procFd_ < 0) return false;
+    ++polls_;
+    auto byPid = [](const ProcessInfo& p, uint32_t pid) { return p.pid < pid; };
+    auto trackByPid = [](const Track& t, uint32_t pid) { return t.pid < pid; };
+
+    size_t n = 0;
+    bool sorted = true;
+    uint32_t last = 0;
+    lseek(procFd_, 0, SEEK_SET);
+    for (;;) {
+        long got = syscall(SYS_getdents64, procFd_, dents_.data(), dents_.size());
+        if (got <= 0) break;
+        for (long off = 0; off < got; ) {
+            const LinuxDirent64* d = (const LinuxDirent64*)(dents_.data() + off);
+            off += d->d_reclen;
+            const char* name = d->d_name;
+            if (*name < '1' || *name > '9') continue;
+            uint32_t pid = 0;
+            while (*name >= '0' && *name <= '9') pid = pid * 10 + (uint32_t)(*name++ - '0');
+            if (*name) continue;
+
+            auto pi = std::lower_bound(prevProcs.begin(), prevProcs.end(), pid, byPid);
+            auto pt = std::lower_bound(track_.begin(), track_.end(), pid, trackByPid);
+            const ProcessInfo* prev = pi != prevProcs.end() && pi->pid == pid ? &*pi : nullptr;
+            Track* prevTrack = pt != track_.end() && pt->pid == pid ? &*pt : nullptr;
+            if (n == procs.size()) procs.emplace_back();
+            if (n == nextTrack_.size()) nextTrack_.emplace_back();
+            const bool details = (pid + polls_) % kDetailPeriod == 0;
+            if (!ReadProcess(pid, prev, prevTrack, procs[n], nextTrack_[n], details)) continue;
+            if (pid < last) sorted = false;
+            last = pid;
+            ++n;
+        }
+    }
+
+    // fds of processes that are gone
+    for (Track& t : track_) CloseFd(t.statFd);
+    // /proc lists pids in ascending order; sort both the same way otherwise
+    if (!sorted) {
+        std::sort(procs.begin(), procs.begin() + n, [](const ProcessInfo& a, const ProcessInfo& b) { return a.pid < b.pid; });
+        std::sort(nextTrack_.begin(), nextTrack_.begin() + n, [](const Track& a, const Track& b) { return a.pid < b.pid; });
+    }
+    for (size_t i = n; i < nextTrack_.size(); ++i) CloseFd(nextTrack_[i].statFd);
+    procs.resize(n);
+    nextTrack_.resize(n);
+    track_.swap(nextTrack_);
+    return true;
+}
+
+#endif
@@ -0,0 +1,153 @@
+#include <vector>
+#include <mutex>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <pwd.h>
+#endif
+
+#include "include/ProcessAttrCache.h"
+
+#ifdef _WIN32
+
+// Account names behind SIDs; LookupAccountSidW may ask a domain controller.
+static std::wstring UserFromToken(HANDLE hProcess) {
+    static std::mutex mu;
+    static std::unordered_map<std::string, std::wstring> names;
+
+    HANDLE hToken = NULL;
+    if (!OpenProcessToken(hProcess, TOKEN_QUERY, &hToken)) return L"";
+    BYTE buf[256];
+    DWORD len = 0;
+    BOOL ok = GetTokenInformation(hToken, TokenUser, buf, sizeof(buf), &len);
+    CloseHandle(hToken);
+    if (!ok) return L"";
+    PSID sid = ((TOKEN_USER*)buf)->User.Sid;
+    std::string key((const char*)sid, GetLengthSid(sid));
+
+    std::lock_guard<std::mutex> lock(mu);
+    auto it = names.find(key);
+    if (it != names.end()) return it->second;
+    WCHAR name[256], domain[256];
+    DWORD nameLen = 256, domainLen = 256;
+    SID_NAME_USE use;
+    std::wstring user;
+    if (LookupAccountSidW(NULL, sid, name, &nameLen, domain, &domainLen, &use))
+        user = domainLen ? std::wstring(domain) + L"\\" + name : std::wstring(name);
+    names.emplace(std::move(key), user);
+    return user;
+}
+
+static std::wstring CommandLineOf(HANDLE hProcess) {
+    static NTQUERYINFORMATIONPROCESS NtQueryInformationProcess =
+        (NTQUERYINFORMATIONPROCESS)GetProcAddress(GetModuleHandle(L"ntdll.dll"), "NtQueryInformationProcess");
+    if (!NtQueryInformationProcess) return L"";
+    std::vector<BYTE> buf(4096);
+    ULONG len = 0;
+    NTSTATUS status = NtQueryInformationProcess(hProcess, ProcessCommandLineInformation, buf.data(), (ULONG)buf.size(), &len);
+    if (status == STATUS_INFO_LENGTH_MISMATCH && len > buf.size()) {
+        buf.resize(len);
+        status = NtQueryInformationProcess(hProcess, ProcessCommandLineInformation, buf.data(), (ULONG)buf.size(), &len);
+    }
+    if (status != 0) return L"";
+    const UNICODE_STRING* s = (const UNICODE_STRING*)buf.data();
+    return s->Buffer ? std::wstring(s->Buffer, s->Length / sizeof(WCHAR)) : L"";
+}
+
+void LoadProcessAttrs(ULONG pid, ProcessAttrs& out) {
+    out = ProcessAttrs();
+    if (pid == 0) return;
+    HANDLE hProcess = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pid);
+    if (!hProcess) return;
+    WCHAR path[MAX_PATH];
+    DWORD size = MAX_PATH;
+    if (QueryFullProcessImageNameW(hProcess, 0, path, &size)) out.imagePath.assign(path, size);
+    out.commandLine = CommandLineOf(hProcess);
+    out.userName = UserFromToken(hProcess);
+    CloseHandle(hProcess);
+}
+
+#else
+
+// <pid>/name under procFd, or /proc/<pid>/name for AT_FDCWD.
+static void ProcPath(char* path, size_t cap, int procFd, ULONG pid, const char* name) {
+    if (procFd == AT_FDCWD) snprintf(path, cap, "/proc/%u/%s", (unsigned)pid, name);
+    else snprintf(path, cap, "%u/%s", (unsigned)pid, name);
+}
+
+static ssize_t ReadProcFile(int procFd, ULONG pid, const char* name, char* buf, size_t cap) {
+    char path[64];
+    ProcPath(path, sizeof(path), procFd, pid, name);
+    int fd = openat(procFd, path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+    ssize_t n = pread(fd, buf, cap, 0);
+    close(fd);
+    return n;
+}
+
+// getpwuid_r may go through NSS (files, LDAP, ...) on every call.
+static std::wstring UserFromUid(uid_t uid) {
+    static std::mutex mu;
+    static std::unordered_map<uid_t, std::wstring> names;
+    std::lock_guard<std::mutex> lock(mu);
+    auto it = names.find(uid);
+    if (it != names.end()) return it->second;
+    struct passwd pw, *res = nullptr;
+    char buf[4096];
+    std::wstring user;
+    if (getpwuid_r(uid, &pw, buf, sizeof(buf), &res) == 0 && res) user = UTF8ToWString(res->pw_name);
+    else user = std::to_wstring((unsigned)uid);
+    names.emplace(uid, user);
+    return user;
+}
+
+void LoadProcessAttrs(ULONG pid, ProcessAttrs& out) {
+    LoadProcessAttrsAt(AT_FDCWD, pid, out);
+}
+
+void LoadProcessAttrsAt(int procFd, ULONG pid, ProcessAttrs& out) {
+    out = ProcessAttrs();
+    if (pid == 0) return;
+    char path[64], buf[8192];
+    ProcPath(path, sizeof(path), procFd, pid, "exe");
+    ssize_t n = readlinkat(procFd, path, buf, sizeof(buf));
+    if (n > 0 && n < (ssize_t)sizeof(buf)) out.imagePath = UTF8ToWString(std::string(buf, (size_t)n));
+
+    // arguments are NUL separated; shown space separated
+    n = ReadProcFile(procFd, pid, "cmdline", buf, sizeof(buf));
+    if (n > 0) {
+        while (n > 0 && buf[n - 1] == 0) --n;
+        for (ssize_t i = 0; i < n; ++i) if (buf[i] == 0) buf[i] = ' ';
+        out.commandLine = UTF8ToWString(std::string(buf, (size_t)n));
+    }
+
+    n = ReadProcFile(procFd, pid, "status", buf, sizeof(buf) - 1);
+    if (n > 0) {
+        buf[n] = 0;
+        const char* uid = strstr(buf, "\nUid:");
+        if (uid) out.userName = UserFromUid((uid_t)strtoul(uid + 5, nullptr, 10));
+    }
+}
+
+#endif
+
+const ProcessAttrs& ProcessAttrCache::Get(ULONG pid, int64_t createTime) {
+    Entry& e = entries_[pid];
+    if (e.seen == 0 || e.createTime != createTime) {
+        e.createTime = createTime;
+        LoadProcessAttrs(pid, e.attrs);
+        ++loads_;
+    }
+    e.seen = poll_;
+    return e.attrs;
+}
+
+void ProcessAttrCache::EndPoll() {
+    for (auto it = entries_.begin(); it != entries_.end(); ) {
+        if (it->second.seen != poll_) it = entries_.erase(it);
+        else ++it;
+    }
+}
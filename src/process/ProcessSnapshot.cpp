@@ -0,0 +1,125 @@
+#include "include/ProcessSnapshot.h"
+#include "include/utils.h"
+
+std::string LowerAscii(const std::string& s) {
+    std::string out = s;
+    for (char& c : out) if (c >= 'A' && c <= 'Z') c = (char)(c - 'A' + 'a');
+    return out;
+}
+
+void StringArena::Clear() {
+    entries_.clear();
+    wide_.clear();
+    utf8_.clear();
+    entries_.push_back(Entry{ 0, 0, 0 });
+    wide_.push_back(0);
+    utf8_.push_back(0);
+}
+
+uint32_t StringArena::Add(const std::wstring& wide, const std::string& utf8, const std::string& lower) {
+    Entry e;
+    e.wide = (uint32_t)wide_.size();
+    wide_.insert(wide_.end(), wide.begin(), wide.end());
+    wide_.push_back(0);
+    e.utf8 = (uint32_t)utf8_.size();
+    utf8_.insert(utf8_.end(), utf8.begin(), utf8.end());
+    utf8_.push_back(0);
+    e.lower = (uint32_t)utf8_.size();
+    utf8_.insert(utf8_.end(), lower.begin(), lower.end());
+    utf8_.push_back(0);
+    entries_.push_back(e);
+    return (uint32_t)entries_.size() - 1;
+}
+
+void StringInterner::BeginPoll(StringArena& arena) {
+    ++poll_;
+    arena_ = &arena;
+    arena_->Clear();
+}
+
+uint32_t StringInterner::Intern(const std::wstring& s) {
+    if (s.empty()) return 0;
+    auto it = entries_.find(s);
+    if (it == entries_.end()) {
+        it = entries_.emplace(s, Entry()).first;
+        it->second.utf8 = WStringToUTF8(s);
+        it->second.lower = LowerAscii(it->second.utf8);
+    }
+    Entry& e = it->second;
+    if (e.seen != poll_) {
+        e.seen = poll_;
+        e.id = arena_->Add(s, e.utf8, e.lower);
+    }
+    return e.id;
+}
+
+void StringInterner::EndPoll() {
+    for (auto it = entries_.begin(); it != entries_.end(); ) {
+        if (it->second.seen != poll_) it = entries_.erase(it);
+        else ++it;
+    }
+    arena_ = nullptr;
+}
+
+static inline uint32_t HashPid(ULONG pid, unsigned shift) {
+    return (uint32_t)((uint32_t)pid * 2654435761u) >> shift;
+}
+
+uint32_t ProcessSnapshot::Find(ULONG value) const {
+    if (index_.empty()) return kNoRow;
+    const uint32_t mask = (uint32_t)index_.size() - 1;
+    for (uint32_t slot = HashPid(value, indexShift_); ; slot = (slot + 1) & mask) {
+        const uint32_t row = index_[slot];
+        if (row == 0) return kNoRow;
+        if (pid[row - 1] == value) return row - 1;
+    }
+}
+
+void ProcessSnapshot::BuildIndex() {
+    // at most half full, so probes stay short and always reach an empty slot
+    unsigned bits = 4;
+    while (((size_t)1 << bits) < pid.size() * 2) ++bits;
+    indexShift_ = 32 - bits;
+    index_.assign((size_t)1 << bits, 0);
+    const uint32_t mask = (uint32_t)index_.size() - 1;
+    for (uint32_t row = 0; row < (uint32_t)pid.size(); ++row) {
+        uint32_t slot = HashPid(pid[row], indexShift_);
+        while (index_[slot] != 0) slot = (slot + 1) & mask;
+        index_[slot] = row + 1;
+    }
+}
+
+void ProcessSnapshot::Assign(const std::vector<ProcessInfo>& rows, StringInterner& interner) {
+    const size_t n = rows.size();
+    pid.resize(n); threads.resize(n); handles.resize(n); sessionId.resize(n);
+    basePriority.resize(n);
+    workingSet.resize(n); virtualSize.resize(n); privatePages.resize(n);
+    createTime.resize(n); userTime.resize(n); kernelTime.resize(n);
+    readBytes.resize(n); writeBytes.resize(n); otherBytes.resize(n);
+    name.resize(n); imagePath.resize(n); commandLine.resize(n); userName.resize(n);
+
+    interner.BeginPoll(strings);
+    for (size_t i = 0; i < n; ++i) {
+        const ProcessInfo& p = rows[i];
+        pid[i] = p.pid;
+        threads[i] = p.threads;
+        handles[i] = p.handles;
+        sessionId[i] = p.sessionId;
+        basePriority[i] = p.basePriority;
+        workingSet[i] = p.workingSet;
+        virtualSize[i] = p.virtualSize;
+        privatePages[i] = p.privatePages;
+        createTime[i] = p.createTime.QuadPart;
+        userTime[i] = p.userTime.QuadPart;
+        kernelTime[i] = p.kernelTime.QuadPart;
+        readBytes[i] = p.readTransferCount.QuadPart;
+        writeBytes[i] = p.writeTransferCount.QuadPart;
+        otherBytes[i] = p.otherTransferCount.QuadPart;
+        name[i] = interner.Intern(p.name);
+        imagePath[i] = interner.Intern(p.imagePath);
+        commandLine[i] = interner.Intern(p.commandLine);
+        userName[i] = interner.Intern(p.userName);
+    }
+    interner.EndPoll();
+    BuildIndex();
+}
@@ -1,5 +1,9 @@
+#include <cstdint>
+
 #include "include/utils.h"
 
+#ifdef _WIN32
+
 std::string WStringToString(const std::wstring& wstr) {
     if (wstr.empty()) return std::string();
     int size_needed = WideCharToMultiByte(CP_UTF8, 0, &wstr[0], (int)wstr.size(), NULL, 0, NULL, NULL);
@@ -91,3 +95,41 @@ BOOL OpenDllFileDialogW(std::wstring& filePath) {
     }
     return false;
 }
+
+#else
+
+// wchar_t is UTF-32 here.
+std::string WStringToUTF8(const std::wstring& wstr) {
+    std::string out;
+    out.reserve(wstr.size());
+    for (wchar_t wc : wstr) {
+        uint32_t c = (uint32_t)wc;
+        if (c < 0x80) out.push_back((char)c);
+        else if (c < 0x800) { out.push_back((char)(0xC0 | (c >> 6))); out.push_back((char)(0x80 | (c & 0x3F))); }
+        else if (c < 0x10000) { out.push_back((char)(0xE0 | (c >> 12))); out.push_back((char)(0x80 | ((c >> 6) & 0x3F))); out.push_back((char)(0x80 | (c & 0x3F))); }
+        else { out.push_back((char)(0xF0 | (c >> 18))); out.push_back((char)(0x80 | ((c >> 12) & 0x3F))); out.push_back((char)(0x80 | ((c >> 6) & 0x3F))); out.push_back((char)(0x80 | (c & 0x3F))); }
+    }
+    return out;
+}
+
+std::string WStringToString(const std::wstring& wstr) {
+    return WStringToUTF8(wstr);
+}
+
+std::wstring UTF8ToWString(const std::string& str) {
+    std::wstring out;
+    out.reserve(str.size());
+    for (size_t i = 0; i < str.size(); ) {
+        unsigned char c = (unsigned char)str[i];
+        uint32_t cp = c;
+        size_t len = 1;
+        if (c >= 0xF0 && i + 3 < str.size()) { cp = ((c & 0x07u) << 18) | ((str[i + 1] & 0x3Fu) << 12) | ((str[i + 2] & 0x3Fu) << 6) | (str[i + 3] & 0x3Fu); len = 4; }
+        else if (c >= 0xE0 && i + 2 < str.size()) { cp = ((c & 0x0Fu) << 12) | ((str[i + 1] & 0x3Fu) << 6) | (str[i + 2] & 0x3Fu); len = 3; }
+        else if (c >= 0xC0 && i + 1 < str.size()) { cp = ((c & 0x1Fu) << 6) | (str[i + 1] & 0x3Fu); len = 2; }
+        out.push_back((wchar_t)cp);
+        i += len;
+    }
+    return out;
+}
+
+#endif